@@ -8,9 +8,14 @@
 #ifndef EMBED_AVG_FILTER_H
 #define EMBED_AVG_FILTER_H
 
+#include <stddef.h>
+
+#include <type_traits>
+
 namespace embed
 {
 
+// Type-erased interface, for choosing a filter at run time
 template <class T> class AvgFilter
 {
  public:
@@ -18,11 +23,59 @@ template <class T> class AvgFilter
 
     virtual void reset() = 0;
     virtual void addValue (T _val) = 0;
+    virtual void addValues (const T* _vals, size_t _num)
+    {
+        for (size_t i = 0; i < _num; i++)
+            addValue(_vals[i]);
+    }
     virtual double getAvg() = 0;
     virtual double getStdDev() = 0;
  private:
 };
 
+// Static interface for the header-only filters. A filter derives from
+// AvgFilterBase<Filter, T> and provides non-virtual reset(), addValue(T),
+// getAvg() and getStdDev(), so code templated on the filter type inlines
+// every call. Filters that can do better than one addValue per sample also
+// provide addValues(const T*, size_t).
+template <class Derived, class T> class AvgFilterBase
+{
+    static_assert (std::is_arithmetic<T>::value, "AvgFilter sample type must be arithmetic");
+ public:
+    typedef T ValueType;
+
+    void addValues (const T* _vals, size_t _num)
+    {
+        for (size_t i = 0; i < _num; i++)
+            derived().addValue(_vals[i]);
+    }
+
+    Derived& derived () {return static_cast<Derived&>(*this);}
+    const Derived& derived () const {return static_cast<const Derived&>(*this);}
+ protected:
+    AvgFilterBase () {}
+    ~AvgFilterBase () {}
+};
+
+// Wraps a static filter in the AvgFilter interface
+template <class Filter> class AvgFilterAdapter : public AvgFilter<typename Filter::ValueType>
+{
+ public:
+    typedef typename Filter::ValueType ValueType;
+
+    template <class... Args> AvgFilterAdapter (Args... _args) : m_filter (_args...) {}
+
+    void reset() final {m_filter.reset();}
+    void addValue (ValueType _val) final {m_filter.addValue(_val);}
+    void addValues (const ValueType* _vals, size_t _num) final {m_filter.addValues(_vals, _num);}
+    double getAvg() final {return m_filter.getAvg();}
+    double getStdDev() final {return m_filter.getStdDev();}
+
+    Filter& getFilter () {return m_filter;}
+ private:
+    Filter              m_filter;
+};
+
 }
 
 #endif
@@ -18,6 +18,7 @@
 
 #include "gpio.h"
 #include "bbb_int_thread.h"
+#include "trace.h"
 
 namespace embed
 {
@@ -14,10 +14,12 @@
 #include <errno.h>
 #include <sys/ioctl.h>
 #include <time.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <string.h>
 
 #include "i2c.h"
+#include "trace.h"
 
 namespace embed
 {
@@ -33,6 +35,7 @@ class BBBI2C : public I2C
 
     uint8_t readReg (const uint8_t _addr, const uint8_t _reg);
     void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val);
+    void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
 
  private:
     uint8_t         m_bus;
@@ -18,6 +18,8 @@
 #include <vector>
 #include <map>
 
+#include "trace.h"
+
 namespace embed
 {
 
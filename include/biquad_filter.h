@@ -0,0 +1,78 @@
+/*
+ * Filename: biquad_filter.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an IIR filter built from cascaded second
+ *              order sections (biquads)
+ */
+
+#ifndef EMBED_BIQUAD_FILTER_H
+#define EMBED_BIQUAD_FILTER_H
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "avg_filter.h"
+
+namespace embed
+{
+
+// Runs each sample through the sections in turn, each in transposed direct
+// form II. Blocks are processed a section at a time over the whole block,
+// which keeps a section's coefficients and state in registers; the
+// recursion is serial in time, so unlike the FIR filter there is no
+// vectorising within a stream. The state starts at the steady state for
+// the first sample, so a low-pass filter starts at that sample rather than
+// ringing up from zero. getAvg() returns the latest output, there is no
+// spread estimate so getStdDev() returns NaN.
+class BiquadFilter : public AvgFilter<double>
+{
+ public:
+    // y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+    typedef struct BiquadCoeffsStruct
+    {
+        double          m_b0;
+        double          m_b1;
+        double          m_b2;
+        double          m_a1;
+        double          m_a2;
+    } BiquadCoeffs;
+
+    BiquadFilter (const BiquadCoeffs* _sections, uint32_t _numSections);
+    ~BiquadFilter ();
+
+    // Second order low-pass with quality factor _q, _cutoff is a fraction of
+    // the sample rate
+    static BiquadCoeffs designLowPass (double _cutoff, double _q);
+
+    // Butterworth low-pass of even _order as _order / 2 sections
+    static void designButterworthLowPass (double _cutoff, uint32_t _order, BiquadCoeffs* _sections);
+
+    void reset ();
+    void addValue (double _val);
+    void addValues (const double* _vals, size_t _num);
+    double getAvg ();
+    double getStdDev ();
+
+    // Filters a block, _out may be the same as _in
+    void process (const double* _in, size_t _num, double* _out);
+
+    uint32_t getNumSections () const {return m_numSections;}
+ private:
+    void prime (double _val);
+
+    uint32_t                    m_numSections;
+    std::vector<BiquadCoeffs>   m_sections;
+
+    // Two state values per section
+    std::vector<double>         m_state;
+    bool                        m_primed;
+
+    double                      m_output;
+};
+
+}
+
+#endif
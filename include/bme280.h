@@ -0,0 +1,63 @@
+/*
+ * Filename: bme280.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for BME280 device class, a BMP280 with an
+ *              added humidity sensor
+ */
+
+#ifndef EMBED_BME280_H
+#define EMBED_BME280_H
+
+#include "bmp280.h"
+
+namespace embed
+{
+
+class BME280 : public BMP280
+{
+ public:
+    BME280 (I2C* _bus, const uint8_t _address = ADDRESS_PRIMARY, Timer* _timer = NULL,
+            Clock* _clock = NULL);
+    ~BME280 ();
+
+    // Set and get functions for humidity oversampling, applied at init
+    OVERSAMPLING getHumidityOversampling () {return m_humidityOsrs;}
+    void setHumidityOversampling (OVERSAMPLING _osrs) {m_humidityOsrs = _osrs;}
+
+    double getMeasurementTime ();
+
+    // Helper functions
+    void calcHumidity (const int32_t _rawTemp, const int32_t _rawHumidity, double* _humidityPct);
+ protected:
+    // Device registers
+    static const uint8_t CALIB_H1_REG       = 0xA1;
+    static const uint8_t CALIB_H2_REG       = 0xE1;
+    static const uint8_t CALIB_H2_LEN       = 7;
+
+    // Standby times differ from the BMP280 for the last two settings
+    static const double STANDBY_TIME_BME[STANDBY_NUM];
+
+    uint8_t getChipId () {return 0x60;}
+    uint8_t getDataLength () {return 8;}
+    double getStandbyTime (STANDBY _standby) {return STANDBY_TIME_BME[_standby];}
+    void readDeviceParams ();
+    void writeConfig (const uint8_t _mode);
+    int32_t parseHumidity (const uint8_t* _data);
+
+    uint32_t compensateHumidity (const int32_t _rawHumidity, const int32_t _tFine);
+
+    // Humidity device parameters read from NVM
+    uint8_t                         m_H1;
+    int16_t                         m_H2;
+    uint8_t                         m_H3;
+    int16_t                         m_H4;
+    int16_t                         m_H5;
+    int8_t                          m_H6;
+
+    OVERSAMPLING                    m_humidityOsrs;
+};
+
+}
+
+#endif
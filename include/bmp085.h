@@ -12,10 +12,20 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <math.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
 #include <map>
+#include <vector>
 
 #include "i2c.h"
 #include "gpio.h"
+#include "timer.h"
+#include "clock.h"
+#include "system_clock.h"
+#include "latency_histogram.h"
+#include "trace.h"
 
 namespace embed
 {
@@ -33,32 +43,124 @@ class BMP085
       OSSR_NUM
     } OSSR_SETTING;
 
+    // How the synchronous reads wait for a conversion to finish
+    typedef enum SYNC_WAIT_ENUM
+    {
+      SYNC_WAIT_SLEEP = 0,              // Sleep the datasheet conversion time
+      SYNC_WAIT_POLL,                   // Poll the EOC GPIO level
+      SYNC_WAIT_INTERRUPT,              // Block on the EOC GPIO rising edge
+      SYNC_WAIT_NUM
+    } SYNC_WAIT;
+
     // Interrupt callback
     typedef void (*EOCIntHandler) (const int16_t _temp, const int32_t _pressure, void* _data);
 
-    BMP085 (I2C* _bus, GPIO* _eoc = NULL, GPIO* _xclr = NULL);
+    // Timing statistics enum
+    typedef enum TIMING_STAT_ENUM
+    {
+      TIMING_TEMP_CONVERSION = 0,       // Conversion start to EOC handled
+      TIMING_PRESSURE_CONVERSION,       // Conversion start to EOC handled
+      TIMING_READOUT,                   // EOC handled to raw value read
+      TIMING_DISPATCH,                  // Raw value read to listeners returned
+      TIMING_SAMPLE_PERIOD,             // Between successive dispatches
+      TIMING_STAT_NUM
+    } TIMING_STAT;
+
+    // Calibration coefficients from the device EEPROM
+    typedef struct CalibrationStruct
+    {
+      int16_t m_AC1;
+      int16_t m_AC2;
+      int16_t m_AC3;
+      uint16_t m_AC4;
+      uint16_t m_AC5;
+      uint16_t m_AC6;
+      int16_t m_B1;
+      int16_t m_B2;
+      int16_t m_MB;
+      int16_t m_MC;
+      int16_t m_MD;
+    } Calibration;
+
+    // Timestamps (clock us) of the last complete sample
+    typedef struct SampleTimingStruct
+    {
+      uint64_t m_tempStartUs;
+      uint64_t m_tempEocUs;
+      uint64_t m_pressureStartUs;
+      uint64_t m_pressureEocUs;
+      uint64_t m_readoutUs;
+      uint64_t m_dispatchUs;
+    } SampleTiming;
+
+    // If a timer is given, async conversions that do not see their EOC
+    // edge in time are read anyway so the cycle never stalls. Waits and
+    // timestamps use _clock, or the system clock if none is given.
+    BMP085 (I2C* _bus, GPIO* _eoc = NULL, GPIO* _xclr = NULL, Timer* _timer = NULL,
+            Clock* _clock = NULL);
     ~BMP085 ();
 
-    // Initialize
+    // Initialize. destroy() waits for the stall timer, so it must not be
+    // called from a listener.
     bool init (bool _async);
     void destroy();
     void reset ();
 
     // Set and get functions for OSSR setting
+    // (a new setting takes effect at the start of the next pressure conversion)
     OSSR_SETTING getOSSR () {return m_ossr;}
     void setOSSR (OSSR_SETTING _ossr) {m_ossr = _ossr;}
 
+    // OSSR setting the most recently read raw pressure was converted with
+    OSSR_SETTING getSampleOSSR () {return m_sampleOssr;}
+
+    // Datasheet maximum conversion times in ms
+    static double getTempConversionTime () {return TEMP_CONVERSION_TIME;}
+    static double getConversionTime (OSSR_SETTING _ossr) {return OSSR_CONVERSION_TIME[_ossr];}
+
+    // Set and get functions for the synchronous wait mode, must be set
+    // before init. Defaults to polling EOC when it is wired, the datasheet
+    // conversion time is then only used as a timeout.
+    SYNC_WAIT getSyncWaitMode () {return m_syncWait;}
+    void setSyncWaitMode (SYNC_WAIT _syncWait);
+
+    // Number of synchronous waits that hit the datasheet timeout before EOC
+    uint32_t getSyncTimeouts () {return m_syncTimeouts;}
+
+    // Number of async conversions recovered after a missed EOC edge
+    uint32_t getStallsRecovered () {return m_stallsRecovered;}
+
     // Synchronous poll reads
     int16_t readRawTempSync ();
     int32_t readRawPressureSync ();
 
-    // Register for asynchronous reads
+    // Register for asynchronous reads. Listeners may register and
+    // unregister listeners, themselves included, while being called; an
+    // unregistered listener is not called again.
     void registerListener (EOCIntHandler _handler, void* _data);
     void unregisterListener (EOCIntHandler);
 
-    // Helper functions
+    // Conversion timing instrumentation, disabled by default
+    // (pressure conversion stats are per OSSR setting, OSSR_NUM merges them)
+    void setTimingEnabled (bool _enabled) {m_timingEnabled = _enabled;}
+    bool getTimingEnabled () {return m_timingEnabled;}
+    void resetTiming ();
+    void getTimingStats (TIMING_STAT _stat, LatencyHistogram::Summary* _summary,
+                         OSSR_SETTING _ossr = OSSR_NUM);
+    void getLastSampleTiming (SampleTiming* _timing);
+
+    // Calibration read from the device at init. Setting it lets a device
+    // that was never initialized compensate logged raw values.
+    void getCalibration (Calibration* _calibration);
+    void setCalibration (const Calibration& _calibration);
+
+    // Helper functions, the first compensates with the current OSSR
+    // setting, so a sample converted before a setOSSR() call needs the
+    // second with getSampleOSSR()
     void calcTempPressure (const int16_t _rawTemp, const int32_t _rawPressure,
                            double* _tempC, double* _pressurehPa);
+    void calcTempPressure (const int16_t _rawTemp, const int32_t _rawPressure,
+                           const OSSR_SETTING _ossr, double* _tempC, double* _pressurehPa);
     void calcApproxAlt (double _pressurehPa, double* _absAltM);
     void calcExactAlt (double _pressurehPa, double _seaLevelhPa, double* _absAltM);
     void calcSeaLevelPress (double _pressurehPa, double _absAltM, double* _seaLevelPress);
@@ -102,9 +204,20 @@ class BMP085
     static const uint8_t VALUE_LSB_REG  = 0xF7;
     static const uint8_t VALUE_XLSB_REG = 0xF8;
 
+    // Interval between EOC level reads in SYNC_WAIT_POLL
+    static const uint32_t EOC_POLL_INTERVAL_US = 100;
+
+    // Async conversion deadline is this factor times the datasheet
+    // conversion time, plus a margin for interrupt latency
+    static const double  STALL_TIMEOUT_FACTOR;
+    static const uint32_t STALL_TIMEOUT_MARGIN_US = 2000;
+
     // Pressure at sea level
     static const double PRESSURE_SEA_LEVEL_HPA;
 
+    // Temperature conversion time
+    static const double  TEMP_CONVERSION_TIME;
+
     // Array to convert oversampling setting to conversion time
     static const double  OSSR_CONVERSION_TIME[OSSR_NUM];
 
@@ -137,6 +250,11 @@ class BMP085
     // OSSR setting
     OSSR_SETTING                    m_ossr;
 
+    // OSSR setting of the pressure conversion in flight (async) and
+    // of the last raw pressure read
+    OSSR_SETTING                    m_convOssr;
+    OSSR_SETTING                    m_sampleOssr;
+
     // State for asynchronous state machine
     ASYNC_STATE                     m_state;
 
@@ -146,20 +264,58 @@ class BMP085
     // Saved temp value across interrupts for async
     int16_t                         m_rawTempAsync;
 
+    // Serializes the async state machine between the EOC handler and
+    // the stall timer
+    pthread_mutex_t                 m_stateMutex;
+
+    // Stall detection for the async state machine
+    Timer*                          m_timer;
+    Clock*                          m_clock;
+    uint64_t                        m_convStartUs;
+    uint64_t                        m_convTimeoutUs;
+    uint32_t                        m_stallsRecovered;
+
+    // Synchronous EOC wait state
+    SYNC_WAIT                       m_syncWait;
+    bool                            m_syncEoc;
+    pthread_mutex_t                 m_syncMutex;
+    pthread_cond_t                  m_syncCond;
+    uint32_t                        m_syncTimeouts;
+
     // GPIOs
     GPIO*                           m_eoc;
     GPIO*                           m_xclr;
 
-    // Async listeners
+    // Async listeners, those unregistered while dispatching are erased
+    // once the dispatch loop is done with its iterator
     std::map<EOCIntHandler,void*>   m_listeners;
+    bool                            m_dispatching;
+    std::vector<EOCIntHandler>      m_unregistered;
+
+    // Timing instrumentation
+    bool                            m_timingEnabled;
+    pthread_mutex_t                 m_timingMutex;
+    SampleTiming                    m_timing;
+    SampleTiming                    m_lastTiming;
+    LatencyHistogram                m_timingHist[TIMING_STAT_NUM];
+    LatencyHistogram                m_pressureConvHist[OSSR_NUM];
 
-    // Interrupt handler from GPIO
+    // Interrupt handlers from GPIO
     static void eocIntHandler (void* _data);
+    static void eocSyncIntHandler (void* _data);
+    static void stallTimerHandler (void* _data);
 
     // Private helper functions
+    void stepStateMachine ();
+    bool isUnregistered (EOCIntHandler _handler);
+    void startStallTimer (double _timeMs);
     void readDeviceParams();
+    void startConversionWait ();
+    bool waitConversion (double _timeMs, uint64_t* _eocUs);
     uint8_t readReg (const uint8_t _reg);
     void writeReg (const uint8_t _reg, const uint8_t _val);
+    void recordTiming (TIMING_STAT _stat, uint64_t _startUs, uint64_t _endUs);
+    uint64_t nowUs ();
 };
 
 }
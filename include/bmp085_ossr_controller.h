@@ -0,0 +1,84 @@
+/*
+ * Filename: bmp085_ossr_controller.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an adaptive oversampling controller for the
+ *              BMP085. It measures the pressure noise of the asynchronous
+ *              sample stream and picks the lowest OSSR setting that holds a
+ *              target noise floor while still meeting a minimum sample rate.
+ */
+
+#ifndef EMBED_BMP085_OSSR_CONTROLLER_H
+#define EMBED_BMP085_OSSR_CONTROLLER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bmp085.h"
+#include "simple_avg_filter.h"
+
+namespace embed
+{
+
+class BMP085OSSRController
+{
+ public:
+    // Switch event callback
+    typedef void (*OSSRSwitchHandler) (const BMP085::OSSR_SETTING _from, const BMP085::OSSR_SETTING _to,
+                                       const double _noisehPa, void* _data);
+
+    static const uint32_t DEFAULT_WINDOW_SIZE = 32;
+
+    BMP085OSSRController (BMP085* _device, double _targetNoisehPa, double _minRateHz,
+                          uint32_t _windowSize = DEFAULT_WINDOW_SIZE);
+    ~BMP085OSSRController ();
+
+    // Registers with the device, which must be initialized in async mode
+    bool init ();
+    void destroy ();
+
+    // Set and get functions for the control targets
+    double getTargetNoise () {return m_targetNoisehPa;}
+    void setTargetNoise (double _targetNoisehPa) {m_targetNoisehPa = _targetNoisehPa;}
+    double getMinRate () {return m_minRateHz;}
+    void setMinRate (double _minRateHz) {m_minRateHz = _minRateHz;}
+
+    // Called every time the controller switches OSSR setting
+    void setSwitchHandler (OSSRSwitchHandler _handler, void* _data);
+
+    // Pressure noise (std dev in hPa) measured over the last full window
+    double getNoise () {return m_noisehPa;}
+    uint32_t getNumSwitches () {return m_numSwitches;}
+
+    // Highest async sample rate achievable with an OSSR setting
+    static double getMaxRate (BMP085::OSSR_SETTING _ossr);
+ private:
+    // Datasheet RMS noise per OSSR setting, used to predict the noise
+    // at other settings from the noise measured at the current one
+    static const double NOISE_RMS_HPA[BMP085::OSSR_NUM];
+
+    // Fraction of the target a lower setting must be predicted to stay
+    // under before switching down, to keep from flapping
+    static const double SWITCH_DOWN_MARGIN;
+
+    static void eocIntHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+
+    void update (const int16_t _temp, const int32_t _pressure);
+    BMP085::OSSR_SETTING selectOSSR (BMP085::OSSR_SETTING _current, double _noisehPa);
+
+    bool                            m_initialized;
+    BMP085*                         m_device;
+    double                          m_targetNoisehPa;
+    double                          m_minRateHz;
+    uint32_t                        m_windowSize;
+    uint32_t                        m_windowCount;
+    BasicSimpleAvgFilter<double>    m_noiseFilter;
+    double                          m_noisehPa;
+    uint32_t                        m_numSwitches;
+    OSSRSwitchHandler               m_switchHandler;
+    void*                           m_switchData;
+};
+
+}
+
+#endif
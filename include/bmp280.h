@@ -0,0 +1,221 @@
+/*
+ * Filename: bmp280.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for BMP280 device class. Measurements are read
+ *              with a single burst read of the data registers, either on
+ *              demand in forced mode or continuously in normal mode where
+ *              registered listeners are called every measurement period.
+ */
+
+#ifndef EMBED_BMP280_H
+#define EMBED_BMP280_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <math.h>
+#include <pthread.h>
+#include <map>
+#include <vector>
+
+#include "i2c.h"
+#include "timer.h"
+#include "clock.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+class BMP280
+{
+ public:
+    // Oversampling setting enum
+    typedef enum OVERSAMPLING_ENUM
+    {
+      OVERSAMPLING_SKIP = 0,
+      OVERSAMPLING_X1,
+      OVERSAMPLING_X2,
+      OVERSAMPLING_X4,
+      OVERSAMPLING_X8,
+      OVERSAMPLING_X16,
+      OVERSAMPLING_NUM
+    } OVERSAMPLING;
+
+    // Normal mode standby time enum (BME280 uses 10 and 20ms for the last two)
+    typedef enum STANDBY_ENUM
+    {
+      STANDBY_0_5_MS = 0,
+      STANDBY_62_5_MS,
+      STANDBY_125_MS,
+      STANDBY_250_MS,
+      STANDBY_500_MS,
+      STANDBY_1000_MS,
+      STANDBY_2000_MS,
+      STANDBY_4000_MS,
+      STANDBY_NUM
+    } STANDBY;
+
+    // IIR filter coefficient enum
+    typedef enum FILTER_ENUM
+    {
+      FILTER_OFF = 0,
+      FILTER_X2,
+      FILTER_X4,
+      FILTER_X8,
+      FILTER_X16,
+      FILTER_NUM
+    } FILTER;
+
+    // Sample callback (humidity is 0 for devices without it)
+    typedef void (*SampleHandler) (const int32_t _temp, const int32_t _pressure,
+                                   const int32_t _humidity, void* _data);
+
+    static const uint8_t ADDRESS_PRIMARY    = 0x76;
+    static const uint8_t ADDRESS_SECONDARY  = 0x77;
+
+    // Async (normal mode) sampling needs a timer to pace the reads. Waits
+    // use _clock, or the system clock if none is given.
+    BMP280 (I2C* _bus, const uint8_t _address = ADDRESS_PRIMARY, Timer* _timer = NULL,
+            Clock* _clock = NULL);
+    virtual ~BMP280 ();
+
+    // Initialize, async selects continuous normal mode sampling
+    bool init (bool _async);
+    void destroy();
+    void reset ();
+
+    // Set and get functions for measurement settings, applied at init
+    OVERSAMPLING getTempOversampling () {return m_tempOsrs;}
+    void setTempOversampling (OVERSAMPLING _osrs) {m_tempOsrs = _osrs;}
+    OVERSAMPLING getPressureOversampling () {return m_pressureOsrs;}
+    void setPressureOversampling (OVERSAMPLING _osrs) {m_pressureOsrs = _osrs;}
+    STANDBY getStandby () {return m_standby;}
+    void setStandby (STANDBY _standby) {m_standby = _standby;}
+    FILTER getFilter () {return m_filter;}
+    void setFilter (FILTER _filter) {m_filter = _filter;}
+
+    // Datasheet maximum time of one measurement and normal mode period in ms
+    virtual double getMeasurementTime ();
+    double getSamplePeriod ();
+
+    // Synchronous forced mode read, one burst read of all data registers
+    bool readRawSync (int32_t* _temp, int32_t* _pressure, int32_t* _humidity = NULL);
+
+    // Register for asynchronous (normal mode) reads. Listeners may register
+    // and unregister listeners, themselves included, while being called;
+    // an unregistered listener is not called again.
+    void registerListener (SampleHandler _handler, void* _data);
+    void unregisterListener (SampleHandler _handler);
+
+    // Helper functions, the 64-bit pressure compensation is the most
+    // accurate, the 32-bit one is for targets without fast 64-bit math
+    void calcTempPressure (const int32_t _rawTemp, const int32_t _rawPressure,
+                           double* _tempC, double* _pressurehPa);
+    void calcTempPressure32 (const int32_t _rawTemp, const int32_t _rawPressure,
+                             double* _tempC, double* _pressurehPa);
+    void calcApproxAlt (double _pressurehPa, double* _absAltM);
+    void calcExactAlt (double _pressurehPa, double _seaLevelhPa, double* _absAltM);
+ protected:
+    // Device registers
+    static const uint8_t CALIB_REG          = 0x88;
+    static const uint8_t CALIB_LEN          = 24;
+    static const uint8_t ID_REG             = 0xD0;
+    static const uint8_t RESET_REG          = 0xE0;
+    static const uint8_t CTRL_HUM_REG       = 0xF2;
+    static const uint8_t STATUS_REG         = 0xF3;
+    static const uint8_t CTRL_MEAS_REG      = 0xF4;
+    static const uint8_t CONFIG_REG         = 0xF5;
+    static const uint8_t DATA_REG           = 0xF7;
+
+    static const uint8_t RESET_VALUE        = 0xB6;
+    static const uint8_t STATUS_MEASURING   = 0x08;
+    static const uint8_t MODE_SLEEP         = 0x00;
+    static const uint8_t MODE_FORCED        = 0x01;
+    static const uint8_t MODE_NORMAL        = 0x03;
+
+    static const uint8_t MAX_DATA_LEN       = 8;
+
+    // Interval between status reads while waiting for a forced measurement
+    static const uint32_t STATUS_POLL_INTERVAL_US = 250;
+
+    // Pressure at sea level
+    static const double PRESSURE_SEA_LEVEL_HPA;
+
+    // Array to convert standby setting to time in ms
+    static const double STANDBY_TIME[STANDBY_NUM];
+
+    // Array to convert oversampling setting to number of samples
+    static const uint8_t OVERSAMPLING_SAMPLES[OVERSAMPLING_NUM];
+
+    // Device specific hooks for the BME280
+    virtual uint8_t getChipId () {return 0x58;}
+    virtual uint8_t getDataLength () {return 6;}
+    virtual double getStandbyTime (STANDBY _standby) {return STANDBY_TIME[_standby];}
+    virtual void readDeviceParams ();
+    virtual void writeConfig (const uint8_t _mode);
+    virtual int32_t parseHumidity (const uint8_t* _data) {return 0;}
+
+    // Datasheet integer compensation, t_fine is returned through _tFine
+    int32_t compensateTemp (const int32_t _rawTemp, int32_t* _tFine);
+    uint32_t compensatePressure64 (const int32_t _rawPressure, const int32_t _tFine);
+    uint32_t compensatePressure32 (const int32_t _rawPressure, const int32_t _tFine);
+
+    uint8_t readReg (const uint8_t _reg);
+    void readRegs (const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
+    void writeReg (const uint8_t _reg, const uint8_t _val);
+
+    // Whether device parameters are initialized
+    bool                            m_initialized;
+
+    // Device parameters read from NVM
+    uint16_t                        m_T1;
+    int16_t                         m_T2;
+    int16_t                         m_T3;
+    uint16_t                        m_P1;
+    int16_t                         m_P2;
+    int16_t                         m_P3;
+    int16_t                         m_P4;
+    int16_t                         m_P5;
+    int16_t                         m_P6;
+    int16_t                         m_P7;
+    int16_t                         m_P8;
+    int16_t                         m_P9;
+
+    // I2C bus pointer and device address
+    I2C*                            m_bus;
+    uint8_t                         m_address;
+
+    // Measurement settings
+    OVERSAMPLING                    m_tempOsrs;
+    OVERSAMPLING                    m_pressureOsrs;
+    STANDBY                         m_standby;
+    FILTER                          m_filter;
+ private:
+    // Timer handler pacing normal mode reads
+    static void sampleTimerHandler (void* _data);
+
+    bool readData (int32_t* _temp, int32_t* _pressure, int32_t* _humidity);
+    bool isUnregistered (SampleHandler _handler);
+
+    // Whether we are in async mode
+    bool                            m_async;
+
+    // Timer for async reads
+    Timer*                          m_timer;
+
+    // Clock for waits
+    Clock*                          m_clock;
+
+    // Async listeners, locked since they are called from the timer thread.
+    // Those unregistered while dispatching are erased once the dispatch
+    // loop is done with its iterator.
+    std::map<SampleHandler,void*>   m_listeners;
+    pthread_mutex_t                 m_listenersMutex;
+    bool                            m_dispatching;
+    std::vector<SampleHandler>      m_unregistered;
+};
+
+}
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Filename: clock.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for clock and sleep generic interface class
+ */
+
+#ifndef EMBED_CLOCK_H
+#define EMBED_CLOCK_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+namespace embed
+{
+
+// Clock Interface Class
+class Clock
+{
+ public:
+    virtual ~Clock() {};
+
+    // Monotonic time in us
+    virtual uint64_t nowUs () = 0;
+
+    // Blocks the calling thread for _delayUs
+    virtual void sleepUs (uint64_t _delayUs) = 0;
+
+    // Waits on _cond, with _mutex held, until it is signalled or nowUs()
+    // reaches _deadlineUs. Returns false on timeout. Like any condition
+    // wait it can return early, callers must check their predicate. _cond
+    // must be initialized to use CLOCK_MONOTONIC.
+    virtual bool waitUntil (pthread_cond_t* _cond, pthread_mutex_t* _mutex, uint64_t _deadlineUs) = 0;
+ private:
+};
+
+}
+
+#endif
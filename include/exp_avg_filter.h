@@ -14,29 +14,162 @@
 #include <assert.h>
 #include <math.h>
 
-#include <list>
-
 #include "avg_filter.h"
+#include "reduce.h"
+#include "ring_buffer.h"
 
 namespace embed
 {
 
-template <class T> class ExpAvgFilter : public AvgFilter<T>
+// The standard deviation is exponentially weighted with the same alpha as
+// the average when no standard deviation interval is given, so the filter is
+// fixed size and O(1). With an interval it is computed over the last
+// _stdDevInterval samples about the current average, using a preallocated
+// window with running sums. N fixes the interval at compile time and keeps
+// the window inline.
+template <class T, uint32_t N = 0> class BasicExpAvgFilter : public AvgFilterBase<BasicExpAvgFilter<T, N>, T>
 {
  public:
-     ExpAvgFilter(double _alpha, uint32_t _stdDevInterval);
-     ~ExpAvgFilter ();
+    BasicExpAvgFilter (double _alpha, uint32_t _stdDevInterval = N) :
+        m_numSamples (_stdDevInterval),
+        m_samples (_stdDevInterval),
+        m_sampleCount (0),
+        m_alpha (_alpha),
+        m_sT (0.0),
+        m_variance (0.0),
+        m_shift (0.0),
+        m_sum (0.0),
+        m_sumSq (0.0)
+    {
+    }
+
+    void reset ()
+    {
+        m_samples.clear();
+        m_sampleCount = 0;
+        m_sT = 0.0;
+        m_variance = 0.0;
+        m_shift = 0.0;
+        m_sum = 0.0;
+        m_sumSq = 0.0;
+    }
+
+    void addValue (T _val)
+    {
+        double val = (double) _val;
+
+        if (m_sampleCount == 0)
+        {
+            m_sT = val;
+            m_shift = val;
+        }
+        else
+        {
+            double diff = val - m_sT;
+            double incr = m_alpha * diff;
+            m_sT += incr;
+            m_variance = (1.0 - m_alpha) * (m_variance + diff * incr);
+        }
+
+        if (m_numSamples == 0)
+        {
+            m_sampleCount = 1;
+            return;
+        }
+
+        double shifted = val - m_shift;
+        T evicted;
+        if (m_samples.push(_val, &evicted))
+        {
+            m_sampleCount++;
+        }
+        else
+        {
+            double old = ((double) evicted) - m_shift;
+            m_sum -= old;
+            m_sumSq -= old * old;
+        }
+        m_sum += shifted;
+        m_sumSq += shifted * shifted;
+
+        assert (m_sampleCount == m_samples.size());
+    }
+
+    void addValues (const T* _vals, size_t _num)
+    {
+        if (m_numSamples == 0 || _num < m_numSamples)
+        {
+            for (size_t i = 0; i < _num; i++)
+                addValue(_vals[i]);
+            return;
+        }
+
+        // The average is a recurrence and needs every sample
+        size_t i = 0;
+        if (m_sampleCount == 0)
+        {
+            m_sT = (double) _vals[0];
+            m_shift = m_sT;
+            i = 1;
+        }
+        for (; i < _num; i++)
+        {
+            double diff = ((double) _vals[i]) - m_sT;
+            double incr = m_alpha * diff;
+            m_sT += incr;
+            m_variance = (1.0 - m_alpha) * (m_variance + diff * incr);
+        }
+
+        // Only the last window survives, recompute its shifted sums
+        const T* window = _vals + (_num - m_numSamples);
+        m_samples.assign(window, m_numSamples);
+        m_sampleCount = m_numSamples;
+        m_sum = reduceSum(window, m_numSamples) - ((double) m_numSamples) * m_shift;
+        m_sumSq = reduceSumSqDiff(window, m_numSamples, m_shift);
+    }
 
-     void reset();
-     void addValue (T _val);
-     double getAvg ();
-     double getStdDev ();
+    double getAvg ()
+    {
+        return m_sT;
+    }
+
+    double getStdDev ()
+    {
+        if (m_sampleCount <= 0)
+            return nan("");
+
+        if (m_numSamples == 0)
+            return sqrt(m_variance);
+
+        // Sum of (x - avg)^2 expanded around the shift
+        double offset = m_sT - m_shift;
+        double sqDiffSum = m_sumSq - 2.0 * offset * m_sum + ((double) m_sampleCount) * offset * offset;
+        if (sqDiffSum < 0.0)
+            sqDiffSum = 0.0;
+
+        return sqrt(sqDiffSum / ((double) m_sampleCount));
+    }
  private:
     uint32_t            m_numSamples;
-    std::list<T>        m_samples;
+    RingBuffer<T, N>    m_samples;
     uint32_t            m_sampleCount;
     double              m_alpha;
     double              m_sT;
+    double              m_variance;
+
+    // Windowed sums of samples shifted by the first sample, which keeps the
+    // sum of squares from cancelling at large offsets
+    double              m_shift;
+    double              m_sum;
+    double              m_sumSq;
+};
+
+template <class T> class ExpAvgFilter : public AvgFilterAdapter<BasicExpAvgFilter<T> >
+{
+ public:
+     ExpAvgFilter(double _alpha) : AvgFilterAdapter<BasicExpAvgFilter<T> > (_alpha) {}
+     ExpAvgFilter(double _alpha, uint32_t _stdDevInterval) :
+         AvgFilterAdapter<BasicExpAvgFilter<T> > (_alpha, _stdDevInterval) {}
 };
 
 }
@@ -0,0 +1,255 @@
+/*
+ * Filename: filter_bank.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a bank of averaging filters over many
+ *              channels that are sampled together. Each per-channel quantity
+ *              is stored as its own array (structure of arrays) and the
+ *              sample windows are stored one row per timestamp, so an update
+ *              is a few branch-free passes over contiguous arrays that the
+ *              compiler vectorises (-O3, or -O2 -ftree-vectorize).
+ */
+
+#ifndef EMBED_FILTER_BANK_H
+#define EMBED_FILTER_BANK_H
+
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include <vector>
+#include <type_traits>
+
+namespace embed
+{
+
+template <class T> class FilterBank
+{
+    static_assert (std::is_arithmetic<T>::value, "FilterBank sample type must be arithmetic");
+ public:
+    typedef enum FILTER_TYPE_ENUM
+    {
+        SIMPLE_AVG = 0,
+        EXP_AVG,
+        FILTER_TYPE_NUM
+    } FILTER_TYPE;
+
+    // SIMPLE_AVG averages over windows of _numSamples. EXP_AVG uses _alpha
+    // and takes the standard deviation over the last _numSamples, or
+    // exponentially weighted when _numSamples is 0.
+    FilterBank (FILTER_TYPE _type, uint32_t _numChannels, uint32_t _numSamples, double _alpha = 0.0) :
+        m_type (_type),
+        m_numChannels (_numChannels),
+        m_numSamples (_numSamples),
+        m_alpha (_alpha),
+        m_numUnseeded (0),
+        m_head (0),
+        m_window (((size_t) _numChannels) * _numSamples),
+        m_count (_numChannels),
+        m_mean (_numChannels),
+        m_m2 (_numChannels),
+        m_shift (_numChannels),
+        m_sum (_numChannels),
+        m_sumSq (_numChannels)
+    {
+        assert (m_type != SIMPLE_AVG || m_numSamples > 0);
+        reset();
+    }
+
+    FILTER_TYPE getType () {return m_type;}
+    uint32_t getNumChannels () {return m_numChannels;}
+
+    void reset ()
+    {
+        m_numUnseeded = 0;
+        for (uint32_t i = 0; i < m_numChannels; i++)
+            resetChannel(i);
+        m_head = 0;
+    }
+
+    void resetChannel (uint32_t _channel)
+    {
+        assert (_channel < m_numChannels);
+
+        m_count[_channel] = 0.0;
+        m_mean[_channel] = 0.0;
+        m_m2[_channel] = 0.0;
+        m_shift[_channel] = 0.0;
+        m_sum[_channel] = 0.0;
+        m_sumSq[_channel] = 0.0;
+        m_numUnseeded++;
+    }
+
+    // Adds one value per channel, all taken at the same time
+    void addValues (const T* _vals)
+    {
+        if (m_type == SIMPLE_AVG)
+            updateSimple(_vals);
+        else
+            updateExp(_vals);
+
+        if (m_numSamples > 0)
+            m_head = (m_head + 1 == m_numSamples) ? 0 : m_head + 1;
+    }
+
+    double getAvg (uint32_t _channel)
+    {
+        assert (_channel < m_numChannels);
+
+        if (m_count[_channel] == 0.0)
+            return nan("");
+
+        return m_mean[_channel];
+    }
+
+    double getStdDev (uint32_t _channel)
+    {
+        assert (_channel < m_numChannels);
+
+        double count = m_count[_channel];
+        if (count == 0.0)
+            return nan("");
+
+        if (m_type == SIMPLE_AVG)
+            return sqrt(m_m2[_channel] / count);
+
+        if (m_numSamples == 0)
+            return sqrt(m_m2[_channel]);
+
+        // Sum of (x - avg)^2 expanded around the shift
+        double offset = m_mean[_channel] - m_shift[_channel];
+        double sqDiffSum = m_sumSq[_channel] - 2.0 * offset * m_sum[_channel] + count * offset * offset;
+
+        return sqrt((sqDiffSum > 0.0 ? sqDiffSum : 0.0) / count);
+    }
+ private:
+    // Welford add and replace in one form. A channel whose window is not
+    // full yet (after a resetChannel) "evicts" its own mean, which reduces
+    // to the plain add.
+    void updateSimple (const T* _vals)
+    {
+        T* __restrict__ row = &m_window[((size_t) m_head) * m_numChannels];
+        double* __restrict__ count = &m_count[0];
+        double* __restrict__ mean = &m_mean[0];
+        double* __restrict__ m2 = &m_m2[0];
+        const double numSamples = (double) m_numSamples;
+
+        for (uint32_t i = 0; i < m_numChannels; i++)
+        {
+            double val = (double) _vals[i];
+            double rowVal = (double) row[i];
+            double prevMean = mean[i];
+            double num = count[i] + 1.0;
+            bool full = num > numSamples;
+
+            double old = full ? rowVal : prevMean;
+            num = full ? numSamples : num;
+            double newMean = prevMean + (val - old) / num;
+            double newM2 = m2[i] + (val - old) * ((val - newMean) + (old - prevMean));
+
+            mean[i] = newMean;
+            m2[i] = newM2 > 0.0 ? newM2 : 0.0;
+            count[i] = num;
+            row[i] = _vals[i];
+        }
+
+        m_numUnseeded = 0;
+    }
+
+    // Exponential average with either the exponentially weighted variance
+    // (kept in m_m2) or windowed sums shifted by each channel's first sample.
+    // Channels that were reset are seeded with their first sample before the
+    // main pass, which then leaves them at that sample with zero variance.
+    void updateExp (const T* _vals)
+    {
+        if (m_numUnseeded > 0)
+            seedChannels(_vals);
+
+        double* __restrict__ mean = &m_mean[0];
+        double* __restrict__ var = &m_m2[0];
+        const double alpha = m_alpha;
+        const double beta = 1.0 - m_alpha;
+
+        for (uint32_t i = 0; i < m_numChannels; i++)
+        {
+            double diff = ((double) _vals[i]) - mean[i];
+            double incr = alpha * diff;
+            mean[i] += incr;
+            var[i] = beta * (var[i] + diff * incr);
+        }
+
+        double* __restrict__ count = &m_count[0];
+        if (m_numSamples == 0)
+        {
+            for (uint32_t i = 0; i < m_numChannels; i++)
+                count[i] = 1.0;
+            return;
+        }
+
+        T* __restrict__ row = &m_window[((size_t) m_head) * m_numChannels];
+        const double* __restrict__ shift = &m_shift[0];
+        double* __restrict__ sum = &m_sum[0];
+        double* __restrict__ sumSq = &m_sumSq[0];
+        const double numSamples = (double) m_numSamples;
+
+        for (uint32_t i = 0; i < m_numChannels; i++)
+        {
+            double sampleShift = shift[i];
+            double shifted = ((double) _vals[i]) - sampleShift;
+            double old = ((double) row[i]) - sampleShift;
+            sum[i] += shifted - old;
+            sumSq[i] += shifted * shifted - old * old;
+            row[i] = _vals[i];
+        }
+
+        // Kept out of the loop above, which GCC then fails to if-convert
+        for (uint32_t i = 0; i < m_numChannels; i++)
+        {
+            double num = count[i] + 1.0;
+            count[i] = num > numSamples ? numSamples : num;
+        }
+    }
+
+    // Starts reset channels at their first sample, and fills their window
+    // with it so the slots not yet written evict nothing from the sums
+    void seedChannels (const T* _vals)
+    {
+        for (uint32_t i = 0; i < m_numChannels; i++)
+        {
+            if (m_count[i] != 0.0)
+                continue;
+
+            m_mean[i] = (double) _vals[i];
+            m_shift[i] = (double) _vals[i];
+            for (uint32_t j = 0; j < m_numSamples; j++)
+                m_window[((size_t) j) * m_numChannels + i] = _vals[i];
+        }
+
+        m_numUnseeded = 0;
+    }
+
+    FILTER_TYPE                 m_type;
+    uint32_t                    m_numChannels;
+    uint32_t                    m_numSamples;
+    double                      m_alpha;
+
+    // Channels reset since the last update
+    uint32_t                    m_numUnseeded;
+
+    // Sample windows, row m_head is overwritten by the next update
+    uint32_t                    m_head;
+    std::vector<T>              m_window;
+
+    // Per-channel state, counts are doubles so the update loops work on a
+    // single vector type
+    std::vector<double>         m_count;
+    std::vector<double>         m_mean;
+    std::vector<double>         m_m2;
+    std::vector<double>         m_shift;
+    std::vector<double>         m_sum;
+    std::vector<double>         m_sumSq;
+};
+
+}
+
+#endif
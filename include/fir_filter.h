@@ -0,0 +1,76 @@
+/*
+ * Filename: fir_filter.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a decimating FIR filter, for low-pass
+ *              filtering a sample stream and optionally reducing its rate
+ *              (e.g. 100Hz to 10Hz with anti-aliasing)
+ */
+
+#ifndef EMBED_FIR_FILTER_H
+#define EMBED_FIR_FILTER_H
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "avg_filter.h"
+
+namespace embed
+{
+
+// Keeps the last taps-many samples in a delay line stored twice end to end,
+// so the window for any output is contiguous and each output is a single
+// vectorised dot product. With a decimation factor M only every Mth output
+// is computed, which is the same work as a polyphase decomposition. The
+// delay line starts filled with the first sample, so a filter with unity DC
+// gain starts at that sample rather than ramping up from zero. getAvg()
+// returns the latest output, there is no spread estimate so getStdDev()
+// returns NaN.
+class FirFilter : public AvgFilter<double>
+{
+ public:
+    FirFilter (const double* _taps, uint32_t _numTaps, uint32_t _decimation = 1);
+    ~FirFilter ();
+
+    // Windowed-sinc low-pass taps with unity DC gain. _cutoff is a fraction
+    // of the sample rate (0.05 for 5Hz at 100Hz), _numTaps should be odd.
+    static void designLowPass (double _cutoff, uint32_t _numTaps, double* _taps);
+
+    void reset ();
+    void addValue (double _val);
+    void addValues (const double* _vals, size_t _num);
+    double getAvg ();
+    double getStdDev ();
+
+    // Filters a block, writing one output per _decimation inputs to _out,
+    // which must have room for _num / _decimation + 1 outputs. Returns the
+    // number of outputs written.
+    size_t process (const double* _in, size_t _num, double* _out);
+
+    uint32_t getNumTaps () const {return m_numTaps;}
+    uint32_t getDecimation () const {return m_decimation;}
+ private:
+    // Writes a sample to the delay line, returns true when an output is due
+    bool push (double _val);
+    double output () const;
+
+    uint32_t                m_numTaps;
+    uint32_t                m_decimation;
+
+    // Taps in reverse, so they line up with the delay line oldest first
+    std::vector<double>     m_taps;
+
+    // Delay line of 2 * m_numTaps, the current window starts at m_pos
+    std::vector<double>     m_delay;
+    uint32_t                m_pos;
+    uint32_t                m_phase;
+    bool                    m_primed;
+
+    double                  m_output;
+};
+
+}
+
+#endif
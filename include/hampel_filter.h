@@ -0,0 +1,94 @@
+/*
+ * Filename: hampel_filter.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a Hampel outlier filter
+ */
+
+#ifndef EMBED_HAMPEL_FILTER_H
+#define EMBED_HAMPEL_FILTER_H
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include "avg_filter.h"
+#include "median_filter.h"
+
+namespace embed
+{
+
+// Passes each sample through unless it is more than _numSigmas scaled
+// median absolute deviations from the median of the last _numSamples
+// samples, in which case the median replaces it. A NaN sample is always
+// replaced. getAvg() returns the latest output, getStdDev() the scaled MAD
+// of the window.
+template <class T> class BasicHampelFilter : public AvgFilterBase<BasicHampelFilter<T>, T>
+{
+ public:
+    BasicHampelFilter (uint32_t _numSamples, double _numSigmas = 3.0) :
+        m_window (_numSamples),
+        m_numSigmas (_numSigmas),
+        m_output (nan("")),
+        m_numOutliers (0)
+    {
+    }
+
+    void reset ()
+    {
+        m_window.reset();
+        m_output = nan("");
+        m_numOutliers = 0;
+    }
+
+    void addValue (T _val)
+    {
+        m_window.addValue(_val);
+
+        double median = m_window.getMedian();
+        double threshold = m_numSigmas * m_window.getStdDev();
+        double val = (double) _val;
+        if (val != val || fabs(val - median) > threshold)
+        {
+            m_output = median;
+            m_numOutliers++;
+        }
+        else
+        {
+            m_output = val;
+        }
+    }
+
+    double getAvg ()
+    {
+        return m_output;
+    }
+
+    double getStdDev ()
+    {
+        return m_window.getStdDev();
+    }
+
+    // Number of samples replaced since the last reset
+    uint32_t getNumOutliers () {return m_numOutliers;}
+ private:
+    BasicMedianFilter<T>            m_window;
+    double                          m_numSigmas;
+    double                          m_output;
+    uint32_t                        m_numOutliers;
+};
+
+template <class T> class HampelFilter : public AvgFilterAdapter<BasicHampelFilter<T> >
+{
+ public:
+     HampelFilter(uint32_t _numSamples, double _numSigmas = 3.0) :
+         AvgFilterAdapter<BasicHampelFilter<T> > (_numSamples, _numSigmas) {}
+
+     uint32_t getNumOutliers () {return this->getFilter().getNumOutliers();}
+};
+
+}
+
+#endif
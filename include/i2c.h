@@ -24,6 +24,15 @@ class I2C
 
     virtual uint8_t readReg(const uint8_t addr, const uint8_t _reg) = 0;
     virtual void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val) = 0;
+
+    // Burst read of _len consecutive registers starting at _reg. Buses that
+    // support auto-incrementing reads should override this with a single
+    // transaction, the default reads the registers one by one.
+    virtual void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+    {
+        for (uint32_t i = 0; i < _len; i++)
+            _buf[i] = readReg (_addr, _reg + i);
+    }
  private:
 };
 
@@ -0,0 +1,92 @@
+/*
+ * Filename: i2c_recorder.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an I2C bus wrapper that records every
+ *              transaction on the bus it wraps to a binary trace file
+ */
+
+#ifndef EMBED_I2C_RECORDER_H
+#define EMBED_I2C_RECORDER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <vector>
+#include <string>
+
+#include "i2c.h"
+#include "i2c_trace.h"
+#include "clock.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+// Stands in for _bus, passing every transaction through and appending it
+// to the trace at _path (see i2c_trace.h), timestamped with _clock or the
+// system clock. Records are encoded into a memory buffer and written out
+// when it fills, on flush() and on destroy(), so the only cost on the bus
+// path is the encoding. _bus is called without the recorder's lock held,
+// so a device raising an interrupt mid transaction can re-enter it from
+// the handler; writes are recorded before they go out and reads once their
+// value is back, keeping such nested reads after the write that caused
+// them. init() and destroy() also initialize and destroy _bus.
+class I2CRecorder : public I2C
+{
+ public:
+    I2CRecorder (I2C* _bus, const char* _path, Clock* _clock = NULL,
+                 const uint32_t _bufferSize = DEFAULT_BUFFER_SIZE);
+    ~I2CRecorder ();
+
+    bool init();
+    void destroy();
+
+    uint8_t readReg (const uint8_t _addr, const uint8_t _reg);
+    void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val);
+    void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
+
+    // Writes the buffered records to the trace
+    bool flush ();
+
+    uint32_t getNumTransactions () {return m_numTransactions;}
+
+    // Bytes written to the trace file so far
+    uint64_t getNumBytes () {return m_numBytes;}
+ private:
+    static const uint32_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    // Record type and delta, the caller holds the record lock. Returns
+    // true if it handed a full buffer over, which the caller then writes
+    // with writeSpare() once it has dropped the lock.
+    bool beginRecord (I2C_TRACE_RECORD _type, uint64_t _timeUs, uint32_t _maxSize);
+    void writeSpare ();
+    bool flushLocked ();
+    bool writeBuffer (const uint8_t* _buf, const uint32_t _len);
+
+    I2C*                    m_bus;
+    std::string             m_path;
+    Clock*                  m_clock;
+    int32_t                 m_fd;
+    std::vector<uint8_t>    m_buffer;
+    uint32_t                m_bufferLen;
+    // A full buffer waiting to be written
+    std::vector<uint8_t>    m_spare;
+    uint32_t                m_spareLen;
+    uint64_t                m_lastTimeUs;
+    uint32_t                m_numTransactions;
+    uint64_t                m_numBytes;
+    // Bus accesses come from both the interrupt and user threads. The
+    // write lock keeps buffers going to the file in order, it is taken
+    // after the record lock.
+    pthread_mutex_t         m_recordMutex;
+    pthread_mutex_t         m_writeMutex;
+};
+
+}
+
+#endif
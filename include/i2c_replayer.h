@@ -0,0 +1,104 @@
+/*
+ * Filename: i2c_replayer.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an I2C bus that replays a trace recorded
+ *              by I2CRecorder
+ */
+
+#ifndef EMBED_I2C_REPLAYER_H
+#define EMBED_I2C_REPLAYER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <vector>
+#include <string>
+
+#include "i2c.h"
+#include "i2c_trace.h"
+#include "clock.h"
+
+namespace embed
+{
+
+// Answers each transaction with the next one in the trace at _path, so a
+// driver run against it sees exactly the bytes the device returned in the
+// field. Each transaction is checked against the recorded one (address,
+// register, direction, length and written value). A mismatch means the
+// driver has diverged from the recording; it is counted and reported
+// once, and the recorded transaction is consumed anyway, reads returning
+// its values if it was a read and zeros otherwise. Past the end of the
+// trace reads return zeros.
+//
+// The whole trace is decoded at init, so transactions cost a vector
+// lookup. If _clock is given, each transaction first waits on it until
+// the time since the start of its session matches the recording, which on
+// a VirtualClock reproduces the recorded timing without waiting for it.
+class I2CReplayer : public I2C
+{
+ public:
+    I2CReplayer (const char* _path, Clock* _clock = NULL);
+    ~I2CReplayer ();
+
+    bool init();
+    void destroy();
+
+    uint8_t readReg (const uint8_t _addr, const uint8_t _reg);
+    void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val);
+    void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
+
+    // Starts the replay over from the first transaction
+    void rewind ();
+
+    // Whether every recorded transaction has been replayed
+    bool finished ();
+
+    uint32_t getNumTransactions () {return m_transactions.size();}
+    uint32_t getPosition () {return m_position;}
+    uint32_t getNumMismatches () {return m_numMismatches;}
+ private:
+    typedef struct TransactionStruct
+    {
+        uint64_t            m_timeUs;           // Since the start of the session
+        bool                m_sessionStart;
+        I2C_TRACE_RECORD    m_type;
+        uint8_t             m_addr;
+        uint8_t             m_reg;
+        uint32_t            m_len;
+        uint32_t            m_dataOffset;       // Into m_data
+    } Transaction;
+
+    bool parse (const uint8_t* _buf, const uint8_t* _end);
+
+    // Waits on the clock until the next transaction is due
+    void waitForNext ();
+
+    // Returns the next transaction, or NULL if it does not match or the
+    // trace is finished, the caller holds the lock
+    const Transaction* next (I2C_TRACE_RECORD _type, const uint8_t _addr, const uint8_t _reg,
+                             const uint32_t _len, const uint8_t* _writeVal, const char* _caller);
+
+    std::string                 m_path;
+    Clock*                      m_clock;
+    bool                        m_initialized;
+    std::vector<Transaction>    m_transactions;
+    std::vector<uint8_t>        m_data;
+    uint32_t                    m_position;
+    uint32_t                    m_numMismatches;
+    // Clock time the current session was re-based to, and the position of
+    // its first transaction
+    uint64_t                    m_sessionStartUs;
+    uint32_t                    m_sessionPosition;
+    // Bus accesses come from both the interrupt and user threads
+    pthread_mutex_t             m_replayMutex;
+};
+
+}
+
+#endif
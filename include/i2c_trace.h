@@ -0,0 +1,51 @@
+/*
+ * Filename: i2c_trace.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the binary I2C trace format written by
+ *              I2CRecorder and read by I2CReplayer.
+ *
+ *              A trace starts with the 4 byte magic "EI2C" and a version
+ *              byte, followed by records. Every record starts with a varint
+ *              holding the time since the previous record in us shifted
+ *              left by 2, with the record type in the low 2 bits:
+ *
+ *              SYNC        varint absolute clock time, starts a session
+ *                          (the delta is 0)
+ *              READ        address, register, value
+ *              WRITE       address, register, value
+ *              READ_BURST  address, first register, varint length, values
+ *
+ *              The accesses within a sample are a few tens of us apart, so
+ *              a single register access usually takes 4 or 5 bytes.
+ *              Sessions are appended, each starting with a SYNC record that
+ *              re-bases the deltas.
+ */
+
+#ifndef EMBED_I2C_TRACE_H
+#define EMBED_I2C_TRACE_H
+
+#include <stdint.h>
+
+#include "varint.h"
+
+namespace embed
+{
+
+static const uint8_t I2C_TRACE_MAGIC[4] = {'E', 'I', '2', 'C'};
+static const uint8_t I2C_TRACE_VERSION  = 1;
+static const uint32_t I2C_TRACE_HEADER_SIZE = 5;
+static const uint32_t I2C_TRACE_TYPE_BITS   = 2;
+
+typedef enum I2C_TRACE_RECORD_ENUM
+{
+    I2C_TRACE_SYNC = 0,
+    I2C_TRACE_READ,
+    I2C_TRACE_WRITE,
+    I2C_TRACE_READ_BURST,
+    I2C_TRACE_RECORD_NUM
+} I2C_TRACE_RECORD;
+
+}
+
+#endif
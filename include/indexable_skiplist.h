@@ -0,0 +1,208 @@
+/*
+ * Filename: indexable_skiplist.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an indexable skiplist, a sorted multiset with
+ *              O(log n) insert, remove and access by rank. Each link also
+ *              stores how many elements it skips, which is what makes the
+ *              rank lookup possible. All nodes come from a pool allocated at
+ *              construction, so the list never allocates after that.
+ */
+
+#ifndef EMBED_INDEXABLE_SKIPLIST_H
+#define EMBED_INDEXABLE_SKIPLIST_H
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <vector>
+
+namespace embed
+{
+
+template <class T> class IndexableSkipList
+{
+ public:
+    IndexableSkipList (uint32_t _capacity) :
+        m_capacity (_capacity),
+        m_numLevels (1),
+        m_size (0),
+        m_freeHead (NIL),
+        m_rand (0x9E3779B9)
+    {
+        // Enough levels for O(log n) with p = 1/2
+        while (m_numLevels < MAX_LEVELS && (1u << m_numLevels) <= m_capacity)
+            m_numLevels++;
+
+        m_values.resize(m_capacity + 1);
+        m_levels.resize(m_capacity + 1);
+        m_next.resize(((size_t) m_capacity + 1) * m_numLevels);
+        m_width.resize(((size_t) m_capacity + 1) * m_numLevels);
+
+        clear();
+    }
+
+    uint32_t capacity () const {return m_capacity;}
+    uint32_t size () const {return m_size;}
+    bool empty () const {return m_size == 0;}
+
+    void clear ()
+    {
+        // Node 0 is the head, it has every level and points past the end
+        m_levels[HEAD] = m_numLevels;
+        for (uint32_t l = 0; l < m_numLevels; l++)
+        {
+            next(HEAD, l) = NIL;
+            width(HEAD, l) = 1;
+        }
+
+        // Chain the rest into the free list
+        m_freeHead = NIL;
+        for (uint32_t i = m_capacity; i > 0; i--)
+        {
+            next(i, 0) = m_freeHead;
+            m_freeHead = i;
+        }
+
+        m_size = 0;
+    }
+
+    // Inserts a value after any equal values, returns false when full.
+    // Values that do not compare equal to themselves (NaN) have no place
+    // in the order and are rejected.
+    bool insert (const T& _val)
+    {
+        if (m_freeHead == NIL || isUnordered(_val))
+            return false;
+
+        uint32_t chain[MAX_LEVELS];
+        uint32_t chainPos[MAX_LEVELS];
+
+        uint32_t node = HEAD;
+        uint32_t pos = 0;
+        for (int32_t l = m_numLevels - 1; l >= 0; l--)
+        {
+            while (next(node, l) != NIL && !(_val < m_values[next(node, l)]))
+            {
+                pos += width(node, l);
+                node = next(node, l);
+            }
+            chain[l] = node;
+            chainPos[l] = pos;
+        }
+
+        uint32_t newNode = m_freeHead;
+        m_freeHead = next(newNode, 0);
+        m_values[newNode] = _val;
+        m_levels[newNode] = randomLevel();
+
+        for (uint32_t l = 0; l < m_levels[newNode]; l++)
+        {
+            uint32_t prev = chain[l];
+            uint32_t skipped = pos - chainPos[l];
+            next(newNode, l) = next(prev, l);
+            next(prev, l) = newNode;
+            width(newNode, l) = width(prev, l) - skipped;
+            width(prev, l) = skipped + 1;
+        }
+        for (uint32_t l = m_levels[newNode]; l < m_numLevels; l++)
+            width(chain[l], l)++;
+
+        m_size++;
+        return true;
+    }
+
+    // Removes one element equal to _val, returns false if there is none
+    // (a NaN compares neither less nor greater, so it would otherwise
+    // match the smallest element)
+    bool remove (const T& _val)
+    {
+        if (isUnordered(_val))
+            return false;
+
+        uint32_t chain[MAX_LEVELS];
+
+        uint32_t node = HEAD;
+        for (int32_t l = m_numLevels - 1; l >= 0; l--)
+        {
+            while (next(node, l) != NIL && m_values[next(node, l)] < _val)
+                node = next(node, l);
+            chain[l] = node;
+        }
+
+        uint32_t target = next(chain[0], 0);
+        if (target == NIL || _val < m_values[target] || m_values[target] < _val)
+            return false;
+
+        for (uint32_t l = 0; l < m_levels[target]; l++)
+        {
+            uint32_t prev = chain[l];
+            width(prev, l) += width(target, l) - 1;
+            next(prev, l) = next(target, l);
+        }
+        for (uint32_t l = m_levels[target]; l < m_numLevels; l++)
+            width(chain[l], l)--;
+
+        next(target, 0) = m_freeHead;
+        m_freeHead = target;
+        m_size--;
+        return true;
+    }
+
+    // Value with _rank smaller values before it
+    const T& at (uint32_t _rank) const
+    {
+        assert (_rank < m_size);
+
+        uint32_t node = HEAD;
+        uint32_t remaining = _rank + 1;
+        for (int32_t l = m_numLevels - 1; l >= 0; l--)
+        {
+            while (next(node, l) != NIL && width(node, l) <= remaining)
+            {
+                remaining -= width(node, l);
+                node = next(node, l);
+            }
+        }
+
+        return m_values[node];
+    }
+ private:
+    static const uint32_t MAX_LEVELS    = 32;
+    static const uint32_t HEAD          = 0;
+    static const uint32_t NIL           = 0xFFFFFFFF;
+
+    uint32_t& next (uint32_t _node, uint32_t _level) {return m_next[((size_t) _node) * m_numLevels + _level];}
+    uint32_t next (uint32_t _node, uint32_t _level) const {return m_next[((size_t) _node) * m_numLevels + _level];}
+    uint32_t& width (uint32_t _node, uint32_t _level) {return m_width[((size_t) _node) * m_numLevels + _level];}
+    uint32_t width (uint32_t _node, uint32_t _level) const {return m_width[((size_t) _node) * m_numLevels + _level];}
+
+    static bool isUnordered (const T& _val) {return !(_val == _val);}
+
+    // Geometric level with p = 1/2 from a xorshift generator
+    uint32_t randomLevel ()
+    {
+        m_rand ^= m_rand << 13;
+        m_rand ^= m_rand >> 17;
+        m_rand ^= m_rand << 5;
+
+        uint32_t level = __builtin_ctz(m_rand | (1u << (m_numLevels - 1))) + 1;
+        return level;
+    }
+
+    uint32_t                    m_capacity;
+    uint32_t                    m_numLevels;
+    uint32_t                    m_size;
+    uint32_t                    m_freeHead;
+    uint32_t                    m_rand;
+
+    // Node pool, links for node n at level l are at n * m_numLevels + l
+    std::vector<T>              m_values;
+    std::vector<uint32_t>       m_levels;
+    std::vector<uint32_t>       m_next;
+    std::vector<uint32_t>       m_width;
+};
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Filename: kalman_filter.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a Kalman filter that tracks a measured value
+ *              and its rate of change, such as altitude and vertical speed
+ */
+
+#ifndef EMBED_KALMAN_FILTER_H
+#define EMBED_KALMAN_FILTER_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include "avg_filter.h"
+#include "matrix.h"
+
+namespace embed
+{
+
+// Motion models, the value is the number of states
+typedef enum KALMAN_MODEL_ENUM
+{
+    CONSTANT_VELOCITY = 2,
+    CONSTANT_ACCELERATION = 3
+} KALMAN_MODEL;
+
+// Tracks the value, its velocity and, for CONSTANT_ACCELERATION, its
+// acceleration from direct measurements of the value. The highest
+// derivative is modelled as white noise with standard deviation
+// _processNoise (acceleration for CONSTANT_VELOCITY, jerk for
+// CONSTANT_ACCELERATION) and the measurements as white noise with standard
+// deviation _measurementNoise. Unlike a moving average the estimate does not
+// lag a steady climb. getAvg() returns the value estimate and getStdDev()
+// its standard deviation. The matrices are sized at compile time, so the
+// filter never allocates and an update is a few dozen multiply-adds.
+template <class T, KALMAN_MODEL M = CONSTANT_VELOCITY> class BasicKalmanFilter :
+    public AvgFilterBase<BasicKalmanFilter<T, M>, T>
+{
+ public:
+    static const uint32_t NUM_STATES = (uint32_t) M;
+
+    typedef Matrix<double, NUM_STATES, NUM_STATES> StateMatrix;
+    typedef Matrix<double, NUM_STATES, 1> StateVector;
+
+    // _interval is the time between samples passed to addValue(T), in the
+    // units the velocity should be in (seconds for m/s)
+    BasicKalmanFilter (double _interval, double _measurementNoise, double _processNoise) :
+        m_measurementVar (_measurementNoise * _measurementNoise),
+        m_processVar (_processNoise * _processNoise),
+        m_numSamples (0)
+    {
+        setInterval(_interval);
+    }
+
+    void reset ()
+    {
+        m_numSamples = 0;
+    }
+
+    void addValue (T _val)
+    {
+        double val = (double) _val;
+
+        if (m_numSamples == 0)
+        {
+            // Start at the first measurement with the derivatives unknown
+            m_state = StateVector();
+            m_state(0, 0) = val;
+            m_covariance = StateMatrix::identity() * INITIAL_VARIANCE;
+            m_covariance(0, 0) = m_measurementVar;
+            m_numSamples = 1;
+            return;
+        }
+
+        predict();
+        update(val);
+        m_numSamples++;
+    }
+
+    // Adds a sample taken _interval after the previous one, for irregular
+    // sample rates
+    void addValue (T _val, double _interval)
+    {
+        if (_interval != m_interval)
+            setInterval(_interval);
+
+        addValue(_val);
+    }
+
+    double getAvg ()
+    {
+        if (m_numSamples == 0)
+            return nan("");
+
+        return m_state(0, 0);
+    }
+
+    double getStdDev ()
+    {
+        if (m_numSamples == 0)
+            return nan("");
+
+        return sqrt(m_covariance(0, 0));
+    }
+
+    double getVelocity ()
+    {
+        if (m_numSamples == 0)
+            return nan("");
+
+        return m_state(1, 0);
+    }
+
+    double getVelocityStdDev ()
+    {
+        if (m_numSamples == 0)
+            return nan("");
+
+        return sqrt(m_covariance(1, 1));
+    }
+
+    double getAcceleration ()
+    {
+        static_assert (M == CONSTANT_ACCELERATION, "Only the constant acceleration model tracks acceleration");
+
+        if (m_numSamples == 0)
+            return nan("");
+
+        return m_state(2, 0);
+    }
+
+    double getInterval () const {return m_interval;}
+ private:
+    // Variance of the derivatives before the first update
+    static constexpr double INITIAL_VARIANCE = 1e6;
+
+    // Builds the transition matrix, a Taylor expansion over the interval,
+    // and the process noise from the highest derivative changing by white
+    // noise over the interval
+    void setInterval (double _interval)
+    {
+        m_interval = _interval;
+
+        StateVector noiseGain;
+        double factor = 1.0;
+        for (uint32_t k = 0; k < NUM_STATES; k++)
+        {
+            if (k > 0)
+                factor *= _interval / k;
+
+            for (uint32_t i = 0; i + k < NUM_STATES; i++)
+                m_transition(i, i + k) = factor;
+            noiseGain(NUM_STATES - 1 - k, 0) = factor * _interval / (k + 1);
+        }
+
+        m_processNoise = noiseGain * noiseGain.transpose() * m_processVar;
+    }
+
+    void predict ()
+    {
+        m_state = m_transition * m_state;
+        m_covariance = m_transition * m_covariance * m_transition.transpose() + m_processNoise;
+    }
+
+    // Only the value is measured, so the innovation is a scalar and the
+    // gain is the first column of the covariance scaled
+    void update (double _val)
+    {
+        double innovation = _val - m_state(0, 0);
+        double innovationVar = m_covariance(0, 0) + m_measurementVar;
+
+        StateVector gain;
+        for (uint32_t i = 0; i < NUM_STATES; i++)
+            gain(i, 0) = m_covariance(i, 0) / innovationVar;
+
+        StateMatrix correction;
+        for (uint32_t i = 0; i < NUM_STATES; i++)
+        {
+            m_state(i, 0) += gain(i, 0) * innovation;
+            for (uint32_t j = 0; j < NUM_STATES; j++)
+                correction(i, j) = gain(i, 0) * m_covariance(0, j);
+        }
+        m_covariance -= correction;
+
+        // Keep the covariance symmetric as rounding accumulates
+        for (uint32_t i = 0; i < NUM_STATES; i++)
+        {
+            for (uint32_t j = i + 1; j < NUM_STATES; j++)
+            {
+                double avg = (m_covariance(i, j) + m_covariance(j, i)) / 2.0;
+                m_covariance(i, j) = avg;
+                m_covariance(j, i) = avg;
+            }
+        }
+    }
+
+    double              m_interval;
+    double              m_measurementVar;
+    double              m_processVar;
+    uint32_t            m_numSamples;
+
+    StateVector         m_state;
+    StateMatrix         m_covariance;
+    StateMatrix         m_transition;
+    StateMatrix         m_processNoise;
+};
+
+template <class T, KALMAN_MODEL M = CONSTANT_VELOCITY> class KalmanFilter :
+    public AvgFilterAdapter<BasicKalmanFilter<T, M> >
+{
+ public:
+     KalmanFilter(double _interval, double _measurementNoise, double _processNoise) :
+         AvgFilterAdapter<BasicKalmanFilter<T, M> > (_interval, _measurementNoise, _processNoise) {}
+
+     double getVelocity () {return this->getFilter().getVelocity();}
+     double getVelocityStdDev () {return this->getFilter().getVelocityStdDev();}
+};
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Filename: latency_histogram.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a fixed size log-linear histogram of
+ *              microsecond durations. Buckets double in width every 16
+ *              buckets, so percentiles are within ~6% of the true value
+ *              and adding a value is O(1) without allocation.
+ */
+
+#ifndef EMBED_LATENCY_HISTOGRAM_H
+#define EMBED_LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace embed
+{
+
+class LatencyHistogram
+{
+ public:
+    typedef struct SummaryStruct
+    {
+        uint32_t            m_count;
+        uint32_t            m_minUs;
+        uint32_t            m_p50Us;
+        uint32_t            m_p99Us;
+        uint32_t            m_maxUs;
+        double              m_meanUs;
+    } Summary;
+
+    LatencyHistogram ();
+    ~LatencyHistogram ();
+
+    void reset ();
+    void addValue (uint32_t _us);
+    void merge (const LatencyHistogram& _other);
+
+    uint32_t getCount () const {return m_count;}
+    uint32_t getMin () const {return m_count > 0 ? m_min : 0;}
+    uint32_t getMax () const {return m_max;}
+    double getMean () const;
+    uint32_t getPercentile (double _percentile) const;
+    void getSummary (Summary* _summary) const;
+ private:
+    static const uint32_t SUB_BUCKET_BITS = 4;
+    static const uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const uint32_t NUM_BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static uint32_t bucketIndex (uint32_t _us);
+    static uint32_t bucketUpperBound (uint32_t _index);
+
+    uint32_t            m_buckets[NUM_BUCKETS];
+    uint32_t            m_count;
+    uint32_t            m_min;
+    uint32_t            m_max;
+    uint64_t            m_sum;
+};
+
+}
+
+#endif
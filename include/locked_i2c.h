@@ -0,0 +1,48 @@
+/*
+ * Filename: locked_i2c.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an I2C bus wrapper that serializes access
+ *              from several threads
+ */
+
+#ifndef EMBED_LOCKED_I2C_H
+#define EMBED_LOCKED_I2C_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "i2c.h"
+
+namespace embed
+{
+
+// Stands in for _bus, holding a lock around each transaction so the
+// address selection, register write and read of one cannot interleave
+// with another thread's. lock() and unlock() hold the bus across several
+// transactions, for a sequence that must not be split, and nest with the
+// transactions' own locking. init() and destroy() also initialize and
+// destroy _bus.
+class LockedI2C : public I2C
+{
+ public:
+    LockedI2C (I2C* _bus);
+    ~LockedI2C ();
+
+    bool init();
+    void destroy();
+
+    uint8_t readReg (const uint8_t _addr, const uint8_t _reg);
+    void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val);
+    void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
+
+    void lock ();
+    void unlock ();
+ private:
+    I2C*                m_bus;
+    pthread_mutex_t     m_busMutex;
+};
+
+}
+
+#endif
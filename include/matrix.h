@@ -0,0 +1,112 @@
+/*
+ * Filename: matrix.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a small matrix whose dimensions are fixed at
+ *              compile time. Elements are stored inline in row-major order,
+ *              so matrices live on the stack or inside their owner and never
+ *              allocate, and the loops have constant trip counts the
+ *              compiler unrolls.
+ */
+
+#ifndef EMBED_MATRIX_H
+#define EMBED_MATRIX_H
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <type_traits>
+
+namespace embed
+{
+
+template <class T, uint32_t R, uint32_t C> class Matrix
+{
+    static_assert (std::is_floating_point<T>::value, "Matrix element type must be floating point");
+ public:
+    // Zero filled
+    Matrix ()
+    {
+        fill(0);
+    }
+
+    static Matrix zero () {return Matrix();}
+
+    static Matrix identity ()
+    {
+        static_assert (R == C, "Identity matrix must be square");
+
+        Matrix result;
+        for (uint32_t i = 0; i < R; i++)
+            result(i, i) = 1;
+        return result;
+    }
+
+    uint32_t rows () const {return R;}
+    uint32_t cols () const {return C;}
+
+    void fill (T _val)
+    {
+        for (uint32_t i = 0; i < R * C; i++)
+            m_data[i] = _val;
+    }
+
+    T& operator() (uint32_t _row, uint32_t _col) {assert (_row < R && _col < C); return m_data[_row * C + _col];}
+    const T& operator() (uint32_t _row, uint32_t _col) const {assert (_row < R && _col < C); return m_data[_row * C + _col];}
+
+    Matrix<T, C, R> transpose () const
+    {
+        Matrix<T, C, R> result;
+        for (uint32_t r = 0; r < R; r++)
+            for (uint32_t c = 0; c < C; c++)
+                result(c, r) = (*this)(r, c);
+        return result;
+    }
+
+    Matrix& operator+= (const Matrix& _other)
+    {
+        for (uint32_t i = 0; i < R * C; i++)
+            m_data[i] += _other.m_data[i];
+        return *this;
+    }
+
+    Matrix& operator-= (const Matrix& _other)
+    {
+        for (uint32_t i = 0; i < R * C; i++)
+            m_data[i] -= _other.m_data[i];
+        return *this;
+    }
+
+    Matrix& operator*= (T _scale)
+    {
+        for (uint32_t i = 0; i < R * C; i++)
+            m_data[i] *= _scale;
+        return *this;
+    }
+
+    Matrix operator+ (const Matrix& _other) const {Matrix result(*this); result += _other; return result;}
+    Matrix operator- (const Matrix& _other) const {Matrix result(*this); result -= _other; return result;}
+    Matrix operator* (T _scale) const {Matrix result(*this); result *= _scale; return result;}
+
+    template <uint32_t K> Matrix<T, R, K> operator* (const Matrix<T, C, K>& _other) const
+    {
+        Matrix<T, R, K> result;
+        for (uint32_t r = 0; r < R; r++)
+        {
+            for (uint32_t k = 0; k < K; k++)
+            {
+                T sum = 0;
+                for (uint32_t c = 0; c < C; c++)
+                    sum += (*this)(r, c) * _other(c, k);
+                result(r, k) = sum;
+            }
+        }
+        return result;
+    }
+ private:
+    T                   m_data[R * C];
+};
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Filename: median_filter.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a sliding window median filter
+ */
+
+#ifndef EMBED_MEDIAN_FILTER_H
+#define EMBED_MEDIAN_FILTER_H
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include "avg_filter.h"
+#include "ring_buffer.h"
+#include "indexable_skiplist.h"
+
+namespace embed
+{
+
+// The window is kept in arrival order in a ring buffer and sorted in an
+// indexable skiplist, so adding a sample is O(log n) and the median is a
+// rank lookup. getAvg() returns the median and getStdDev() the median
+// absolute deviation scaled to match the standard deviation of normally
+// distributed samples, which spikes from glitch readings barely move. NaN
+// samples take their place in the window but are left out of both.
+template <class T> class BasicMedianFilter : public AvgFilterBase<BasicMedianFilter<T>, T>
+{
+ public:
+    // MAD to standard deviation for a normal distribution
+    static constexpr double MAD_SCALE = 1.4826;
+
+    BasicMedianFilter (uint32_t _numSamples) :
+        m_samples (_numSamples),
+        m_sorted (_numSamples)
+    {
+        assert (_numSamples > 0);
+    }
+
+    void reset ()
+    {
+        m_samples.clear();
+        m_sorted.clear();
+    }
+
+    void addValue (T _val)
+    {
+        // The skiplist rejects NaN, so one evicted or added is skipped
+        T evicted;
+        if (!m_samples.push(_val, &evicted))
+            m_sorted.remove(evicted);
+        m_sorted.insert(_val);
+    }
+
+    double getAvg ()
+    {
+        return getMedian();
+    }
+
+    double getStdDev ()
+    {
+        return MAD_SCALE * getMAD();
+    }
+
+    double getMedian ()
+    {
+        uint32_t num = m_sorted.size();
+        if (num == 0)
+            return nan("");
+
+        if (num % 2 == 1)
+            return (double) m_sorted.at(num / 2);
+
+        return (((double) m_sorted.at(num / 2 - 1)) + ((double) m_sorted.at(num / 2))) / 2.0;
+    }
+
+    // Median of the absolute deviations from the median. The deviations of
+    // the samples below and above the median are each sorted already, so
+    // this is a selection from two sorted sequences, O(log^2 n).
+    double getMAD ()
+    {
+        uint32_t num = m_sorted.size();
+        if (num == 0)
+            return nan("");
+
+        double median = getMedian();
+        uint32_t split = (num + 1) / 2;
+        if (num % 2 == 1)
+            return selectDeviation(median, split, num / 2);
+
+        return (selectDeviation(median, split, num / 2 - 1) + selectDeviation(median, split, num / 2)) / 2.0;
+    }
+ private:
+    // Deviations below the median, ascending, for ranks [0, _split)
+    double lowerDeviation (double _median, uint32_t _split, uint32_t _index)
+    {
+        return _median - ((double) m_sorted.at(_split - 1 - _index));
+    }
+
+    // Deviations above the median, ascending, for ranks [_split, n)
+    double upperDeviation (double _median, uint32_t _split, uint32_t _index)
+    {
+        return ((double) m_sorted.at(_split + _index)) - _median;
+    }
+
+    // _k-th smallest (from 0) of the lower and upper deviations combined
+    double selectDeviation (double _median, uint32_t _split, uint32_t _k)
+    {
+        uint32_t numLower = _split;
+        uint32_t numUpper = m_sorted.size() - _split;
+
+        // Binary search for how many of the k + 1 smallest are lower ones
+        uint32_t lo = (_k + 1 > numUpper) ? _k + 1 - numUpper : 0;
+        uint32_t hi = (_k + 1 < numLower) ? _k + 1 : numLower;
+        while (lo < hi)
+        {
+            uint32_t i = (lo + hi) / 2;
+            uint32_t j = _k + 1 - i;
+            if (j > 0 && lowerDeviation(_median, _split, i) < upperDeviation(_median, _split, j - 1))
+                lo = i + 1;
+            else
+                hi = i;
+        }
+
+        uint32_t i = lo;
+        uint32_t j = _k + 1 - i;
+        double result = -INFINITY;
+        if (i > 0)
+            result = lowerDeviation(_median, _split, i - 1);
+        if (j > 0)
+            result = fmax(result, upperDeviation(_median, _split, j - 1));
+
+        return result;
+    }
+
+    RingBuffer<T>                   m_samples;
+    IndexableSkipList<T>            m_sorted;
+};
+
+template <class T> class MedianFilter : public AvgFilterAdapter<BasicMedianFilter<T> >
+{
+ public:
+     MedianFilter(uint32_t _numSamples) : AvgFilterAdapter<BasicMedianFilter<T> > (_numSamples) {}
+};
+
+}
+
+#endif
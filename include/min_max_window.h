@@ -0,0 +1,131 @@
+/*
+ * Filename: min_max_window.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a sliding window minimum and maximum tracker
+ */
+
+#ifndef EMBED_MIN_MAX_WINDOW_H
+#define EMBED_MIN_MAX_WINDOW_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include <type_traits>
+
+#include "ring_buffer.h"
+
+namespace embed
+{
+
+// Minimum and maximum over the last _numSamples samples. Each extreme is
+// tracked with a monotonic deque of (sequence number, value) candidates: a
+// new sample drops every candidate it beats from the back, and candidates
+// that have left the window are dropped from the front. Every sample is
+// pushed and popped at most once per deque, so updates are amortised O(1),
+// and both deques live in ring buffers sized to the window, so nothing is
+// allocated after construction. N fixes the window size at compile time.
+template <class T, uint32_t N = 0> class MinMaxWindow
+{
+    static_assert (std::is_arithmetic<T>::value, "MinMaxWindow sample type must be arithmetic");
+ public:
+    MinMaxWindow (uint32_t _numSamples = N) :
+        m_numSamples (_numSamples),
+        m_seq (0),
+        m_numSeen (0),
+        m_minCandidates (_numSamples),
+        m_maxCandidates (_numSamples)
+    {
+        assert (m_numSamples > 0);
+    }
+
+    void reset ()
+    {
+        m_seq = 0;
+        m_numSeen = 0;
+        m_minCandidates.clear();
+        m_maxCandidates.clear();
+    }
+
+    void addValue (T _val)
+    {
+        // Sequence numbers wrap, only their differences are used
+        uint32_t seq = m_seq++;
+        if (m_numSeen < m_numSamples)
+            m_numSeen++;
+
+        expire(m_minCandidates, seq);
+        while (!m_minCandidates.empty() && !(m_minCandidates.back().m_val < _val))
+            m_minCandidates.popBack();
+        m_minCandidates.push(Candidate(seq, _val));
+
+        expire(m_maxCandidates, seq);
+        while (!m_maxCandidates.empty() && !(_val < m_maxCandidates.back().m_val))
+            m_maxCandidates.popBack();
+        m_maxCandidates.push(Candidate(seq, _val));
+    }
+
+    void addValues (const T* _vals, size_t _num)
+    {
+        for (size_t i = 0; i < _num; i++)
+            addValue(_vals[i]);
+    }
+
+    // Number of samples in the window
+    uint32_t size () const {return m_numSeen;}
+    bool empty () const {return m_numSeen == 0;}
+
+    double getMin () const
+    {
+        if (m_minCandidates.empty())
+            return nan("");
+
+        return (double) m_minCandidates.front().m_val;
+    }
+
+    double getMax () const
+    {
+        if (m_maxCandidates.empty())
+            return nan("");
+
+        return (double) m_maxCandidates.front().m_val;
+    }
+
+    // Peak to peak excursion over the window
+    double getRange () const
+    {
+        return getMax() - getMin();
+    }
+ private:
+    struct Candidate
+    {
+        Candidate () : m_seq (0), m_val () {}
+        Candidate (uint32_t _seq, T _val) : m_seq (_seq), m_val (_val) {}
+
+        uint32_t    m_seq;
+        T           m_val;
+    };
+
+    // Drops candidates that the sample with sequence number _seq pushes
+    // out of the window
+    void expire (RingBuffer<Candidate, N>& _candidates, uint32_t _seq)
+    {
+        while (!_candidates.empty() && _seq - _candidates.front().m_seq >= m_numSamples)
+            _candidates.popFront();
+    }
+
+    uint32_t                    m_numSamples;
+    uint32_t                    m_seq;
+    uint32_t                    m_numSeen;
+
+    // Candidates in arrival order, values ascending for the minimum and
+    // descending for the maximum, so the front is the current extreme
+    RingBuffer<Candidate, N>    m_minCandidates;
+    RingBuffer<Candidate, N>    m_maxCandidates;
+};
+
+}
+
+#endif
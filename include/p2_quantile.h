@@ -0,0 +1,53 @@
+/*
+ * Filename: p2_quantile.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a P-squared (Jain and Chlamtac) streaming
+ *              quantile estimator. Five markers track the minimum, the
+ *              quantile, the maximum and the points halfway between, and
+ *              are nudged along a parabola as samples arrive, so one
+ *              quantile is estimated in constant memory and O(1) per sample.
+ *              Use one estimator per quantile of interest.
+ */
+
+#ifndef EMBED_P2_QUANTILE_H
+#define EMBED_P2_QUANTILE_H
+
+#include <stdint.h>
+
+namespace embed
+{
+
+class P2Quantile
+{
+ public:
+    // _quantile is a fraction, 0.5 for the median or 0.99 for p99
+    P2Quantile (double _quantile);
+    ~P2Quantile ();
+
+    void reset ();
+    void addValue (double _val);
+
+    double getQuantile () const;
+    double getTargetQuantile () const {return m_quantile;}
+    uint64_t getCount () const {return m_count;}
+ private:
+    static const uint32_t NUM_MARKERS = 5;
+
+    double parabolic (uint32_t _i, double _d) const;
+    double linear (uint32_t _i, int32_t _d) const;
+
+    double              m_quantile;
+    uint64_t            m_count;
+
+    // Marker heights, actual and desired positions, and how far the desired
+    // positions move per sample
+    double              m_heights[NUM_MARKERS];
+    double              m_positions[NUM_MARKERS];
+    double              m_desired[NUM_MARKERS];
+    double              m_increments[NUM_MARKERS];
+};
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Filename: reduce.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for vectorised reductions over sample arrays,
+ *              used by the filters when recomputing a window in bulk and by
+ *              the FIR filters for each output. The sums are accumulated in
+ *              independent double lanes with GCC vector extensions, which
+ *              the compiler maps to the target SIMD instructions (a plain
+ *              loop cannot be vectorised without -ffast-math because it
+ *              would reorder the additions).
+ */
+
+#ifndef EMBED_REDUCE_H
+#define EMBED_REDUCE_H
+
+#include <stddef.h>
+
+namespace embed
+{
+
+// Two double lanes is the width every SIMD target we build for has (SSE2,
+// NEON), two accumulators hide the add latency
+typedef double ReduceVec __attribute__ ((vector_size (2 * sizeof(double))));
+
+// Sum of the values
+template <class T> double reduceSum (const T* _vals, size_t _num)
+{
+    ReduceVec acc0 = {0.0, 0.0};
+    ReduceVec acc1 = {0.0, 0.0};
+
+    size_t numVec = _num - (_num % 4);
+    size_t i = 0;
+    for (; i < numVec; i += 4)
+    {
+        ReduceVec v0 = {(double) _vals[i], (double) _vals[i + 1]};
+        ReduceVec v1 = {(double) _vals[i + 2], (double) _vals[i + 3]};
+        acc0 += v0;
+        acc1 += v1;
+    }
+
+    acc0 += acc1;
+    double sum = acc0[0] + acc0[1];
+    for (; i < _num; i++)
+        sum += (double) _vals[i];
+
+    return sum;
+}
+
+// Sum of the squared differences from _center
+template <class T> double reduceSumSqDiff (const T* _vals, size_t _num, double _center)
+{
+    ReduceVec acc0 = {0.0, 0.0};
+    ReduceVec acc1 = {0.0, 0.0};
+    ReduceVec center = {_center, _center};
+
+    size_t numVec = _num - (_num % 4);
+    size_t i = 0;
+    for (; i < numVec; i += 4)
+    {
+        ReduceVec v0 = {(double) _vals[i], (double) _vals[i + 1]};
+        ReduceVec v1 = {(double) _vals[i + 2], (double) _vals[i + 3]};
+        v0 -= center;
+        v1 -= center;
+        acc0 += v0 * v0;
+        acc1 += v1 * v1;
+    }
+
+    acc0 += acc1;
+    double sum = acc0[0] + acc0[1];
+    for (; i < _num; i++)
+    {
+        double diff = ((double) _vals[i]) - _center;
+        sum += diff * diff;
+    }
+
+    return sum;
+}
+
+// Sum of the products of matching values, the inner loop of the FIR filters
+template <class T> double reduceDot (const T* _a, const T* _b, size_t _num)
+{
+    ReduceVec acc0 = {0.0, 0.0};
+    ReduceVec acc1 = {0.0, 0.0};
+
+    size_t numVec = _num - (_num % 4);
+    size_t i = 0;
+    for (; i < numVec; i += 4)
+    {
+        ReduceVec a0 = {(double) _a[i], (double) _a[i + 1]};
+        ReduceVec a1 = {(double) _a[i + 2], (double) _a[i + 3]};
+        ReduceVec b0 = {(double) _b[i], (double) _b[i + 1]};
+        ReduceVec b1 = {(double) _b[i + 2], (double) _b[i + 3]};
+        acc0 += a0 * b0;
+        acc1 += a1 * b1;
+    }
+
+    acc0 += acc1;
+    double sum = acc0[0] + acc0[1];
+    for (; i < _num; i++)
+        sum += ((double) _a[i]) * ((double) _b[i]);
+
+    return sum;
+}
+
+}
+
+#endif
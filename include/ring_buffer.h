@@ -0,0 +1,162 @@
+/*
+ * Filename: ring_buffer.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a fixed capacity ring buffer. Storage is
+ *              allocated once at construction (or held inline in a std::array
+ *              when the capacity N is given at compile time), so pushing and
+ *              popping never allocate. Pushing to a full buffer overwrites the
+ *              oldest value.
+ */
+
+#ifndef EMBED_RING_BUFFER_H
+#define EMBED_RING_BUFFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <array>
+
+namespace embed
+{
+
+// Storage for a capacity fixed at compile time
+template <class T, uint32_t N> class RingBufferStorage
+{
+ public:
+    RingBufferStorage (uint32_t _capacity) {assert (_capacity == N);}
+
+    uint32_t capacity () const {return N;}
+    T* data () {return m_data.data();}
+    const T* data () const {return m_data.data();}
+ private:
+    std::array<T, N>    m_data;
+};
+
+// Storage for a capacity given at run time
+template <class T> class RingBufferStorage<T, 0>
+{
+ public:
+    RingBufferStorage (uint32_t _capacity) :
+        m_capacity (_capacity),
+        m_data (new T[_capacity > 0 ? _capacity : 1])
+    {
+    }
+
+    ~RingBufferStorage ()
+    {
+        delete[] m_data;
+    }
+
+    uint32_t capacity () const {return m_capacity;}
+    T* data () {return m_data;}
+    const T* data () const {return m_data;}
+ private:
+    // Not copyable
+    RingBufferStorage (const RingBufferStorage&);
+    RingBufferStorage& operator= (const RingBufferStorage&);
+
+    uint32_t            m_capacity;
+    T*                  m_data;
+};
+
+template <class T, uint32_t N = 0> class RingBuffer
+{
+ public:
+    RingBuffer (uint32_t _capacity = N) :
+        m_storage (_capacity),
+        m_head (0),
+        m_size (0)
+    {
+    }
+
+    uint32_t capacity () const {return m_storage.capacity();}
+    uint32_t size () const {return m_size;}
+    bool empty () const {return m_size == 0;}
+    bool full () const {return m_size == capacity();}
+
+    void clear ()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // Appends a value, returns false and the overwritten oldest value in
+    // _evicted when the buffer was full
+    bool push (const T& _val, T* _evicted = NULL)
+    {
+        assert (capacity() > 0);
+
+        T* data = m_storage.data();
+        if (m_size < capacity())
+        {
+            data[wrap(m_head + m_size)] = _val;
+            m_size++;
+            return true;
+        }
+
+        if (_evicted != NULL)
+            (*_evicted) = data[m_head];
+        data[m_head] = _val;
+        m_head = wrap(m_head + 1);
+        return false;
+    }
+
+    // Replaces the contents with the last capacity() of _num values
+    void assign (const T* _vals, size_t _num)
+    {
+        if (_num > capacity())
+        {
+            _vals += _num - capacity();
+            _num = capacity();
+        }
+
+        T* data = m_storage.data();
+        for (size_t i = 0; i < _num; i++)
+            data[i] = _vals[i];
+        m_head = 0;
+        m_size = (uint32_t) _num;
+    }
+
+    // Removes and returns the oldest value
+    T popFront ()
+    {
+        assert (m_size > 0);
+
+        T val = m_storage.data()[m_head];
+        m_head = wrap(m_head + 1);
+        m_size--;
+        return val;
+    }
+
+    // Removes and returns the newest value
+    T popBack ()
+    {
+        assert (m_size > 0);
+
+        m_size--;
+        return m_storage.data()[wrap(m_head + m_size)];
+    }
+
+    // Oldest and newest values
+    const T& front () const {assert (m_size > 0); return m_storage.data()[m_head];}
+    const T& back () const {assert (m_size > 0); return m_storage.data()[wrap(m_head + m_size - 1)];}
+
+    // Index 0 is the oldest value
+    const T& operator[] (uint32_t _index) const {assert (_index < m_size); return m_storage.data()[wrap(m_head + _index)];}
+    T& operator[] (uint32_t _index) {assert (_index < m_size); return m_storage.data()[wrap(m_head + _index)];}
+ private:
+    uint32_t wrap (uint32_t _index) const
+    {
+        return (_index >= capacity()) ? (_index - capacity()) : _index;
+    }
+
+    RingBufferStorage<T, N>     m_storage;
+    uint32_t                    m_head;
+    uint32_t                    m_size;
+};
+
+}
+
+#endif
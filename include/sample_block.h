@@ -0,0 +1,73 @@
+/*
+ * Filename: sample_block.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the compressed BMP085 sample archive
+ *              format.
+ *
+ *              An archive is a 5 byte file header (magic and version)
+ *              followed by blocks. A block is a fixed-size header, which
+ *              doubles as its index entry, followed by one column per field:
+ *
+ *                time      zigzag varints of the delta of deltas, the first
+ *                          time is in the header and the delta before the
+ *                          first is zero
+ *                pressure  zigzag varints of the difference from the
+ *                          previous value, the first from zero
+ *                temp      the same as pressure
+ *                ossr      varint pairs of value and run length
+ *
+ *              Samples a regular period apart change little, so most take
+ *              a byte per column. Blocks are only appended, so an archive
+ *              can be extended across runs; a partial block at the end
+ *              (the writer stopped mid-write) is ignored.
+ */
+
+#ifndef EMBED_SAMPLE_BLOCK_H
+#define EMBED_SAMPLE_BLOCK_H
+
+#include <stdint.h>
+
+#include "bmp085.h"
+
+namespace embed
+{
+
+static const uint8_t SAMPLE_BLOCK_MAGIC[4]      = {'E', 'S', 'B', 'K'};
+static const uint8_t SAMPLE_BLOCK_VERSION       = 2;
+static const uint32_t SAMPLE_BLOCK_FILE_HEADER_SIZE = 5;
+
+// Stored unaligned in host byte order, copy it out before use
+typedef struct SampleBlockHeaderStruct
+{
+    uint32_t            m_numSamples;
+    uint32_t            m_size;             // Bytes of column data after the header
+
+    // Time of the first sample, which the time column starts from
+    uint64_t            m_baseTimeUs;
+
+    // Index, inclusive of both ends. The time range holds every sample
+    // even if the clock went backwards within the block.
+    uint64_t            m_minTimeUs;
+    uint64_t            m_maxTimeUs;
+    int32_t             m_minPressure;
+    int32_t             m_maxPressure;
+    int16_t             m_minTemp;
+    int16_t             m_maxTemp;
+
+    // Column sizes, the OSSR column takes the rest of m_size
+    uint32_t            m_timeSize;
+    uint32_t            m_pressureSize;
+    uint32_t            m_tempSize;
+
+    // Wall time less clock time for the samples in the block, zero if
+    // unknown
+    int64_t             m_wallOffsetUs;
+    BMP085::Calibration m_calibration;
+    uint8_t             m_hasCalibration;
+    uint8_t             m_reserved;
+} __attribute__ ((packed)) SampleBlockHeader;
+
+}
+
+#endif
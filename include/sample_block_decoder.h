@@ -0,0 +1,75 @@
+/*
+ * Filename: sample_block_decoder.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the reader of compressed BMP085 sample
+ *              archives (see sample_block.h)
+ */
+
+#ifndef EMBED_SAMPLE_BLOCK_DECODER_H
+#define EMBED_SAMPLE_BLOCK_DECODER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+#include <string>
+
+#include "sample_block.h"
+#include "sample_record.h"
+#include "varint.h"
+
+namespace embed
+{
+
+// Maps the archive at _path and indexes its block headers at init, so
+// blocks can be picked by time or value range from memory and only the
+// ones wanted are decoded. Block times need not increase through the
+// archive (the clock restarts with each run), so queries check every
+// index entry rather than searching.
+class SampleBlockDecoder
+{
+ public:
+    SampleBlockDecoder (const char* _path);
+    ~SampleBlockDecoder ();
+
+    bool init ();
+    void destroy ();
+
+    uint32_t getNumBlocks () {return m_index.size();}
+    uint64_t getNumSamples () {return m_numSamples;}
+    const SampleBlockHeader& getBlockHeader (const uint32_t _index) {return m_index[_index].m_header;}
+
+    // Decodes block _index into _records, which must hold its m_numSamples
+    bool decodeBlock (const uint32_t _index, SampleRecord* _records);
+
+    // Appends the samples with _startUs <= time < _endUs to _records,
+    // skipping blocks outside the range, and returns the number of blocks
+    // decoded
+    uint32_t query (const uint64_t _startUs, const uint64_t _endUs, std::vector<SampleRecord>* _records);
+ private:
+    typedef struct BlockIndexStruct
+    {
+        SampleBlockHeader   m_header;
+        const uint8_t*      m_data;
+    } BlockIndex;
+
+    // Reports a block that does not decode and returns false
+    bool corrupt (const uint32_t _index);
+
+    std::string                 m_path;
+    uint8_t*                    m_map;
+    size_t                      m_mapSize;
+    std::vector<BlockIndex>     m_index;
+    uint64_t                    m_numSamples;
+    std::vector<SampleRecord>   m_scratch;
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Filename: sample_block_encoder.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the writer of compressed BMP085 sample
+ *              archives (see sample_block.h)
+ */
+
+#ifndef EMBED_SAMPLE_BLOCK_ENCODER_H
+#define EMBED_SAMPLE_BLOCK_ENCODER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+
+#include "sample_block.h"
+#include "sample_record.h"
+#include "varint.h"
+
+namespace embed
+{
+
+// Collects samples into blocks of _samplesPerBlock and appends each one to
+// the archive at _path as it fills, so memory use is bounded by one block
+// however long the stream. An existing archive is appended to. Changing
+// the calibration or wall offset finishes the current block, so each
+// block describes all of its samples. Samples are appended from one thread.
+class SampleBlockEncoder
+{
+ public:
+    SampleBlockEncoder (const char* _path, const uint32_t _samplesPerBlock = DEFAULT_SAMPLES_PER_BLOCK);
+    ~SampleBlockEncoder ();
+
+    bool init ();
+    // Writes the partial block and closes the archive
+    void destroy ();
+
+    void setCalibration (const BMP085::Calibration& _calibration);
+    void setWallOffsetUs (const int64_t _wallOffsetUs);
+
+    bool append (const SampleRecord& _record);
+    // Writes the partial block, the next sample starts a new one
+    bool flush ();
+
+    uint64_t getNumSamples () {return m_numSamples;}
+    uint64_t getNumBlocks () {return m_numBlocks;}
+    // Bytes written, including headers
+    uint64_t getNumBytes () {return m_numBytes;}
+ private:
+    static const uint32_t DEFAULT_SAMPLES_PER_BLOCK = 1024;
+
+    bool writeAll (const uint8_t* _buf, const size_t _len);
+
+    std::string                 m_path;
+    uint32_t                    m_samplesPerBlock;
+    int32_t                     m_fd;
+
+    BMP085::Calibration         m_calibration;
+    bool                        m_hasCalibration;
+    int64_t                     m_wallOffsetUs;
+
+    std::vector<SampleRecord>   m_pending;
+    std::vector<uint8_t>        m_buffer;
+
+    uint64_t                    m_numSamples;
+    uint64_t                    m_numBlocks;
+    uint64_t                    m_numBytes;
+};
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Filename: sample_bus.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the shared memory layout of the BMP085
+ *              sample bus, which lets the process that owns the device
+ *              share its samples with other processes.
+ *
+ *              The bus is a POSIX shared memory object /<name> holding a
+ *              header and a ring of slots. The publisher writes sample n to
+ *              slot n % capacity, seqlock style: it clears the slot's
+ *              sequence, writes the record, sets the sequence to n + 1 and
+ *              then publishes the count. A subscriber copies a slot out and
+ *              uses it only if the sequence was n + 1 both before and after
+ *              the copy, otherwise the publisher lapped it. Subscribers map
+ *              the bus read-only and never write to it, so the publisher
+ *              never waits for them and a slow or crashed subscriber only
+ *              affects itself. After each sample the publisher bumps a
+ *              futex word and wakes any subscriber sleeping on it.
+ */
+
+#ifndef EMBED_SAMPLE_BUS_H
+#define EMBED_SAMPLE_BUS_H
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "bmp085.h"
+#include "sample_record.h"
+
+namespace embed
+{
+
+static const uint8_t SAMPLE_BUS_MAGIC[4]        = {'E', 'S', 'B', 'S'};
+static const uint32_t SAMPLE_BUS_VERSION        = 1;
+
+typedef struct SampleBusSlotStruct
+{
+    uint64_t            m_seq;              // Sample number + 1, 0 while written
+    // The record as words, so the racing copies are atomic accesses
+    uint64_t            m_words[sizeof(SampleRecord) / sizeof(uint64_t)];
+} __attribute__ ((aligned (32))) SampleBusSlot;
+
+static_assert (sizeof(SampleRecord) % sizeof(uint64_t) == 0, "SampleRecord must be a whole number of words");
+
+typedef struct SampleBusHeaderStruct
+{
+    uint8_t             m_magic[4];         // Written last by the publisher
+    uint32_t            m_version;
+    uint32_t            m_headerSize;       // Offset of the first slot
+    uint32_t            m_slotSize;
+    uint32_t            m_capacity;         // Slots, a power of two
+    int32_t             m_publisherPid;
+
+    // Seqlock, odd while the calibration is being changed
+    uint32_t            m_calibrationSeq;
+    BMP085::Calibration m_calibration;
+    uint8_t             m_hasCalibration;
+
+    // Only accessed atomically, each on its own cache line
+    uint64_t            m_numPublished __attribute__ ((aligned (64)));
+    uint32_t            m_futex __attribute__ ((aligned (64)));
+} __attribute__ ((aligned (64))) SampleBusHeader;
+
+// Shared (not private) futex operations, the word is in memory mapped by
+// several processes
+inline void sampleBusWake (uint32_t* _futex)
+{
+    syscall (SYS_futex, _futex, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+inline void sampleBusWait (const uint32_t* _futex, const uint32_t _val, const uint64_t _timeoutUs)
+{
+    struct timespec timeout;
+    timeout.tv_sec = _timeoutUs / 1000000;
+    timeout.tv_nsec = (_timeoutUs % 1000000) * 1000;
+    syscall (SYS_futex, _futex, FUTEX_WAIT, _val, &timeout, NULL, 0);
+}
+
+}
+
+#endif
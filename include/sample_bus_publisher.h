@@ -0,0 +1,82 @@
+/*
+ * Filename: sample_bus_publisher.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the publishing side of the BMP085 sample
+ *              bus (see sample_bus.h)
+ */
+
+#ifndef EMBED_SAMPLE_BUS_PUBLISHER_H
+#define EMBED_SAMPLE_BUS_PUBLISHER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <string>
+
+#include "sample_bus.h"
+#include "bmp085.h"
+#include "clock.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+// Creates the bus /<_name> with _capacity slots (rounded up to a power of
+// two), replacing any left behind by a publisher that crashed. Sized for
+// the longest a subscriber may stall: at the high resolution sample rate
+// the default 4096 slots last about 50 seconds. A publish is a few stores
+// into the mapping and one futex wake, the same whatever the number of
+// subscribers.
+class SampleBusPublisher
+{
+ public:
+    SampleBusPublisher (const char* _name, const uint32_t _capacity = DEFAULT_CAPACITY, Clock* _clock = NULL);
+    ~SampleBusPublisher ();
+
+    bool init ();
+    // Removes the bus, subscribers keep their mapping until they let it go
+    void destroy ();
+
+    void setCalibration (const BMP085::Calibration& _calibration);
+
+    // Adds a sample, timestamped with the clock if no time is given
+    bool publish (const int16_t _rawTemp, const int32_t _rawPressure, const uint8_t _ossr);
+    bool publish (const uint64_t _timeUs, const int16_t _rawTemp, const int32_t _rawPressure,
+                  const uint8_t _ossr);
+
+    // Publishes every sample _device dispatches, taking its calibration.
+    // The device must be initialized.
+    void attach (BMP085* _device);
+    void detach ();
+
+    uint64_t getNumPublished () {return m_numPublished;}
+    uint32_t getCapacity () {return m_capacity;}
+ private:
+    static const uint32_t DEFAULT_CAPACITY = 4096;
+
+    static void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+
+    std::string             m_name;
+    uint32_t                m_capacity;
+    Clock*                  m_clock;
+    BMP085*                 m_device;
+
+    uint8_t*                m_map;
+    size_t                  m_mapSize;
+    SampleBusHeader*        m_header;
+    SampleBusSlot*          m_slots;
+    uint64_t                m_numPublished;
+
+    // Samples come from the interrupt thread and calibration from any
+    pthread_mutex_t         m_busMutex;
+};
+
+}
+
+#endif
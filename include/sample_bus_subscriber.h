@@ -0,0 +1,106 @@
+/*
+ * Filename: sample_bus_subscriber.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the subscribing side of the BMP085 sample
+ *              bus (see sample_bus.h)
+ */
+
+#ifndef EMBED_SAMPLE_BUS_SUBSCRIBER_H
+#define EMBED_SAMPLE_BUS_SUBSCRIBER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <map>
+#include <vector>
+#include <string>
+
+#include "sample_bus.h"
+#include "bmp085.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+// Reads the bus /<_name> in place without locks, starting from the next
+// sample published. A subscriber that falls more than the capacity behind
+// skips to the oldest sample still in the ring and counts the ones it
+// missed. Samples can be read directly, or dispatched by run() to
+// listeners registered exactly as they would be with a BMP085. Each
+// subscriber is used from one thread.
+class SampleBusSubscriber
+{
+ public:
+    SampleBusSubscriber (const char* _name);
+    ~SampleBusSubscriber ();
+
+    // Fails if there is no bus yet
+    bool init ();
+    void destroy ();
+
+    // Moves back to the oldest sample still in the ring
+    void seekOldest ();
+
+    // Copies out the next sample, false if there is none yet
+    bool read (SampleRecord* _record);
+    // Waits up to _timeoutUs for the next sample
+    bool wait (SampleRecord* _record, const uint64_t _timeoutUs);
+
+    // Dispatches samples to the listeners until stop() is called, from a
+    // listener or another thread. As with BMP085, listeners may register
+    // and unregister listeners, themselves included, while being called.
+    void registerListener (BMP085::EOCIntHandler _handler, void* _data);
+    void unregisterListener (BMP085::EOCIntHandler _handler);
+    void run ();
+    void stop ();
+
+    // Sample being dispatched, for listeners
+    uint64_t getSampleTimeUs () {return m_sample.m_timeUs;}
+    BMP085::OSSR_SETTING getSampleOSSR () {return (BMP085::OSSR_SETTING) m_sample.m_ossr;}
+
+    bool getCalibration (BMP085::Calibration* _calibration);
+
+    // Whether the process that created the bus is still running, once it
+    // has gone the subscriber must init again to find its replacement
+    bool isPublisherAlive ();
+
+    uint64_t getNumRead () {return m_numRead;}
+    uint64_t getNumDropped () {return m_numDropped;}
+ private:
+    // Time run() waits before checking for stop()
+    static const uint64_t RUN_POLL_US = 100000;
+
+    bool isUnregistered (BMP085::EOCIntHandler _handler);
+
+    std::string             m_name;
+    const uint8_t*          m_map;
+    size_t                  m_mapSize;
+    const SampleBusHeader*  m_header;
+    const SampleBusSlot*    m_slots;
+    uint64_t                m_mask;
+
+    uint64_t                m_next;
+    uint64_t                m_numRead;
+    uint64_t                m_numDropped;
+
+    // Those unregistered while dispatching are erased once the dispatch
+    // loop is done with its iterator
+    std::map<BMP085::EOCIntHandler,void*>   m_listeners;
+    pthread_mutex_t         m_listenersMutex;
+    bool                    m_dispatching;
+    std::vector<BMP085::EOCIntHandler>      m_unregistered;
+    volatile bool           m_stop;
+    SampleRecord            m_sample;
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Filename: sample_log_reader.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the reader of the memory-mapped BMP085
+ *              sample log (see sample_record.h)
+ */
+
+#ifndef EMBED_SAMPLE_LOG_READER_H
+#define EMBED_SAMPLE_LOG_READER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "sample_record.h"
+
+namespace embed
+{
+
+// Maps the segments of the log <_dir>/<_name> read-only, one at a time,
+// and hands out the published records in place. It can run while the log
+// is being written: the record count only grows, and once a segment is
+// sealed refresh() finds the one after it.
+class SampleLogReader
+{
+ public:
+    SampleLogReader (const char* _dir, const char* _name);
+    ~SampleLogReader ();
+
+    // Finds the segments, call again to pick up new ones
+    bool refresh ();
+    uint32_t getNumSegments () {return m_sequences.size();}
+    uint64_t getSegmentSequence (const uint32_t _index) {return m_sequences[_index];}
+
+    // Maps the segment at _index in sequence order, unmapping the previous one
+    bool openSegment (const uint32_t _index);
+    void closeSegment ();
+
+    // Current segment, the header and records stay valid until it is closed
+    const SampleSegmentHeader* getHeader () {return m_header;}
+    const SampleRecord* getRecords (uint64_t* _numRecords);
+    bool isSealed ();
+
+    // Converts a record time to wall time in us
+    uint64_t toWallUs (const uint64_t _timeUs);
+ private:
+    std::string             m_dir;
+    std::string             m_name;
+    std::vector<uint64_t>   m_sequences;
+
+    uint8_t*                m_map;
+    size_t                  m_mapSize;
+    const SampleSegmentHeader*  m_header;
+    const SampleRecord*     m_records;
+};
+
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Filename: sample_log_replayer.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a sample source that replays a BMP085
+ *              sample log (see sample_record.h) to BMP085 listeners
+ */
+
+#ifndef EMBED_SAMPLE_LOG_REPLAYER_H
+#define EMBED_SAMPLE_LOG_REPLAYER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <map>
+#include <vector>
+#include <string>
+
+#include "bmp085.h"
+#include "sample_log_reader.h"
+#include "clock.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+// Dispatches the samples of the log <_dir>/<_name> to listeners registered
+// exactly as they would be with a BMP085, so filters, alarms and displays
+// can be run against recorded data. Samples are due at their recorded
+// times relative to the first one, divided by the speed, and run() waits
+// on the clock for each one: 1.0 is the recorded pace, 10.0 ten times
+// faster and AS_FAST_AS_POSSIBLE never waits. Gaps longer than
+// setMaxGapUs(), such as between two logging runs, are skipped.
+//
+// While a listener runs, getSampleTimeUs() and getSampleOSSR() describe
+// the sample and getCalibration() the device it came from. The rates
+// reported after a run are measured on the system clock, so they are the
+// rates the listeners actually sustained whatever clock paced the replay.
+class SampleLogReplayer
+{
+ public:
+    static constexpr double AS_FAST_AS_POSSIBLE = 0.0;
+
+    SampleLogReplayer (const char* _dir, const char* _name, Clock* _clock = NULL);
+    ~SampleLogReplayer ();
+
+    void setSpeed (const double _speed) {m_speed = _speed;}
+    double getSpeed () {return m_speed;}
+
+    void setMaxGapUs (const uint64_t _maxGapUs) {m_maxGapUs = _maxGapUs;}
+    uint64_t getMaxGapUs () {return m_maxGapUs;}
+
+    // As with BMP085, listeners may register and unregister listeners,
+    // themselves included, while being called
+    void registerListener (BMP085::EOCIntHandler _handler, void* _data);
+    void unregisterListener (BMP085::EOCIntHandler _handler);
+
+    // Replays the log on the calling thread until it ends or stop() is
+    // called, from a listener or another thread. Returns false if the log
+    // could not be read.
+    bool run ();
+    void stop ();
+
+    // Sample being dispatched, for listeners
+    uint64_t getSampleTimeUs () {return m_sampleTimeUs;}
+    BMP085::OSSR_SETTING getSampleOSSR () {return m_sampleOssr;}
+    bool getCalibration (BMP085::Calibration* _calibration);
+
+    // Results of the last run
+    uint64_t getNumDispatched () {return m_numDispatched;}
+    uint64_t getNumGapsSkipped () {return m_numGapsSkipped;}
+    // Samples per second over the whole run
+    double getDispatchRate ();
+    // Samples per second of time spent in the listeners, the rate they
+    // could sustain if samples arrived back to back
+    double getListenerRate ();
+    // Furthest a dispatch fell behind its due time on the clock
+    uint64_t getMaxLagUs () {return m_maxLagUs;}
+ private:
+    static const uint64_t DEFAULT_MAX_GAP_US = 1000000;
+
+    // Waits until the record at _timeUs is due, re-basing the schedule
+    // after a gap
+    void waitForSample (const uint64_t _timeUs);
+    bool isUnregistered (BMP085::EOCIntHandler _handler);
+
+    std::string                     m_dir;
+    std::string                     m_name;
+    Clock*                          m_clock;
+    double                          m_speed;
+    uint64_t                        m_maxGapUs;
+    volatile bool                   m_stop;
+
+    // Listeners are registered from any thread, those unregistered while
+    // dispatching are erased once the dispatch loop is done with its
+    // iterator
+    std::map<BMP085::EOCIntHandler,void*>   m_listeners;
+    pthread_mutex_t                 m_listenersMutex;
+    bool                            m_dispatching;
+    std::vector<BMP085::EOCIntHandler>      m_unregistered;
+
+    // Schedule, record time _timeUs is due at
+    // m_baseClockUs + (_timeUs - m_baseRecordUs) / m_speed
+    bool                            m_scheduled;
+    uint64_t                        m_baseRecordUs;
+    uint64_t                        m_baseClockUs;
+    uint64_t                        m_lastRecordUs;
+
+    const SampleSegmentHeader*      m_header;
+    uint64_t                        m_sampleTimeUs;
+    BMP085::OSSR_SETTING            m_sampleOssr;
+
+    uint64_t                        m_numDispatched;
+    uint64_t                        m_numGapsSkipped;
+    uint64_t                        m_runUs;
+    uint64_t                        m_listenerUs;
+    uint64_t                        m_maxLagUs;
+};
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Filename: sample_log_writer.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the writer of the memory-mapped BMP085
+ *              sample log (see sample_record.h)
+ */
+
+#ifndef EMBED_SAMPLE_LOG_WRITER_H
+#define EMBED_SAMPLE_LOG_WRITER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <vector>
+
+#include "sample_record.h"
+#include "bmp085.h"
+#include "clock.h"
+#include "system_clock.h"
+#include "trace.h"
+
+namespace embed
+{
+
+// Appends samples to the log <_dir>/<_name>. An append is a 16 byte store
+// into the mapped segment and a release store of the count, with no
+// system calls, until the segment holds _recordsPerSegment records and
+// the writer rotates to the next one. A background thread keeps the next
+// segment created under a temporary name, preallocated and mapped, so
+// rotating is a swap of mappings; the thread then renames the new segment
+// into place, so readers never see a partial one, and unmaps the old one.
+// A log is never appended to across runs, init starts a segment after the
+// last one.
+class SampleLogWriter
+{
+ public:
+    SampleLogWriter (const char* _dir, const char* _name,
+                     const uint32_t _recordsPerSegment = DEFAULT_RECORDS_PER_SEGMENT,
+                     Clock* _clock = NULL);
+    ~SampleLogWriter ();
+
+    bool init ();
+    void destroy ();
+
+    // Stored in the header of every following segment
+    void setCalibration (const BMP085::Calibration& _calibration);
+
+    // Adds a sample, timestamped with the clock if no time is given
+    bool append (const int16_t _rawTemp, const int32_t _rawPressure, const uint8_t _ossr);
+    bool append (const uint64_t _timeUs, const int16_t _rawTemp, const int32_t _rawPressure,
+                 const uint8_t _ossr);
+
+    // Logs every sample _device dispatches, taking its calibration. The
+    // device must be initialized.
+    void attach (BMP085* _device);
+    void detach ();
+
+    // Asks the kernel to write the current segment back to disk
+    void sync ();
+
+    uint64_t getNumRecords () {return m_numRecords;}
+    uint64_t getSequence () {return m_sequence;}
+ private:
+    static const uint32_t DEFAULT_RECORDS_PER_SEGMENT = 64 * 1024;
+
+    // A rotation waits for the spare the thread makes after handling the
+    // previous rotation, so no more than this is ever pending
+    static const uint32_t MAX_PENDING_SEGMENTS = 4;
+
+    static void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+
+    typedef struct SegmentStruct
+    {
+        uint64_t            m_sequence;
+        uint8_t*            m_map;
+        size_t              m_mapSize;
+    } Segment;
+
+    static void* segmentThread (void* _data);
+
+    // Seals the current segment and swaps in the spare one, the caller
+    // holds the log lock
+    bool rotate ();
+    void startSegment (const Segment& _segment);
+    void closeSegment ();
+
+    // Creates, preallocates and maps a segment under its temporary name,
+    // and renames it into place once it has its header
+    bool prepareSegment (const uint64_t _sequence, Segment* _segment);
+    bool publishSegment (const uint64_t _sequence);
+    std::string segmentPath (const uint64_t _sequence);
+    uint64_t findNextSequence ();
+
+    std::string             m_dir;
+    std::string             m_name;
+    uint32_t                m_recordsPerSegment;
+    Clock*                  m_clock;
+    bool                    m_initialized;
+
+    BMP085::Calibration     m_calibration;
+    bool                    m_hasCalibration;
+    BMP085*                 m_device;
+
+    // Current segment
+    uint64_t                m_sequence;
+    Segment                 m_segment;
+    SampleSegmentHeader*    m_header;
+    SampleRecord*           m_records;
+    uint64_t                m_segmentRecords;
+
+    uint64_t                m_numRecords;
+
+    // Appends come from the interrupt thread and rotation from any appender
+    pthread_mutex_t         m_logMutex;
+
+    // Segment thread state. Rotation takes the spare and leaves the
+    // swapped in segment to be published and the old one to be unmapped.
+    pthread_t               m_thread;
+    bool                    m_running;
+    Segment                 m_spare;
+    bool                    m_spareReady;
+    bool                    m_spareFailed;
+    std::vector<uint64_t>   m_unpublished;
+    std::vector<Segment>    m_retired;
+    pthread_mutex_t         m_segmentMutex;
+    pthread_cond_t          m_segmentCond;
+    pthread_cond_t          m_spareCond;
+};
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Filename: sample_record.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the on-disk layout of the BMP085 sample log.
+ *
+ *              A log is a series of segment files <dir>/<name>-<sequence>.slog,
+ *              each preallocated to hold a fixed number of records and
+ *              written through a shared mapping. A segment is a header
+ *              followed by an array of fixed-size records. The writer
+ *              publishes records by storing the record count with release
+ *              ordering after writing them, so a reader that loads the count
+ *              with acquire ordering can use every record before it in place.
+ *              A segment is sealed when the writer moves on from it.
+ */
+
+#ifndef EMBED_SAMPLE_RECORD_H
+#define EMBED_SAMPLE_RECORD_H
+
+#include <stdint.h>
+
+#include "bmp085.h"
+
+namespace embed
+{
+
+static const uint8_t SAMPLE_LOG_MAGIC[4]        = {'E', 'S', 'L', 'G'};
+static const uint32_t SAMPLE_LOG_VERSION        = 1;
+static const char SAMPLE_LOG_EXTENSION[]        = ".slog";
+
+// One BMP085 sample, raw so nothing is lost, with the OSSR setting needed
+// to compensate it
+typedef struct SampleRecordStruct
+{
+    uint64_t            m_timeUs;           // Clock time of the sample
+    int32_t             m_rawPressure;
+    int16_t             m_rawTemp;
+    uint8_t             m_ossr;
+    uint8_t             m_reserved;
+} SampleRecord;
+
+static_assert (sizeof(SampleRecord) == 16, "SampleRecord must stay 16 bytes so records never straddle a page");
+
+typedef struct SampleSegmentHeaderStruct
+{
+    uint8_t             m_magic[4];
+    uint32_t            m_version;
+    uint32_t            m_headerSize;       // Offset of the first record
+    uint32_t            m_recordSize;
+    uint64_t            m_sequence;         // Position of the segment in the log
+    uint64_t            m_capacity;         // Records the segment holds
+
+    // Clock and wall (CLOCK_REALTIME) times the segment was created at,
+    // to convert record times to wall time
+    uint64_t            m_clockStartUs;
+    uint64_t            m_wallStartUs;
+
+    BMP085::Calibration m_calibration;
+    uint8_t             m_hasCalibration;
+
+    // Only accessed atomically, each on its own cache line so the reader
+    // polling them does not slow the writer's record stores
+    uint64_t            m_numRecords __attribute__ ((aligned (64)));
+    uint64_t            m_sealed __attribute__ ((aligned (64)));
+} __attribute__ ((aligned (64))) SampleSegmentHeader;
+
+static_assert (sizeof(SampleSegmentHeader) % sizeof(SampleRecord) == 0, "Records must stay aligned");
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Filename: sensor_client.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a client of the sensor daemon (see
+ *              sensor_protocol.h)
+ */
+
+#ifndef EMBED_SENSOR_CLIENT_H
+#define EMBED_SENSOR_CLIENT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <deque>
+#include <string>
+
+#include "i2c.h"
+#include "sensor_protocol.h"
+#include "bmp085.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+// Connects to the daemon at _path. It is an I2C bus, each access a one
+// operation batch on the daemon's bus, so drivers for other devices on
+// the bus run unchanged in the client process; transfer() sends several
+// accesses as one batch that nothing else on the bus can split, in one
+// round trip. Subscribing streams BMP085 samples, which are queued (up to
+// _maxQueued, dropping the oldest) while waiting for batch results. A
+// client is used from one thread.
+class SensorClient : public I2C
+{
+ public:
+    SensorClient (const char* _path, const uint32_t _maxQueued = DEFAULT_MAX_QUEUED);
+    ~SensorClient ();
+
+    bool init();
+    void destroy();
+
+    uint8_t readReg (const uint8_t _addr, const uint8_t _reg);
+    void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val);
+    void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
+
+    // Runs _ops in order, filling _readBuf with the bytes read
+    bool transfer (const SensorBatchOp* _ops, const uint32_t _num, uint8_t* _readBuf, const uint32_t _readLen);
+
+    // Subscribing waits for the calibration, which getCalibration() then
+    // returns. The stream may run at a higher OSSR setting than asked for
+    // if another client asked for it, each sample carries its own.
+    bool subscribe (const BMP085::OSSR_SETTING _ossr);
+    bool unsubscribe ();
+    bool getCalibration (BMP085::Calibration* _calibration);
+
+    // Waits up to _timeoutUs for the next sample
+    bool readSample (SampleRecord* _record, const uint64_t _timeoutUs);
+
+    uint64_t getNumSamplesDropped () {return m_numSamplesDropped;}
+ private:
+    static const uint32_t DEFAULT_MAX_QUEUED = 1024;
+    static const uint64_t REPLY_TIMEOUT_US = 1000000;
+
+    // Receives one message, waiting up to _timeoutUs, and handles it.
+    // Returns its type, or SENSOR_MESSAGE_NUM if none arrived.
+    SENSOR_MESSAGE receive (const uint64_t _timeoutUs);
+    // Receives until a message of _type arrives
+    bool receiveUntil (SENSOR_MESSAGE _type, const uint64_t _timeoutUs);
+
+    std::string                 m_path;
+    uint32_t                    m_maxQueued;
+    int32_t                     m_fd;
+
+    std::deque<SampleRecord>    m_samples;
+    uint64_t                    m_numSamplesDropped;
+    BMP085::Calibration         m_calibration;
+    bool                        m_hasCalibration;
+
+    // Batch in flight and its result
+    uint16_t                    m_batchId;
+    uint8_t                     m_result[SENSOR_MAX_MESSAGE_SIZE];
+    uint32_t                    m_resultLen;
+    bool                        m_resultReady;
+};
+
+}
+
+#endif
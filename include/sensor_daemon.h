@@ -0,0 +1,115 @@
+/*
+ * Filename: sensor_daemon.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a daemon that owns the I2C bus and the
+ *              BMP085 and serves them to other processes (see
+ *              sensor_protocol.h)
+ */
+
+#ifndef EMBED_SENSOR_DAEMON_H
+#define EMBED_SENSOR_DAEMON_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <map>
+#include <vector>
+#include <string>
+
+#include "sensor_protocol.h"
+#include "locked_i2c.h"
+#include "bmp085.h"
+#include "clock.h"
+#include "system_clock.h"
+
+namespace embed
+{
+
+// Listens on the Unix domain socket at _path and serves clients from its
+// own thread. _device must use _bus, and must not be initialized, as the
+// daemon runs its async state machine only while there are subscribers:
+// however many there are, there is one sampling stream, at the highest
+// OSSR setting any of them asked for, and each sample is encoded once and
+// sent to all of them. A client that is not keeping up has samples
+// dropped rather than holding up the others. Batches of register accesses
+// run with the bus held, so they are never split by the state machine or
+// another client.
+class SensorDaemon
+{
+ public:
+    SensorDaemon (const char* _path, LockedI2C* _bus, BMP085* _device, Clock* _clock = NULL);
+    ~SensorDaemon ();
+
+    // Replaces a socket left at _path by a daemon that stopped
+    bool init ();
+    void destroy ();
+
+    bool isStreaming () {return m_streaming;}
+    uint32_t getNumClients ();
+    uint32_t getNumSubscribers ();
+    uint32_t getNumStreamStarts () {return m_numStreamStarts;}
+    uint64_t getNumSamples () {return m_numSamples;}
+    uint64_t getNumSamplesSent () {return m_numSamplesSent;}
+    uint64_t getNumSamplesDropped () {return m_numSamplesDropped;}
+    uint64_t getNumBatches () {return m_numBatches;}
+ private:
+    // Not subscribed
+    static const int32_t NO_OSSR = -1;
+
+    typedef struct ClientStruct
+    {
+        int32_t             m_fd;
+        int32_t             m_ossr;
+    } Client;
+
+    static void* serveThread (void* _data);
+    static void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+
+    void serve ();
+    void acceptClient ();
+    void closeClient (const int32_t _fd);
+    // Returns false if the client should be dropped
+    bool handleMessage (const int32_t _fd, const uint8_t* _buf, const size_t _len);
+    bool handleBatch (const int32_t _fd, const uint8_t* _buf, const size_t _len);
+    bool send (const int32_t _fd, const uint8_t* _buf, const size_t _len);
+
+    // Starts, stops or re-tunes the stream for the subscribers plus one
+    // wanting _extraOssr, only called from the serve thread
+    void updateStream (const int32_t _extraOssr = NO_OSSR);
+
+    std::string                 m_path;
+    LockedI2C*                  m_bus;
+    BMP085*                     m_device;
+    Clock*                      m_clock;
+
+    int32_t                     m_listenFd;
+    int32_t                     m_wakePipe[2];
+    pthread_t                   m_thread;
+    volatile bool               m_running;
+
+    // Samples are sent from the interrupt thread, the device is never
+    // called with the lock held
+    std::map<int32_t,Client>    m_clients;
+    pthread_mutex_t             m_clientsMutex;
+
+    volatile bool               m_streaming;
+    BMP085::OSSR_SETTING        m_streamOssr;
+
+    uint32_t                    m_numStreamStarts;
+    uint64_t                    m_numSamples;
+    uint64_t                    m_numSamplesSent;
+    uint64_t                    m_numSamplesDropped;
+    uint64_t                    m_numBatches;
+};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Filename: sensor_protocol.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the protocol between the sensor daemon and
+ *              its clients.
+ *
+ *              Clients connect to the daemon's Unix domain SOCK_SEQPACKET
+ *              socket, so every send is one message and arrives whole or
+ *              not at all. A message is a type byte followed by its
+ *              payload, in native byte order as both ends are on the same
+ *              machine:
+ *
+ *                HELLO         daemon, on connect   version (uint8)
+ *                SUBSCRIBE     client               OSSR setting (uint8)
+ *                UNSUBSCRIBE   client               none
+ *                CALIBRATION   daemon, on subscribe BMP085::Calibration
+ *                SAMPLE        daemon               SampleRecord
+ *                BATCH         client               id (uint16), number of
+ *                                                   operations (uint8), then
+ *                                                   SensorBatchOp each
+ *                BATCH_RESULT  daemon               id (uint16), status
+ *                                                   (uint8), then the bytes
+ *                                                   read in operation order
+ */
+
+#ifndef EMBED_SENSOR_PROTOCOL_H
+#define EMBED_SENSOR_PROTOCOL_H
+
+#include <stdint.h>
+
+#include "bmp085.h"
+#include "sample_record.h"
+
+namespace embed
+{
+
+static const uint8_t SENSOR_PROTOCOL_VERSION    = 1;
+
+// Longest message either way
+static const uint32_t SENSOR_MAX_MESSAGE_SIZE   = 1024;
+
+typedef enum SENSOR_MESSAGE_ENUM
+{
+    SENSOR_HELLO = 0,
+    SENSOR_SUBSCRIBE,
+    SENSOR_UNSUBSCRIBE,
+    SENSOR_CALIBRATION,
+    SENSOR_SAMPLE,
+    SENSOR_BATCH,
+    SENSOR_BATCH_RESULT,
+    SENSOR_MESSAGE_NUM
+} SENSOR_MESSAGE;
+
+typedef enum SENSOR_BATCH_OP_TYPE_ENUM
+{
+    SENSOR_OP_READ = 0,                     // One register, one byte back
+    SENSOR_OP_WRITE,                        // m_arg is the value
+    SENSOR_OP_READ_BURST,                   // m_arg registers, m_arg bytes back
+    SENSOR_OP_TYPE_NUM
+} SENSOR_BATCH_OP_TYPE;
+
+typedef enum SENSOR_STATUS_ENUM
+{
+    SENSOR_STATUS_OK = 0,
+    SENSOR_STATUS_BAD_REQUEST
+} SENSOR_STATUS;
+
+typedef struct SensorBatchOpStruct
+{
+    uint8_t             m_type;
+    uint8_t             m_addr;
+    uint8_t             m_reg;
+    uint8_t             m_arg;
+} SensorBatchOp;
+
+static const uint32_t SENSOR_BATCH_HEADER_SIZE  = 1 + 2 + 1;
+static const uint32_t SENSOR_BATCH_RESULT_HEADER_SIZE = 1 + 2 + 1;
+static const uint32_t SENSOR_MAX_BATCH_OPS      = (SENSOR_MAX_MESSAGE_SIZE - SENSOR_BATCH_HEADER_SIZE) /
+                                                  sizeof(SensorBatchOp);
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Filename: sim_bmp085.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a register-level BMP085 model for the
+ *              simulated I2C bus. It is loaded with the datasheet example
+ *              calibration, so the datasheet example raw values compensate
+ *              to 15.0 C and 69964 Pa. Conversions take the datasheet
+ *              typical time for their OSSR setting and raise EOC when done.
+ */
+
+#ifndef EMBED_SIM_BMP085_H
+#define EMBED_SIM_BMP085_H
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "timer.h"
+
+namespace embed
+{
+
+class SimBMP085 : public SimI2CDevice
+{
+ public:
+    static const uint8_t ADDRESS                = 0x77;
+
+    // Datasheet example raw values, the pressure at OSSR 0 resolution
+    static const int32_t EXAMPLE_RAW_TEMP       = 27898;
+    static const int32_t EXAMPLE_RAW_PRESSURE   = 23843;
+
+    // Conversions finish after their datasheet time on _timer, driving _eoc
+    // low while they run. Without a timer they finish as soon as they are
+    // started and EOC stays high, which is enough for synchronous reads
+    // that sleep or poll. EEPROM and conversion registers do not respond
+    // while _xclr is held low.
+    SimBMP085 (Timer* _timer = NULL, SimGPIO* _eoc = NULL, SimGPIO* _xclr = NULL);
+    ~SimBMP085 ();
+
+    // For pins created after the model
+    void connectEOC (SimGPIO* _eoc);
+    void connectXCLR (SimGPIO* _xclr);
+
+    // Raw ADC values reported by the following conversions. Higher OSSR
+    // settings report the pressure with extra resolution bits appended.
+    void setRawValues (const int32_t _temp, const int32_t _pressure);
+
+    // Conversion time in us for a control register command
+    static uint32_t getConversionTimeUs (const uint8_t _command);
+
+    // Number of conversions started and finished
+    uint32_t getNumConversions () {return m_numConversions;}
+
+    // The next _num conversions finish without raising EOC, as if the
+    // driver missed their edges. EOC rises again with the conversion
+    // after them.
+    void dropEOCEdges (const uint32_t _num);
+
+    uint8_t readReg (const uint8_t _reg);
+    void writeReg (const uint8_t _reg, const uint8_t _val);
+ private:
+    static const uint8_t CHIP_ID_REG        = 0xD0;
+    static const uint8_t CHIP_ID            = 0x55;
+    static const uint8_t EEPROM_REG         = 0xAA;
+    static const uint8_t CTRL_REG           = 0xF4;
+    static const uint8_t VALUE_MSB_REG      = 0xF6;
+    static const uint8_t TEMPERATURE        = 0x2E;
+    static const uint8_t PRESSURE_OSRS0     = 0x34;
+
+    static void conversionTimerHandler (void* _data);
+
+    bool inReset ();
+    void startConversion (const uint8_t _command);
+    void finishConversion ();
+
+    Timer*              m_timer;
+    SimGPIO*            m_eoc;
+    SimGPIO*            m_xclr;
+
+    // Registers are read from the bus thread and written by conversions
+    // finishing on the timer thread
+    pthread_mutex_t     m_regsMutex;
+    uint8_t             m_regs[256];
+    uint8_t             m_command;
+    int32_t             m_rawTemp;
+    int32_t             m_rawPressure;
+    uint32_t            m_numConversions;
+    uint32_t            m_numEdgesToDrop;
+};
+
+}
+
+#endif
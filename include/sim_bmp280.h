@@ -0,0 +1,62 @@
+/*
+ * Filename: sim_bmp280.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a register-level BMP280/BME280 model for the
+ *              simulated I2C bus. It is loaded with the datasheet example
+ *              calibration, so the datasheet example raw values compensate
+ *              to 25.08 C and about 100653 Pa.
+ */
+
+#ifndef EMBED_SIM_BMP280_H
+#define EMBED_SIM_BMP280_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sim_i2c.h"
+
+namespace embed
+{
+
+class SimBMP280 : public SimI2CDevice
+{
+ public:
+    // Datasheet example raw values
+    static const int32_t EXAMPLE_RAW_TEMP       = 519888;
+    static const int32_t EXAMPLE_RAW_PRESSURE   = 415148;
+    static const int32_t EXAMPLE_RAW_HUMIDITY   = 30000;
+
+    SimBMP280 (bool _bme280 = false);
+    ~SimBMP280 ();
+
+    // Raw ADC values reported by the following measurements
+    void setRawValues (const int32_t _temp, const int32_t _pressure, const int32_t _humidity = 0);
+
+    // Number of measurements taken (forced) or read (normal mode)
+    uint32_t getNumMeasurements () {return m_numMeasurements;}
+
+    uint8_t readReg (const uint8_t _reg);
+    void writeReg (const uint8_t _reg, const uint8_t _val);
+    void beginRead ();
+ private:
+    static const uint8_t ID_REG             = 0xD0;
+    static const uint8_t RESET_REG          = 0xE0;
+    static const uint8_t CTRL_MEAS_REG      = 0xF4;
+    static const uint8_t DATA_REG           = 0xF7;
+    static const uint8_t RESET_VALUE        = 0xB6;
+
+    void powerOn ();
+    void latchMeasurement ();
+
+    bool                m_bme280;
+    uint8_t             m_regs[256];
+    int32_t             m_rawTemp;
+    int32_t             m_rawPressure;
+    int32_t             m_rawHumidity;
+    uint32_t            m_numMeasurements;
+};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Filename: sim_gpio.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an in-memory simulated GPIO, driven by the
+ *              test or a device model in place of a real pin
+ */
+
+#ifndef EMBED_SIM_GPIO_H
+#define EMBED_SIM_GPIO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <map>
+
+#include "gpio.h"
+#include "trace.h"
+
+namespace embed
+{
+
+class SimGPIO : public GPIO
+{
+ public:
+    SimGPIO (const uint8_t _level = 0);
+    ~SimGPIO ();
+
+    bool init();
+    void destroy();
+
+    void setMode (const PIN_DIR _dir);
+    uint8_t digitalRead ();
+    void digitalWrite (const uint8_t _val);
+    void attachInterrupt (GPIOIntHandler _handler, INT_MODE _mode, void* _data = NULL);
+    void detachInterrupt (GPIOIntHandler _handler);
+
+    // Drives the pin from outside, as the device on the other end would.
+    // Interrupt handlers for a matching edge run in the calling thread, so
+    // callers must not hold locks the handlers take.
+    void setLevel (const uint8_t _level);
+
+    PIN_DIR getMode () {return m_pinDir;}
+
+    // Number of edges that ran the interrupt handlers
+    uint32_t getNumInterrupts () {return m_numInterrupts;}
+ private:
+    bool                                m_initialized;
+    PIN_DIR                             m_pinDir;
+    uint8_t                             m_level;
+    INT_MODE                            m_mode;
+    std::map<GPIOIntHandler,void*>      m_listeners;
+    // Levels and listeners are changed from both the model and user threads
+    pthread_mutex_t                     m_pinMutex;
+    uint32_t                            m_numInterrupts;
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Filename: sim_i2c.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for an in-memory simulated I2C bus that hosts
+ *              register-level device models
+ */
+
+#ifndef EMBED_SIM_I2C_H
+#define EMBED_SIM_I2C_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <map>
+
+#include "i2c.h"
+#include "trace.h"
+
+namespace embed
+{
+
+// Register-level model of a device on a simulated I2C bus
+class SimI2CDevice
+{
+ public:
+    virtual ~SimI2CDevice() {};
+
+    virtual uint8_t readReg (const uint8_t _reg) = 0;
+    virtual void writeReg (const uint8_t _reg, const uint8_t _val) = 0;
+
+    // Called at the start of every read transaction, devices that
+    // shadow their data registers during burst reads latch them here
+    virtual void beginRead () {}
+ private:
+};
+
+class SimI2C : public I2C
+{
+ public:
+    SimI2C ();
+    ~SimI2C ();
+
+    bool init();
+    void destroy();
+
+    // Attach a device model at a 7-bit address, the bus does not own it
+    void attachDevice (const uint8_t _addr, SimI2CDevice* _device);
+    void detachDevice (const uint8_t _addr);
+
+    uint8_t readReg (const uint8_t _addr, const uint8_t _reg);
+    void writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val);
+    void readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len);
+
+    // Number of bus transactions so far (a burst read counts once)
+    uint32_t getNumTransactions () {return m_numTransactions;}
+    void resetNumTransactions () {m_numTransactions = 0;}
+ private:
+    SimI2CDevice* findDevice (const uint8_t _addr, const char* _caller);
+
+    bool                                m_initialized;
+    std::map<uint8_t, SimI2CDevice*>    m_devices;
+    // Bus accesses come from both the interrupt and user threads
+    pthread_mutex_t                     m_busMutex;
+    uint32_t                            m_numTransactions;
+};
+
+}
+
+#endif
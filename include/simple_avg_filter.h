@@ -14,27 +14,137 @@
 #include <assert.h>
 #include <math.h>
 
-#include <list>
-
 #include "avg_filter.h"
+#include "reduce.h"
+#include "ring_buffer.h"
 
 namespace embed
 {
 
-template <class T> class SimpleAvgFilter : public AvgFilter<T>
+// The window lives in a preallocated ring buffer and the mean and sum of
+// squared differences are updated incrementally (Welford with removal).
+// Removals let rounding errors build up, so the moments are recomputed from
+// the buffer after every window's worth of removals, which keeps updates
+// amortised O(1) and allocation free. N fixes the window size at
+// compile time and keeps the window inline, otherwise it is given at run time.
+template <class T, uint32_t N = 0> class BasicSimpleAvgFilter : public AvgFilterBase<BasicSimpleAvgFilter<T, N>, T>
 {
  public:
-     SimpleAvgFilter(uint32_t _numSamples);
-     ~SimpleAvgFilter ();
+    BasicSimpleAvgFilter (uint32_t _numSamples = N) :
+        m_numSamples (_numSamples),
+        m_invNumSamples (1.0 / ((double) _numSamples)),
+        m_samples (_numSamples),
+        m_numRemoved (0),
+        m_mean (0.0),
+        m_m2 (0.0)
+    {
+        assert (m_numSamples > 0);
+    }
+
+    void reset ()
+    {
+        m_samples.clear();
+        m_numRemoved = 0;
+        m_mean = 0.0;
+        m_m2 = 0.0;
+    }
+
+    void addValue (T _val)
+    {
+        double val = (double) _val;
+
+        T evicted;
+        if (m_samples.push(_val, &evicted))
+        {
+            // Window still filling, plain Welford update
+            double delta = val - m_mean;
+            m_mean += delta / ((double) m_samples.size());
+            m_m2 += delta * (val - m_mean);
+        }
+        else
+        {
+            // Window full, replace the oldest sample in one step
+            double old = (double) evicted;
+            double prevMean = m_mean;
+            m_mean += (val - old) * m_invNumSamples;
+            m_m2 += (val - old) * ((val - m_mean) + (old - prevMean));
+
+            if (++m_numRemoved >= m_numSamples)
+            {
+                recompute();
+                return;
+            }
+        }
+
+        // Rounding can leave a tiny negative value for a constant input
+        if (m_m2 < 0.0)
+            m_m2 = 0.0;
+    }
+
+    void addValues (const T* _vals, size_t _num)
+    {
+        if (_num < m_numSamples)
+        {
+            for (size_t i = 0; i < _num; i++)
+                addValue(_vals[i]);
+            return;
+        }
+
+        // Only the last window survives, recompute it with two exact passes
+        const T* window = _vals + (_num - m_numSamples);
+        m_samples.assign(window, m_numSamples);
+        m_mean = reduceSum(window, m_numSamples) * m_invNumSamples;
+        m_m2 = reduceSumSqDiff(window, m_numSamples, m_mean);
+        m_numRemoved = 0;
+    }
+
+    double getAvg ()
+    {
+        if (m_samples.empty())
+            return nan("");
 
-     void reset();
-     void addValue (T _val);
-     double getAvg ();
-     double getStdDev ();
+        return m_mean;
+    }
+
+    double getStdDev ()
+    {
+        if (m_samples.empty())
+            return nan("");
+
+        return sqrt(m_m2 / ((double) m_samples.size()));
+    }
  private:
+    // Two passes over the full window
+    void recompute ()
+    {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < m_numSamples; i++)
+            sum += (double) m_samples[i];
+        m_mean = sum * m_invNumSamples;
+
+        double sqDiffSum = 0.0;
+        for (uint32_t i = 0; i < m_numSamples; i++)
+        {
+            double diff = ((double) m_samples[i]) - m_mean;
+            sqDiffSum += diff * diff;
+        }
+        m_m2 = sqDiffSum;
+
+        m_numRemoved = 0;
+    }
+
     uint32_t            m_numSamples;
-    std::list<T>        m_samples;
-    uint32_t            m_sampleCount;
+    double              m_invNumSamples;
+    RingBuffer<T, N>    m_samples;
+    uint32_t            m_numRemoved;
+    double              m_mean;
+    double              m_m2;
+};
+
+template <class T> class SimpleAvgFilter : public AvgFilterAdapter<BasicSimpleAvgFilter<T> >
+{
+ public:
+     SimpleAvgFilter(uint32_t _numSamples) : AvgFilterAdapter<BasicSimpleAvgFilter<T> > (_numSamples) {}
 };
 
 }
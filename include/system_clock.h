@@ -0,0 +1,41 @@
+/*
+ * Filename: system_clock.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for the clock backed by CLOCK_MONOTONIC
+ */
+
+#ifndef EMBED_SYSTEM_CLOCK_H
+#define EMBED_SYSTEM_CLOCK_H
+
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "clock.h"
+
+namespace embed
+{
+
+class SystemClock : public Clock
+{
+ public:
+    // Singleton, used by the drivers when no clock is given
+    static SystemClock* Instance();
+
+    uint64_t nowUs ();
+    void sleepUs (uint64_t _delayUs);
+    bool waitUntil (pthread_cond_t* _cond, pthread_mutex_t* _mutex, uint64_t _deadlineUs);
+ private:
+    // Private so they cannot be called
+    SystemClock() {};
+    SystemClock(SystemClock const&) {};
+    SystemClock& operator=(SystemClock const&);
+
+    static SystemClock* m_instance;
+};
+
+}
+
+#endif
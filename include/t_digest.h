@@ -0,0 +1,76 @@
+/*
+ * Filename: t_digest.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a merging t-digest, a streaming estimator
+ *              for arbitrary quantiles. Samples are buffered and
+ *              periodically merged into a sorted set of weighted centroids
+ *              that are small near the tails and large near the median, so
+ *              extreme quantiles stay accurate. Memory is fixed by the
+ *              compression at construction, and digests from several
+ *              sensors or threads can be merged centroid by centroid.
+ */
+
+#ifndef EMBED_T_DIGEST_H
+#define EMBED_T_DIGEST_H
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace embed
+{
+
+class TDigest
+{
+ public:
+    // Higher compression keeps more centroids, about _compression of them,
+    // and gives more accurate quantiles
+    TDigest (double _compression = 100.0);
+    ~TDigest ();
+
+    void reset ();
+    void addValue (double _val, double _weight = 1.0);
+    void merge (const TDigest& _other);
+
+    double getCount () const {return m_totalWeight;}
+    double getMin () const;
+    double getMax () const;
+
+    // _quantile is a fraction, 0.5 for the median or 0.99 for p99. Merges
+    // any buffered samples first.
+    double getQuantile (double _quantile);
+    uint32_t getNumCentroids ();
+ private:
+    typedef struct CentroidStruct
+    {
+        double              m_mean;
+        double              m_weight;
+
+        bool operator< (const CentroidStruct& _other) const {return m_mean < _other.m_mean;}
+    } Centroid;
+
+    void flush ();
+    double weightLimitAfter (double _weightBefore) const;
+
+    double                  m_compression;
+    uint32_t                m_maxCentroids;
+    uint32_t                m_bufferSize;
+
+    // Merged centroids sorted by mean, and samples not merged yet
+    std::vector<Centroid>   m_centroids;
+    uint32_t                m_numCentroids;
+    std::vector<Centroid>   m_buffer;
+    uint32_t                m_numBuffered;
+
+    // Centroids and buffer merged together before compressing
+    std::vector<Centroid>   m_scratch;
+
+    double                  m_totalWeight;
+    double                  m_min;
+    double                  m_max;
+};
+
+}
+
+#endif
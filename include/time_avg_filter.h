@@ -0,0 +1,256 @@
+/*
+ * Filename: time_avg_filter.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for moving average filters whose windows are
+ *              defined by time rather than sample count, so their results
+ *              are comparable when the sample rate changes. Samples are
+ *              given with a timestamp in microseconds, which must not go
+ *              backwards.
+ */
+
+#ifndef EMBED_TIME_AVG_FILTER_H
+#define EMBED_TIME_AVG_FILTER_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include <type_traits>
+
+#include "ring_buffer.h"
+
+namespace embed
+{
+
+// Average and standard deviation of the samples taken in the last
+// _windowUs. Samples are kept in a ring buffer with their timestamps and
+// evicted by age, with the mean and sum of squared differences updated
+// incrementally. Removals let rounding errors build up, so the moments are
+// recomputed from the buffer after every buffer's worth of removals, which
+// keeps updates amortised O(1) and allocation free. The buffer holds at
+// most _maxSamples, size it for the highest sample rate expected; past that
+// the oldest samples are evicted early. N fixes _maxSamples at compile time
+// and keeps the buffer inline.
+template <class T, uint32_t N = 0> class BasicTimeAvgFilter
+{
+    static_assert (std::is_arithmetic<T>::value, "TimeAvgFilter sample type must be arithmetic");
+ public:
+    typedef T ValueType;
+
+    BasicTimeAvgFilter (uint64_t _windowUs, uint32_t _maxSamples = N) :
+        m_windowUs (_windowUs),
+        m_samples (_maxSamples),
+        m_numRemoved (0),
+        m_mean (0.0),
+        m_m2 (0.0)
+    {
+        assert (_maxSamples > 0);
+    }
+
+    void reset ()
+    {
+        m_samples.clear();
+        m_numRemoved = 0;
+        m_mean = 0.0;
+        m_m2 = 0.0;
+    }
+
+    void addValue (uint64_t _timeUs, T _val)
+    {
+        expire(_timeUs);
+        if (m_samples.full())
+            remove(m_samples.popFront().m_val);
+
+        m_samples.push(Sample(_timeUs, _val));
+
+        double val = (double) _val;
+        double delta = val - m_mean;
+        m_mean += delta / ((double) m_samples.size());
+        m_m2 += delta * (val - m_mean);
+
+        if (m_numRemoved >= m_samples.capacity())
+            recompute();
+    }
+
+    void addValues (const uint64_t* _timesUs, const T* _vals, size_t _num)
+    {
+        for (size_t i = 0; i < _num; i++)
+            addValue(_timesUs[i], _vals[i]);
+    }
+
+    // Drops samples that are too old by _timeUs without adding one, for
+    // reading the filter when samples stop arriving
+    void expire (uint64_t _timeUs)
+    {
+        while (!m_samples.empty() && ((int64_t) (_timeUs - m_samples.front().m_timeUs)) >= (int64_t) m_windowUs)
+            remove(m_samples.popFront().m_val);
+    }
+
+    double getAvg ()
+    {
+        if (m_samples.empty())
+            return nan("");
+
+        return m_mean;
+    }
+
+    double getStdDev ()
+    {
+        if (m_samples.empty())
+            return nan("");
+
+        return sqrt(m_m2 / ((double) m_samples.size()));
+    }
+
+    uint32_t getNumSamples () const {return m_samples.size();}
+    uint64_t getWindowUs () const {return m_windowUs;}
+ private:
+    struct Sample
+    {
+        Sample () : m_timeUs (0), m_val () {}
+        Sample (uint64_t _timeUs, T _val) : m_timeUs (_timeUs), m_val (_val) {}
+
+        uint64_t    m_timeUs;
+        T           m_val;
+    };
+
+    // Welford update for a sample leaving the window, the sample has
+    // already been popped
+    void remove (T _val)
+    {
+        m_numRemoved++;
+
+        uint32_t num = m_samples.size();
+        if (num == 0)
+        {
+            m_mean = 0.0;
+            m_m2 = 0.0;
+            return;
+        }
+
+        double old = (double) _val;
+        double prevMean = m_mean;
+        m_mean -= (old - m_mean) / ((double) num);
+        m_m2 -= (old - prevMean) * (old - m_mean);
+
+        // Rounding can leave a tiny negative value for a constant input
+        if (m_m2 < 0.0)
+            m_m2 = 0.0;
+    }
+
+    // Two passes over the window
+    void recompute ()
+    {
+        uint32_t num = m_samples.size();
+
+        double sum = 0.0;
+        for (uint32_t i = 0; i < num; i++)
+            sum += (double) m_samples[i].m_val;
+        m_mean = sum / ((double) num);
+
+        double sqDiffSum = 0.0;
+        for (uint32_t i = 0; i < num; i++)
+        {
+            double diff = ((double) m_samples[i].m_val) - m_mean;
+            sqDiffSum += diff * diff;
+        }
+        m_m2 = sqDiffSum;
+
+        m_numRemoved = 0;
+    }
+
+    uint64_t                    m_windowUs;
+    RingBuffer<Sample, N>       m_samples;
+    uint32_t                    m_numRemoved;
+    double                      m_mean;
+    double                      m_m2;
+};
+
+// Exponential moving average with a time constant instead of a fixed
+// alpha. Each sample is weighted by 1 - exp(-dt / _timeConstantUs), where dt
+// is the time since the previous sample, so a sample covering a longer gap
+// counts for more and the response time does not depend on the sample
+// rate. The standard deviation is exponentially weighted the same way.
+template <class T> class BasicTimeExpAvgFilter
+{
+    static_assert (std::is_arithmetic<T>::value, "TimeExpAvgFilter sample type must be arithmetic");
+ public:
+    typedef T ValueType;
+
+    BasicTimeExpAvgFilter (uint64_t _timeConstantUs) :
+        m_timeConstantUs ((double) _timeConstantUs),
+        m_lastTimeUs (0),
+        m_numSamples (0),
+        m_sT (0.0),
+        m_variance (0.0)
+    {
+        assert (_timeConstantUs > 0);
+    }
+
+    void reset ()
+    {
+        m_lastTimeUs = 0;
+        m_numSamples = 0;
+        m_sT = 0.0;
+        m_variance = 0.0;
+    }
+
+    void addValue (uint64_t _timeUs, T _val)
+    {
+        double val = (double) _val;
+
+        if (m_numSamples == 0)
+        {
+            m_sT = val;
+            m_lastTimeUs = _timeUs;
+            m_numSamples = 1;
+            return;
+        }
+
+        // Samples at the same time (or out of order) carry no weight
+        int64_t dt = (int64_t) (_timeUs - m_lastTimeUs);
+        if (dt <= 0)
+            return;
+        m_lastTimeUs = _timeUs;
+
+        double alpha = 1.0 - exp(-((double) dt) / m_timeConstantUs);
+        double diff = val - m_sT;
+        double incr = alpha * diff;
+        m_sT += incr;
+        m_variance = (1.0 - alpha) * (m_variance + diff * incr);
+    }
+
+    void addValues (const uint64_t* _timesUs, const T* _vals, size_t _num)
+    {
+        for (size_t i = 0; i < _num; i++)
+            addValue(_timesUs[i], _vals[i]);
+    }
+
+    double getAvg ()
+    {
+        if (m_numSamples == 0)
+            return nan("");
+
+        return m_sT;
+    }
+
+    double getStdDev ()
+    {
+        if (m_numSamples == 0)
+            return nan("");
+
+        return sqrt(m_variance);
+    }
+ private:
+    double              m_timeConstantUs;
+    uint64_t            m_lastTimeUs;
+    uint32_t            m_numSamples;
+    double              m_sT;
+    double              m_variance;
+};
+
+}
+
+#endif
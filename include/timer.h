@@ -0,0 +1,35 @@
+/*
+ * Filename: timer.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for one-shot timer generic interface class
+ */
+
+#ifndef EMBED_TIMER_H
+#define EMBED_TIMER_H
+
+#include <stdint.h>
+
+namespace embed
+{
+
+// Timer Interface Class
+class Timer
+{
+ public:
+    virtual ~Timer() {};
+
+    typedef void (*TimerHandler) (void*);
+
+    // Calls _handler once after _delayUs. A timer is identified by its
+    // handler and data, scheduling it again moves its deadline.
+    virtual void schedule (uint64_t _delayUs, TimerHandler _handler, void* _data = NULL) = 0;
+
+    // Removes a pending timer, waiting for it to finish if it is running
+    virtual void cancel (TimerHandler _handler, void* _data = NULL) = 0;
+ private:
+};
+
+}
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * Filename: timer_thread.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a thread that runs one-shot timers against
+ *              the monotonic clock
+ */
+
+#ifndef EMBED_TIMER_THREAD_H
+#define EMBED_TIMER_THREAD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+
+#include "timer.h"
+#include "trace.h"
+
+namespace embed
+{
+
+class TimerThread : public Timer
+{
+ public:
+    TimerThread();
+    ~TimerThread();
+
+    bool start();
+    void end();
+
+    void schedule (uint64_t _delayUs, TimerHandler _handler, void* _data = NULL);
+    void cancel (TimerHandler _handler, void* _data = NULL);
+ private:
+    static void* threadMain(void* _data);
+    static uint64_t nowUs();
+
+    typedef struct TimerInfoStruct
+    {
+        uint64_t            m_deadlineUs;
+        TimerHandler        m_handler;
+        void*               m_data;
+    } TimerInfo;
+
+    bool                                            m_started;
+    bool                                            m_exit;
+    pthread_t                                       m_thread;
+    // Pending timers, sorted by deadline
+    std::vector<TimerInfo>                          m_timers;
+    // Timer being run by the thread, if any
+    TimerHandler                                    m_runningHandler;
+    void*                                           m_runningData;
+    pthread_mutex_t                                 m_mutexTimers;
+    pthread_cond_t                                  m_condTimers;
+};
+
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * Filename: trace.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for lightweight event tracing. Tracepoints
+ *              record into per-thread ring buffers without locking and the
+ *              buffers are exported as Chrome trace event JSON, which
+ *              chrome://tracing and Perfetto show as a timeline. The
+ *              tracepoint macros compile to nothing unless EMBED_TRACE is
+ *              defined, and cost a load and a branch while tracing is
+ *              disabled at run time.
+ */
+
+#ifndef EMBED_TRACE_H
+#define EMBED_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <vector>
+
+namespace embed
+{
+
+// Event names and categories must be string literals (or otherwise live
+// as long as the process), only the pointers are recorded
+typedef enum TRACE_EVENT_TYPE_ENUM
+{
+    TRACE_COMPLETE = 0,                     // A span with a duration
+    TRACE_INSTANT,                          // A point in time
+    TRACE_COUNTER,                          // A value over time
+    TRACE_EVENT_TYPE_NUM
+} TRACE_EVENT_TYPE;
+
+typedef struct TraceEventStruct
+{
+    uint64_t            m_startNs;
+    uint64_t            m_durationNs;
+    const char*         m_name;
+    const char*         m_category;
+    uint64_t            m_arg;
+    uint32_t            m_type;
+} TraceEvent;
+
+static_assert (sizeof(TraceEvent) % sizeof(uint64_t) == 0, "TraceEvent must be a whole number of words");
+
+// The events of one thread, written only by that thread. Once full the
+// oldest events are overwritten, so a trace always holds the most recent
+// activity. Buffers outlive their threads so their events can still be
+// exported.
+class TraceBuffer
+{
+ public:
+    TraceBuffer (const uint32_t _capacity, const pid_t _tid, const char* _name);
+    ~TraceBuffer ();
+
+    void record (const TRACE_EVENT_TYPE _type, const char* _category, const char* _name,
+                 const uint64_t _startNs, const uint64_t _durationNs, const uint64_t _arg)
+    {
+        TraceEvent event;
+        event.m_startNs = _startNs;
+        event.m_durationNs = _durationNs;
+        event.m_name = _name;
+        event.m_category = _category;
+        event.m_arg = _arg;
+        event.m_type = _type;
+        uint64_t words[SLOT_WORDS];
+        memcpy (words, &event, sizeof(event));
+
+        // Each slot is a seqlock, its sequence is zero while it is written
+        // and the event's position plus one once it is complete
+        uint64_t head = m_head;
+        Slot& slot = m_slots[head & m_mask];
+        __atomic_store_n (&slot.m_seq, 0, __ATOMIC_RELAXED);
+        __atomic_thread_fence (__ATOMIC_RELEASE);
+        for (uint32_t i = 0; i < SLOT_WORDS; i++)
+            __atomic_store_n (&slot.m_words[i], words[i], __ATOMIC_RELAXED);
+        __atomic_store_n (&slot.m_seq, head + 1, __ATOMIC_RELEASE);
+        __atomic_store_n (&m_head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    // Copies out the events currently held, oldest first, leaving out any
+    // the owning thread overwrote during the copy
+    void snapshot (std::vector<TraceEvent>* _events);
+    void clear ();
+
+    void setName (const char* _name) {m_name = _name;}
+    const char* getName () {return m_name;}
+    pid_t getTid () {return m_tid;}
+    uint32_t getCapacity () {return m_mask + 1;}
+    uint64_t getNumRecorded () {return __atomic_load_n (&m_head, __ATOMIC_ACQUIRE);}
+    uint64_t getNumOverwritten ();
+ private:
+    static const uint32_t SLOT_WORDS = sizeof(TraceEvent) / sizeof(uint64_t);
+
+    typedef struct SlotStruct
+    {
+        uint64_t        m_seq;
+        // The event as words, so the racing copies are atomic accesses
+        uint64_t        m_words[SLOT_WORDS];
+    } Slot;
+
+    Slot*               m_slots;
+    uint64_t            m_mask;
+    uint64_t            m_head;
+    pid_t               m_tid;
+    const char*         m_name;
+};
+
+// Process wide tracing state. Threads get a buffer on their first event
+// while enabled, sized by setEventsPerThread() at that time (rounded up to
+// a power of two).
+class Trace
+{
+ public:
+    static const uint32_t DEFAULT_EVENTS_PER_THREAD = 16384;
+
+    static void enable () {__atomic_store_n (&s_enabled, true, __ATOMIC_RELEASE);}
+    static void disable () {__atomic_store_n (&s_enabled, false, __ATOMIC_RELEASE);}
+    static bool isEnabled () {return __atomic_load_n (&s_enabled, __ATOMIC_RELAXED);}
+
+    static void setEventsPerThread (const uint32_t _numEvents);
+
+    // Names the calling thread in exported traces, the name must be a
+    // string literal like the event names
+    static void setThreadName (const char* _name);
+
+    static uint64_t nowNs ()
+    {
+        struct timespec ts;
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        return ((uint64_t) ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    static void record (const TRACE_EVENT_TYPE _type, const char* _category, const char* _name,
+                        const uint64_t _startNs, const uint64_t _durationNs, const uint64_t _arg)
+    {
+        TraceBuffer* buffer = s_buffer;
+        if (buffer == NULL && (buffer = createBuffer()) == NULL)
+            return;
+
+        buffer->record (_type, _category, _name, _startNs, _durationNs, _arg);
+    }
+
+    static void instant (const char* _category, const char* _name, const uint64_t _arg = 0)
+    {
+        record (TRACE_INSTANT, _category, _name, nowNs(), 0, _arg);
+    }
+
+    static void counter (const char* _category, const char* _name, const uint64_t _value)
+    {
+        record (TRACE_COUNTER, _category, _name, nowNs(), 0, _value);
+    }
+
+    // Totals over every thread's buffer
+    static uint64_t getNumRecorded ();
+    static uint64_t getNumOverwritten ();
+    static uint32_t getNumThreads ();
+
+    // Drops the recorded events, call with tracing disabled
+    static void clear ();
+
+    // Writes every thread's events as Chrome trace event JSON. Tracing can
+    // be running, events recorded during the export may be left out.
+    static bool writeChromeJson (const char* _path);
+ private:
+    static TraceBuffer* createBuffer ();
+
+    static bool                         s_enabled;
+    static uint32_t                     s_eventsPerThread;
+    static __thread TraceBuffer*        s_buffer;
+    static __thread const char*         s_threadName;
+    static std::vector<TraceBuffer*>    s_buffers;
+    static pthread_mutex_t              s_buffersMutex;
+};
+
+// Records the time from construction to destruction as a complete event
+class TraceScope
+{
+ public:
+    TraceScope (const char* _category, const char* _name, const uint64_t _arg = 0) :
+        m_category (_category),
+        m_name (_name),
+        m_arg (_arg),
+        m_startNs (Trace::isEnabled() ? Trace::nowNs() : 0)
+    {
+    }
+
+    ~TraceScope ()
+    {
+        if (m_startNs != 0)
+            Trace::record (TRACE_COMPLETE, m_category, m_name, m_startNs, Trace::nowNs() - m_startNs, m_arg);
+    }
+ private:
+    const char*         m_category;
+    const char*         m_name;
+    uint64_t            m_arg;
+    uint64_t            m_startNs;
+};
+
+}
+
+#define EMBED_TRACE_CONCAT_INNER(a, b) a ## b
+#define EMBED_TRACE_CONCAT(a, b) EMBED_TRACE_CONCAT_INNER(a, b)
+
+#ifdef EMBED_TRACE
+
+// Traces the rest of the enclosing scope, _arg is shown with the event
+#define EMBED_TRACE_SCOPE(_category, _name, _arg) \
+    embed::TraceScope EMBED_TRACE_CONCAT(embedTraceScope, __LINE__) (_category, _name, _arg)
+
+#define EMBED_TRACE_INSTANT(_category, _name, _arg) \
+    do { if (embed::Trace::isEnabled()) embed::Trace::instant (_category, _name, _arg); } while (0)
+
+#define EMBED_TRACE_COUNTER(_category, _name, _value) \
+    do { if (embed::Trace::isEnabled()) embed::Trace::counter (_category, _name, _value); } while (0)
+
+#define EMBED_TRACE_THREAD_NAME(_name) \
+    embed::Trace::setThreadName (_name)
+
+#else
+
+#define EMBED_TRACE_SCOPE(_category, _name, _arg) do {} while (0)
+#define EMBED_TRACE_INSTANT(_category, _name, _arg) do {} while (0)
+#define EMBED_TRACE_COUNTER(_category, _name, _value) do {} while (0)
+#define EMBED_TRACE_THREAD_NAME(_name) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Filename: varint.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for LEB128 variable length integer encoding,
+ *              seven bits per byte with the high bit set on every byte but
+ *              the last, so small values such as time deltas take a single
+ *              byte. Signed values are zigzag mapped first so small negative
+ *              values stay small.
+ */
+
+#ifndef EMBED_VARINT_H
+#define EMBED_VARINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace embed
+{
+
+// Longest encoding of a 64-bit value
+static const uint32_t VARINT_MAX_BYTES = 10;
+
+// Writes _val to _buf, which must have VARINT_MAX_BYTES free, and returns
+// the number of bytes written
+inline uint32_t encodeVarint (uint64_t _val, uint8_t* _buf)
+{
+    uint32_t num = 0;
+    while (_val >= 0x80)
+    {
+        _buf[num++] = (uint8_t) (_val | 0x80);
+        _val >>= 7;
+    }
+    _buf[num++] = (uint8_t) _val;
+
+    return num;
+}
+
+// Reads a value from _buf, advancing it. Returns false, leaving _buf
+// alone, if the encoding runs past _end or is too long.
+inline bool decodeVarint (const uint8_t*& _buf, const uint8_t* _end, uint64_t* _val)
+{
+    uint64_t val = 0;
+    const uint8_t* p = _buf;
+    for (uint32_t shift = 0; shift < 7 * VARINT_MAX_BYTES && p < _end; shift += 7)
+    {
+        uint8_t byte = *p++;
+        val |= ((uint64_t) (byte & 0x7F)) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            (*_val) = val;
+            _buf = p;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Maps signed values to unsigned ones with the sign in the low bit,
+// 0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ...
+inline uint64_t zigzagEncode (int64_t _val)
+{
+    return (((uint64_t) _val) << 1) ^ ((uint64_t) (_val >> 63));
+}
+
+inline int64_t zigzagDecode (uint64_t _val)
+{
+    return ((int64_t) (_val >> 1)) ^ -((int64_t) (_val & 1));
+}
+
+}
+
+#endif
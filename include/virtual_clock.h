@@ -0,0 +1,77 @@
+/*
+ * Filename: virtual_clock.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for a deterministic virtual time clock and
+ *              timer, so simulated runs go as fast as the host can
+ *              execute them instead of in real time
+ */
+
+#ifndef EMBED_VIRTUAL_CLOCK_H
+#define EMBED_VIRTUAL_CLOCK_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <vector>
+
+#include "clock.h"
+#include "timer.h"
+
+namespace embed
+{
+
+// Time only moves when a thread sleeps or waits on the clock. Sleeping
+// jumps straight to each timer deadline on the way, running its handler
+// in the sleeping thread, then to the end of the sleep, so a run takes
+// as long as its handlers do rather than as long as its timers. Handlers
+// run in deadline order, and in scheduling order for equal deadlines, so
+// runs are repeatable. Handlers may schedule, cancel and sleep.
+//
+// Every event has to come from a timer: a wait with nothing scheduled
+// before its deadline times out at once, it does not wait for other
+// threads. Drive a simulation from one thread at a time.
+class VirtualClock : public Clock, public Timer
+{
+ public:
+    VirtualClock (uint64_t _startUs = 0);
+    ~VirtualClock ();
+
+    uint64_t nowUs ();
+    void sleepUs (uint64_t _delayUs);
+    bool waitUntil (pthread_cond_t* _cond, pthread_mutex_t* _mutex, uint64_t _deadlineUs);
+
+    void schedule (uint64_t _delayUs, TimerHandler _handler, void* _data = NULL);
+    void cancel (TimerHandler _handler, void* _data = NULL);
+
+    // Runs every timer due by _timeUs, leaving the clock there
+    void advanceTo (uint64_t _timeUs);
+
+    uint32_t getNumPending ();
+    uint64_t getNumTimersRun () {return m_numTimersRun;}
+ private:
+    typedef struct TimerInfoStruct
+    {
+        uint64_t            m_deadlineUs;
+        TimerHandler        m_handler;
+        void*               m_data;
+    } TimerInfo;
+
+    // Runs the first timer due by _timeUs, returns false if there is none
+    bool runNext (uint64_t _timeUs);
+
+    uint64_t                                        m_nowUs;
+    // Pending timers, sorted by deadline
+    std::vector<TimerInfo>                          m_timers;
+    // Timer being run, if any, and the thread running it
+    TimerHandler                                    m_runningHandler;
+    void*                                           m_runningData;
+    pthread_t                                       m_runningThread;
+    uint64_t                                        m_numTimersRun;
+    pthread_mutex_t                                 m_mutexTimers;
+    pthread_cond_t                                  m_condTimers;
+};
+
+}
+
+#endif
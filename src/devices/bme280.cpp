@@ -0,0 +1,88 @@
+/*
+ * Filename: bme280.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for BME280 device class
+ */
+
+#include "bme280.h"
+
+using namespace embed;
+
+const double BME280::STANDBY_TIME_BME[STANDBY_NUM] = {0.5, 62.5, 125.0, 250.0, 500.0, 1000.0, 10.0, 20.0};
+
+BME280::BME280 (I2C* _bus, const uint8_t _address, Timer* _timer, Clock* _clock) :
+    BMP280 (_bus, _address, _timer, _clock),
+    m_H1 (0),
+    m_H2 (0),
+    m_H3 (0),
+    m_H4 (0),
+    m_H5 (0),
+    m_H6 (0),
+    m_humidityOsrs (OVERSAMPLING_X1)
+{
+}
+
+BME280::~BME280 ()
+{
+}
+
+double BME280::getMeasurementTime ()
+{
+    double timeMs = BMP280::getMeasurementTime();
+    if (m_humidityOsrs != OVERSAMPLING_SKIP)
+        timeMs += 2.3 * OVERSAMPLING_SAMPLES[m_humidityOsrs] + 0.575;
+
+    return timeMs;
+}
+
+void BME280::calcHumidity (const int32_t _rawTemp, const int32_t _rawHumidity, double* _humidityPct)
+{
+    int32_t tFine;
+    compensateTemp (_rawTemp, &tFine);
+
+    // Q22.10 %RH
+    (*_humidityPct) = ((double) compensateHumidity (_rawHumidity, tFine)) / 1024.0;
+}
+
+void BME280::readDeviceParams ()
+{
+    BMP280::readDeviceParams();
+
+    m_H1 = readReg (CALIB_H1_REG);
+
+    // H4 and H5 share the nibbles of 0xE5
+    uint8_t buf[CALIB_H2_LEN];
+    readRegs (CALIB_H2_REG, buf, CALIB_H2_LEN);
+    m_H2 = (buf[1] << 8) | buf[0];
+    m_H3 = buf[2];
+    m_H4 = (((int8_t) buf[3]) << 4) | (buf[4] & 0x0F);
+    m_H5 = (((int8_t) buf[5]) << 4) | (buf[4] >> 4);
+    m_H6 = (int8_t) buf[6];
+}
+
+void BME280::writeConfig (const uint8_t _mode)
+{
+    // Humidity setting only takes effect after the following ctrl_meas write
+    writeReg (CTRL_HUM_REG, m_humidityOsrs);
+    BMP280::writeConfig (_mode);
+}
+
+int32_t BME280::parseHumidity (const uint8_t* _data)
+{
+    return (_data[6] << 8) | _data[7];
+}
+
+uint32_t BME280::compensateHumidity (const int32_t _rawHumidity, const int32_t _tFine)
+{
+    int32_t v = (_tFine - ((int32_t) 76800));
+    v = (((((_rawHumidity << 14) - (((int32_t) m_H4) << 20) - (((int32_t) m_H5) * v)) +
+           ((int32_t) 16384)) >> 15) *
+         (((((((v * ((int32_t) m_H6)) >> 10) * (((v * ((int32_t) m_H3)) >> 11) + ((int32_t) 32768))) >> 10) +
+            ((int32_t) 2097152)) * ((int32_t) m_H2) + 8192) >> 14));
+    v = (v - (((((v >> 15) * (v >> 15)) >> 7) * ((int32_t) m_H1)) >> 4));
+    v = (v < 0 ? 0 : v);
+    v = (v > 419430400 ? 419430400 : v);
+
+    return (uint32_t) (v >> 12);
+}
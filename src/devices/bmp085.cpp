@@ -9,10 +9,12 @@
 
 using namespace embed;
 
+const double BMP085::TEMP_CONVERSION_TIME = 4.5;
 const double BMP085::OSSR_CONVERSION_TIME[OSSR_NUM] = {4.5, 7.5, 13.5, 25.5};
 const double BMP085::PRESSURE_SEA_LEVEL_HPA = 1013.25;
+const double BMP085::STALL_TIMEOUT_FACTOR = 2.0;
 
-BMP085::BMP085 (I2C* _bus, GPIO* _eoc, GPIO* _xclr) :
+BMP085::BMP085 (I2C* _bus, GPIO* _eoc, GPIO* _xclr, Timer* _timer, Clock* _clock) :
     m_initialized (false),
     m_AC1 (0),
     m_AC2 (0),
@@ -27,18 +29,60 @@ BMP085::BMP085 (I2C* _bus, GPIO* _eoc, GPIO* _xclr) :
     m_MD (0),
     m_bus (_bus),
     m_ossr (OSSR_STANDARD),
+    m_convOssr (OSSR_STANDARD),
+    m_sampleOssr (OSSR_STANDARD),
     m_state (WAIT_TEMP_CONVERSION),
     m_async (false),
     m_rawTempAsync (0),
+    m_stateMutex (),
+    m_timer (_timer),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_convStartUs (0),
+    m_convTimeoutUs (0),
+    m_stallsRecovered (0),
+    m_syncWait (_eoc != NULL ? SYNC_WAIT_POLL : SYNC_WAIT_SLEEP),
+    m_syncEoc (false),
+    m_syncMutex (),
+    m_syncCond (),
+    m_syncTimeouts (0),
     m_eoc (_eoc),
     m_xclr (_xclr),
-    m_listeners()
+    m_listeners(),
+    m_dispatching (false),
+    m_unregistered (),
+    m_timingEnabled (false),
+    m_timingMutex (),
+    m_timing (),
+    m_lastTiming (),
+    m_timingHist (),
+    m_pressureConvHist ()
 {
+    pthread_mutex_init (&m_timingMutex, NULL);
+    pthread_mutex_init (&m_syncMutex, NULL);
+
+    // Recursive so listeners can call back into the device, which is why
+    // unregistering during dispatch is deferred
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init (&mutexAttr);
+    pthread_mutexattr_settype (&mutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&m_stateMutex, &mutexAttr);
+    pthread_mutexattr_destroy (&mutexAttr);
+
+    // Wait on the monotonic clock so timeouts are not affected by time changes
+    pthread_condattr_t condAttr;
+    pthread_condattr_init (&condAttr);
+    pthread_condattr_setclock (&condAttr, CLOCK_MONOTONIC);
+    pthread_cond_init (&m_syncCond, &condAttr);
+    pthread_condattr_destroy (&condAttr);
 }
 
 BMP085::~BMP085 ()
 {
     m_listeners.clear();
+    pthread_mutex_destroy (&m_timingMutex);
+    pthread_mutex_destroy (&m_syncMutex);
+    pthread_cond_destroy (&m_syncCond);
+    pthread_mutex_destroy (&m_stateMutex);
 }
 
 bool BMP085::init (bool _async)
@@ -58,7 +102,7 @@ bool BMP085::init (bool _async)
         m_xclr->digitalWrite(1);
         // Wait for device to come out of reset
         // (This was causing erroneous values without it)
-        usleep(1000);
+        m_clock->sleepUs(1000);
     }
 
     readDeviceParams();
@@ -72,6 +116,13 @@ bool BMP085::init (bool _async)
         m_eoc->attachInterrupt(eocIntHandler, GPIO::RISING, this);
         // Kick off first temperature reading
         writeReg (CTRL_REG, TEMPERATURE);
+        m_timing.m_tempStartUs = m_timingEnabled ? nowUs() : 0;
+        startStallTimer (TEMP_CONVERSION_TIME);
+    }
+    else if (m_syncWait == SYNC_WAIT_INTERRUPT)
+    {
+        // Setup interrupt on EOC pin to wake synchronous reads
+        m_eoc->attachInterrupt(eocSyncIntHandler, GPIO::RISING, this);
     }
 
     m_initialized = true;
@@ -84,41 +135,79 @@ void BMP085::destroy ()
     if (!m_initialized)
         return;
 
-    // If async mode, need to detach interrupt
-    if (m_async)
+    // If async mode, need to detach interrupt and stop the stall timer.
+    // Cleared first under the state lock so a handler already running can
+    // not step the state machine or re-arm the timer once it is cancelled.
+    pthread_mutex_lock (&m_stateMutex);
+    bool async = m_async;
+    m_async = false;
+    pthread_mutex_unlock (&m_stateMutex);
+
+    if (async)
     {
         m_eoc->detachInterrupt(eocIntHandler);
-        m_async = false;
+        if (m_timer != NULL)
+            m_timer->cancel(stallTimerHandler, this);
     }
+    else if (m_syncWait == SYNC_WAIT_INTERRUPT)
+        m_eoc->detachInterrupt(eocSyncIntHandler);
 
     if (m_xclr != NULL)
         m_xclr->digitalWrite(0);
 
     m_listeners.clear();
+    m_unregistered.clear();
 
     m_initialized = false;
 }
 
 void BMP085::reset ()
 {
-    if (m_async)
-        m_eoc->detachInterrupt(eocIntHandler);
+    // Keep the EOC handler and the stall timer from running the state
+    // machine mid reset, the interrupt stays attached so no edge is lost
+    pthread_mutex_lock (&m_stateMutex);
 
     if (m_xclr != NULL)
     {
         // Active low reset
         m_xclr->digitalWrite(0);
         // Requires 1us pulse
-        usleep(1);
+        m_clock->sleepUs(1);
         m_xclr->digitalWrite(1);
         // Wait for device to come out of reset
-        usleep(1000);
+        m_clock->sleepUs(1000);
     }
 
     readDeviceParams();
 
-    if (m_async)
-        m_eoc->attachInterrupt(eocIntHandler, GPIO::RISING, this);
+    // A reset through XCLR aborts the conversion in flight, so start the
+    // cycle again rather than wait for the stall timer
+    if (m_async && m_xclr != NULL)
+    {
+        writeReg (CTRL_REG, TEMPERATURE);
+        startStallTimer (TEMP_CONVERSION_TIME);
+        m_timing.m_tempStartUs = m_timingEnabled ? nowUs() : 0;
+        m_state = WAIT_TEMP_CONVERSION;
+    }
+
+    pthread_mutex_unlock (&m_stateMutex);
+}
+
+void BMP085::setSyncWaitMode (SYNC_WAIT _syncWait)
+{
+    if (m_initialized)
+    {
+        fprintf(stderr, "BMP085::setSyncWaitMode called after init\n");
+        return;
+    }
+
+    if (_syncWait != SYNC_WAIT_SLEEP && m_eoc == NULL)
+    {
+        fprintf(stderr, "BMP085::setSyncWaitMode called specifying EOC wait without a valid EOC GPIO\n");
+        return;
+    }
+
+    m_syncWait = _syncWait;
 }
 
 int16_t BMP085::readRawTempSync ()
@@ -126,11 +215,19 @@ int16_t BMP085::readRawTempSync ()
     if (m_async)
         return 0;
 
+    startConversionWait();
     writeReg (CTRL_REG, TEMPERATURE);
+    uint64_t convStartUs = m_timingEnabled ? nowUs() : 0;
 
-    usleep (4500);
+    uint64_t startUs;
+    if (waitConversion (TEMP_CONVERSION_TIME, &startUs) && m_timingEnabled)
+        recordTiming (TIMING_TEMP_CONVERSION, convStartUs, startUs);
 
-    return ((readReg (VALUE_MSB_REG) << 8) | readReg (VALUE_LSB_REG));
+    int16_t temp = ((readReg (VALUE_MSB_REG) << 8) | readReg (VALUE_LSB_REG));
+    if (m_timingEnabled)
+        recordTiming (TIMING_READOUT, startUs, nowUs());
+
+    return temp;
 }
 
 int32_t BMP085::readRawPressureSync ()
@@ -138,11 +235,26 @@ int32_t BMP085::readRawPressureSync ()
     if (m_async)
         return 0;
 
-    writeReg (CTRL_REG, PRESSURE_OSRS0 | (m_ossr << 6));
+    OSSR_SETTING ossr = m_ossr;
+    startConversionWait();
+    writeReg (CTRL_REG, PRESSURE_OSRS0 | (ossr << 6));
+    uint64_t convStartUs = m_timingEnabled ? nowUs() : 0;
+
+    uint64_t startUs;
+    if (waitConversion (OSSR_CONVERSION_TIME[ossr], &startUs) && m_timingEnabled)
+    {
+        pthread_mutex_lock (&m_timingMutex);
+        m_pressureConvHist[ossr].addValue(startUs - convStartUs);
+        pthread_mutex_unlock (&m_timingMutex);
+    }
 
-    usleep (OSSR_CONVERSION_TIME[m_ossr] * 1000.0);
+    int32_t pressure = (((readReg (VALUE_MSB_REG) << 16) | (readReg (VALUE_LSB_REG) << 8) |
+                         readReg (VALUE_XLSB_REG)) >> (8 - ossr));
+    if (m_timingEnabled)
+        recordTiming (TIMING_READOUT, startUs, nowUs());
 
-    return (((readReg (VALUE_MSB_REG) << 16) | (readReg (VALUE_LSB_REG) << 8) | readReg (VALUE_XLSB_REG)) >> (8 - m_ossr));
+    m_sampleOssr = ossr;
+    return pressure;
 }
 
 void BMP085::registerListener (EOCIntHandler _handler, void* _data)
@@ -153,11 +265,21 @@ void BMP085::registerListener (EOCIntHandler _handler, void* _data)
         return;
     }
 
-    // Stop interrupts in case they happen in a different thread
-    // and a std::map is not thread safe
-    m_eoc->detachInterrupt (eocIntHandler);
+    // Lock out the state machine in case interrupts happen in a different
+    // thread and a std::map is not thread safe (detaching the interrupt
+    // instead could lose an EOC edge). The interrupt is attached by
+    // init(true), listeners only get samples in async mode.
+    pthread_mutex_lock (&m_stateMutex);
     m_listeners[_handler] = _data;
-    m_eoc->attachInterrupt (eocIntHandler, GPIO::RISING, this);
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+        {
+            m_unregistered.erase(m_unregistered.begin() + i);
+            break;
+        }
+    }
+    pthread_mutex_unlock (&m_stateMutex);
 }
 
 void BMP085::unregisterListener (EOCIntHandler _handler)
@@ -168,22 +290,103 @@ void BMP085::unregisterListener (EOCIntHandler _handler)
         return;
     }
 
-    // Stop interrupts in case they happen in a different thread
-    // and a std::map is not thread safe
-    m_eoc->detachInterrupt (eocIntHandler);
-    std::map<EOCIntHandler,void*>::iterator it;
-    for (it = m_listeners.begin(); it != m_listeners.end(); it++)
+    // Lock out the state machine in case interrupts happen in a different
+    // thread and a std::map is not thread safe. A listener unregistering
+    // during dispatch holds the lock already, erasing then would pull the
+    // map out from under the dispatch loop.
+    pthread_mutex_lock (&m_stateMutex);
+    std::map<EOCIntHandler,void*>::iterator it = m_listeners.find(_handler);
+    if (it != m_listeners.end())
     {
-        if (it->first == _handler)
-            break;
+        if (m_dispatching)
+            m_unregistered.push_back(_handler);
+        else
+            m_listeners.erase(it);
     }
-    if (it != m_listeners.end())
-        m_listeners.erase(it);
-    m_eoc->attachInterrupt (eocIntHandler, GPIO::RISING, this);
+    pthread_mutex_unlock (&m_stateMutex);
+}
+
+void BMP085::resetTiming ()
+{
+    pthread_mutex_lock (&m_timingMutex);
+
+    for (int32_t i = 0; i < TIMING_STAT_NUM; i++)
+        m_timingHist[i].reset();
+    for (int32_t i = 0; i < OSSR_NUM; i++)
+        m_pressureConvHist[i].reset();
+    memset (&m_lastTiming, 0, sizeof(m_lastTiming));
+
+    pthread_mutex_unlock (&m_timingMutex);
+}
+
+void BMP085::getTimingStats (TIMING_STAT _stat, LatencyHistogram::Summary* _summary, OSSR_SETTING _ossr)
+{
+    pthread_mutex_lock (&m_timingMutex);
+
+    if (_stat == TIMING_PRESSURE_CONVERSION && _ossr < OSSR_NUM)
+        m_pressureConvHist[_ossr].getSummary(_summary);
+    else if (_stat == TIMING_PRESSURE_CONVERSION)
+    {
+        LatencyHistogram merged;
+        for (int32_t i = 0; i < OSSR_NUM; i++)
+            merged.merge(m_pressureConvHist[i]);
+        merged.getSummary(_summary);
+    }
+    else if (_stat >= 0 && _stat < TIMING_STAT_NUM)
+        m_timingHist[_stat].getSummary(_summary);
+    else
+        memset (_summary, 0, sizeof(*_summary));
+
+    pthread_mutex_unlock (&m_timingMutex);
+}
+
+void BMP085::getLastSampleTiming (SampleTiming* _timing)
+{
+    pthread_mutex_lock (&m_timingMutex);
+
+    (*_timing) = m_lastTiming;
+
+    pthread_mutex_unlock (&m_timingMutex);
+}
+
+void BMP085::getCalibration (Calibration* _calibration)
+{
+    _calibration->m_AC1 = m_AC1;
+    _calibration->m_AC2 = m_AC2;
+    _calibration->m_AC3 = m_AC3;
+    _calibration->m_AC4 = m_AC4;
+    _calibration->m_AC5 = m_AC5;
+    _calibration->m_AC6 = m_AC6;
+    _calibration->m_B1 = m_B1;
+    _calibration->m_B2 = m_B2;
+    _calibration->m_MB = m_MB;
+    _calibration->m_MC = m_MC;
+    _calibration->m_MD = m_MD;
+}
+
+void BMP085::setCalibration (const Calibration& _calibration)
+{
+    m_AC1 = _calibration.m_AC1;
+    m_AC2 = _calibration.m_AC2;
+    m_AC3 = _calibration.m_AC3;
+    m_AC4 = _calibration.m_AC4;
+    m_AC5 = _calibration.m_AC5;
+    m_AC6 = _calibration.m_AC6;
+    m_B1 = _calibration.m_B1;
+    m_B2 = _calibration.m_B2;
+    m_MB = _calibration.m_MB;
+    m_MC = _calibration.m_MC;
+    m_MD = _calibration.m_MD;
 }
 
 void BMP085::calcTempPressure (const int16_t _rawTemp, const int32_t _rawPressure,
                                double* _tempC, double* _pressurehPa)
+{
+    calcTempPressure (_rawTemp, _rawPressure, m_ossr, _tempC, _pressurehPa);
+}
+
+void BMP085::calcTempPressure (const int16_t _rawTemp, const int32_t _rawPressure,
+                               const OSSR_SETTING _ossr, double* _tempC, double* _pressurehPa)
 {
     int32_t X1 = (((int32_t) _rawTemp - (int32_t) m_AC6) * (int32_t) m_AC5) >> 15;
     int32_t X2 = ((int32_t) m_MC << 11) / (X1 + m_MD);
@@ -195,12 +398,12 @@ void BMP085::calcTempPressure (const int16_t _rawTemp, const int32_t _rawPressur
     X1 = (m_B2 * (B6 * B6 >> 12)) >> 11;
     X2 = (m_AC2 * B6) >> 11;
     int32_t X3 = X1 + X2;
-    int32_t B3 = (((((int32_t) m_AC1) * 4 + X3) << m_ossr) + 2) >> 2;
+    int32_t B3 = (((((int32_t) m_AC1) * 4 + X3) << _ossr) + 2) >> 2;
     X1 = (m_AC3 * B6) >> 13;
     X2 = (m_B1 * ((B6 * B6) >> 12)) >> 16;
     X3 = ((X1 + X2) + 2) >> 2;
     uint32_t B4 = (m_AC4 * (uint32_t)(X3 + 32768)) >> 15;
-    uint32_t B7 = ((uint32_t)(_rawPressure - B3) * (50000 >> m_ossr));
+    uint32_t B7 = ((uint32_t)(_rawPressure - B3) * (50000 >> _ossr));
     int32_t p;
     if (B7 < 0x80000000)
         p = (B7 << 1) / B4;
@@ -234,52 +437,232 @@ void BMP085::calcSeaLevelPress (double _pressurehPa, double _absAltM, double* _s
 void BMP085::eocIntHandler (void * _data)
 {
     BMP085* _this = static_cast<BMP085*>(_data);
+    EMBED_TRACE_SCOPE("bmp085", "BMP085::eocIntHandler", 0);
 
-    switch (_this->m_state)
+    pthread_mutex_lock (&_this->m_stateMutex);
+    if (_this->m_async)
+        _this->stepStateMachine();
+    pthread_mutex_unlock (&_this->m_stateMutex);
+}
+
+void BMP085::stallTimerHandler (void* _data)
+{
+    BMP085* _this = static_cast<BMP085*>(_data);
+    EMBED_TRACE_SCOPE("bmp085", "BMP085::stallTimerHandler", 0);
+
+    pthread_mutex_lock (&_this->m_stateMutex);
+
+    // The EOC handler may have moved on to the next conversion while this
+    // timer was firing, in which case the new deadline has not passed
+    if (_this->m_async && _this->nowUs() - _this->m_convStartUs >= _this->m_convTimeoutUs)
+    {
+        // The conversion has finished by now even if its EOC edge was
+        // missed, so read the result anyway and keep the cycle going
+        _this->m_stallsRecovered++;
+        _this->stepStateMachine();
+    }
+
+    pthread_mutex_unlock (&_this->m_stateMutex);
+}
+
+void BMP085::stepStateMachine ()
+{
+    // Traced with the state it steps from
+    EMBED_TRACE_SCOPE("bmp085", "BMP085::stepStateMachine", m_state);
+
+    switch (m_state)
     {
         case WAIT_TEMP_CONVERSION:
         {
+            bool timing = m_timingEnabled;
+            SampleTiming& t = m_timing;
+            if (timing)
+            {
+                t.m_tempEocUs = nowUs();
+                recordTiming (TIMING_TEMP_CONVERSION, t.m_tempStartUs, t.m_tempEocUs);
+            }
+
             // Read temperature
-            _this->m_rawTempAsync = ((_this->readReg (VALUE_MSB_REG) << 8) | _this->readReg (VALUE_LSB_REG));
+            m_rawTempAsync = ((readReg (VALUE_MSB_REG) << 8) | readReg (VALUE_LSB_REG));
+            if (timing)
+                recordTiming (TIMING_READOUT, t.m_tempEocUs, nowUs());
 
-            // Start a pressure reading
-            _this->writeReg (CTRL_REG, PRESSURE_OSRS0 | (_this->m_ossr << 6));
+            // Start a pressure reading, latching the OSSR setting so it
+            // can be changed while the conversion is in flight
+            m_convOssr = m_ossr;
+            writeReg (CTRL_REG, PRESSURE_OSRS0 | (m_convOssr << 6));
+            startStallTimer (OSSR_CONVERSION_TIME[m_convOssr]);
+            t.m_pressureStartUs = timing ? nowUs() : 0;
 
             // Transition to waiting for pressure conversion state
-            _this->m_state = WAIT_PRESSURE_CONVERSION;
+            m_state = WAIT_PRESSURE_CONVERSION;
             break;
         }
         case WAIT_PRESSURE_CONVERSION:
         {
+            bool timing = m_timingEnabled;
+            SampleTiming& t = m_timing;
+            if (timing)
+            {
+                t.m_pressureEocUs = nowUs();
+                if (t.m_pressureStartUs != 0 && t.m_pressureEocUs >= t.m_pressureStartUs)
+                {
+                    pthread_mutex_lock (&m_timingMutex);
+                    m_pressureConvHist[m_convOssr].addValue(t.m_pressureEocUs - t.m_pressureStartUs);
+                    pthread_mutex_unlock (&m_timingMutex);
+                }
+            }
+
             // Read pressure
-            int32_t pressure = (((_this->readReg (VALUE_MSB_REG) << 16) |
-                                 (_this->readReg (VALUE_LSB_REG) << 8)  |
-                                 _this->readReg (VALUE_XLSB_REG)) >>
-                                (8 - _this->m_ossr));
+            int32_t pressure = (((readReg (VALUE_MSB_REG) << 16) |
+                                 (readReg (VALUE_LSB_REG) << 8)  |
+                                 readReg (VALUE_XLSB_REG)) >>
+                                (8 - m_convOssr));
+            m_sampleOssr = m_convOssr;
+            if (timing)
+            {
+                t.m_readoutUs = nowUs();
+                recordTiming (TIMING_READOUT, t.m_pressureEocUs, t.m_readoutUs);
+            }
 
             // Notify listeners
-            std::map<EOCIntHandler,void*>::iterator it;
-            for (it = _this->m_listeners.begin(); it != _this->m_listeners.end(); it++)
-                it->first (_this->m_rawTempAsync, pressure, it->second);
+            {
+                EMBED_TRACE_SCOPE("bmp085", "BMP085::dispatch", m_listeners.size());
+                m_dispatching = true;
+                std::map<EOCIntHandler,void*>::iterator it;
+                for (it = m_listeners.begin(); it != m_listeners.end(); it++)
+                {
+                    if (!isUnregistered (it->first))
+                        it->first (m_rawTempAsync, pressure, it->second);
+                }
+                m_dispatching = false;
+
+                for (uint32_t i = 0; i < m_unregistered.size(); i++)
+                    m_listeners.erase(m_unregistered[i]);
+                m_unregistered.clear();
+            }
+
+            if (timing)
+            {
+                t.m_dispatchUs = nowUs();
+                recordTiming (TIMING_DISPATCH, t.m_readoutUs, t.m_dispatchUs);
+
+                pthread_mutex_lock (&m_timingMutex);
+                uint64_t lastDispatchUs = m_lastTiming.m_dispatchUs;
+                if (t.m_tempStartUs != 0)
+                    m_lastTiming = t;
+                pthread_mutex_unlock (&m_timingMutex);
+
+                recordTiming (TIMING_SAMPLE_PERIOD, lastDispatchUs, t.m_dispatchUs);
+            }
 
             // start another temperature reading
-            _this->writeReg (CTRL_REG, TEMPERATURE);
+            writeReg (CTRL_REG, TEMPERATURE);
+            startStallTimer (TEMP_CONVERSION_TIME);
+            t.m_tempStartUs = timing ? nowUs() : 0;
 
             // Transition back to waiting for temperature conversion
-            _this->m_state = WAIT_TEMP_CONVERSION;
+            m_state = WAIT_TEMP_CONVERSION;
             break;
         }
         default:
         {
             fprintf (stderr, "BMP085::eocIntHandler invalid state, returning to safe state\n");
             // start a temperature reading
-            _this->writeReg (CTRL_REG, TEMPERATURE);
-            _this->m_state = WAIT_TEMP_CONVERSION;
+            writeReg (CTRL_REG, TEMPERATURE);
+            startStallTimer (TEMP_CONVERSION_TIME);
+            m_timing.m_tempStartUs = m_timingEnabled ? nowUs() : 0;
+            m_state = WAIT_TEMP_CONVERSION;
             break;
         }
     }
 }
 
+bool BMP085::isUnregistered (EOCIntHandler _handler)
+{
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+            return true;
+    }
+
+    return false;
+}
+
+void BMP085::startStallTimer (double _timeMs)
+{
+    // Never re-armed once destroy has stopped async mode
+    if (m_timer == NULL || !m_async)
+        return;
+
+    m_convStartUs = nowUs();
+    m_convTimeoutUs = (uint64_t) (_timeMs * 1000.0 * STALL_TIMEOUT_FACTOR) + STALL_TIMEOUT_MARGIN_US;
+    m_timer->schedule (m_convTimeoutUs, stallTimerHandler, this);
+}
+
+void BMP085::eocSyncIntHandler (void* _data)
+{
+    BMP085* _this = static_cast<BMP085*>(_data);
+
+    // Wake the synchronous read waiting on this conversion
+    pthread_mutex_lock (&_this->m_syncMutex);
+    _this->m_syncEoc = true;
+    pthread_cond_signal (&_this->m_syncCond);
+    pthread_mutex_unlock (&_this->m_syncMutex);
+}
+
+void BMP085::startConversionWait ()
+{
+    // Must be cleared before the conversion is started, otherwise
+    // a fast EOC edge could be lost
+    if (m_syncWait == SYNC_WAIT_INTERRUPT)
+    {
+        pthread_mutex_lock (&m_syncMutex);
+        m_syncEoc = false;
+        pthread_mutex_unlock (&m_syncMutex);
+    }
+}
+
+bool BMP085::waitConversion (double _timeMs, uint64_t* _eocUs)
+{
+    // Returns true if EOC was seen, _eocUs is when the wait finished
+
+    if (m_syncWait == SYNC_WAIT_SLEEP)
+    {
+        m_clock->sleepUs ((uint64_t) (_timeMs * 1000.0));
+        (*_eocUs) = m_timingEnabled ? nowUs() : 0;
+        return false;
+    }
+
+    uint64_t deadlineUs = nowUs() + (uint64_t) (_timeMs * 1000.0);
+    bool eoc = false;
+
+    if (m_syncWait == SYNC_WAIT_POLL)
+    {
+        while (!(eoc = (m_eoc->digitalRead() != 0)) && nowUs() < deadlineUs)
+            m_clock->sleepUs (EOC_POLL_INTERVAL_US);
+    }
+    else
+    {
+        pthread_mutex_lock (&m_syncMutex);
+        while (!m_syncEoc)
+        {
+            if (!m_clock->waitUntil (&m_syncCond, &m_syncMutex, deadlineUs))
+                break;
+        }
+        eoc = m_syncEoc;
+        pthread_mutex_unlock (&m_syncMutex);
+    }
+
+    (*_eocUs) = nowUs();
+
+    // Conversion must be complete by the datasheet time, so read anyway
+    if (!eoc)
+        m_syncTimeouts++;
+
+    return eoc;
+}
+
 void BMP085::readDeviceParams ()
 {
     // Read device params from EEPROM
@@ -306,3 +689,21 @@ void BMP085::writeReg (const uint8_t _reg, const uint8_t _val)
 {
     m_bus->writeReg(ADDRESS, _reg, _val);
 }
+
+void BMP085::recordTiming (TIMING_STAT _stat, uint64_t _startUs, uint64_t _endUs)
+{
+    // Skip intervals that started before timing was enabled
+    if (_startUs == 0 || _endUs < _startUs)
+        return;
+
+    uint64_t us = _endUs - _startUs;
+
+    pthread_mutex_lock (&m_timingMutex);
+    m_timingHist[_stat].addValue(us > UINT32_MAX ? UINT32_MAX : (uint32_t) us);
+    pthread_mutex_unlock (&m_timingMutex);
+}
+
+uint64_t BMP085::nowUs ()
+{
+    return m_clock->nowUs();
+}
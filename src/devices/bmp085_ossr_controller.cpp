@@ -0,0 +1,149 @@
+/*
+ * Filename: bmp085_ossr_controller.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the BMP085 adaptive oversampling
+ *              controller
+ */
+
+#include "bmp085_ossr_controller.h"
+
+using namespace embed;
+
+const double BMP085OSSRController::NOISE_RMS_HPA[BMP085::OSSR_NUM] = {0.06, 0.05, 0.04, 0.03};
+const double BMP085OSSRController::SWITCH_DOWN_MARGIN = 0.9;
+
+BMP085OSSRController::BMP085OSSRController (BMP085* _device, double _targetNoisehPa, double _minRateHz,
+                                            uint32_t _windowSize) :
+    m_initialized (false),
+    m_device (_device),
+    m_targetNoisehPa (_targetNoisehPa),
+    m_minRateHz (_minRateHz),
+    m_windowSize (_windowSize),
+    m_windowCount (0),
+    m_noiseFilter (_windowSize),
+    m_noisehPa (nan("")),
+    m_numSwitches (0),
+    m_switchHandler (NULL),
+    m_switchData (NULL)
+{
+}
+
+BMP085OSSRController::~BMP085OSSRController ()
+{
+    destroy();
+}
+
+bool BMP085OSSRController::init ()
+{
+    if (m_initialized)
+        return true;
+
+    if (m_device == NULL || m_windowSize < 2)
+    {
+        fprintf(stderr, "BMP085OSSRController::init called with invalid device or window size\n");
+        return false;
+    }
+
+    m_noiseFilter.reset();
+    m_windowCount = 0;
+    m_device->registerListener(eocIntHandler, this);
+
+    m_initialized = true;
+
+    return true;
+}
+
+void BMP085OSSRController::destroy ()
+{
+    if (!m_initialized)
+        return;
+
+    m_device->unregisterListener(eocIntHandler);
+
+    m_initialized = false;
+}
+
+void BMP085OSSRController::setSwitchHandler (OSSRSwitchHandler _handler, void* _data)
+{
+    m_switchHandler = _handler;
+    m_switchData = _data;
+}
+
+double BMP085OSSRController::getMaxRate (BMP085::OSSR_SETTING _ossr)
+{
+    // Each async sample is a temperature conversion followed by a pressure conversion
+    return 1000.0 / (BMP085::getTempConversionTime() + BMP085::getConversionTime(_ossr));
+}
+
+void BMP085OSSRController::eocIntHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    BMP085OSSRController* _this = static_cast<BMP085OSSRController*>(_data);
+
+    _this->update (_temp, _pressure);
+}
+
+void BMP085OSSRController::update (const int16_t _temp, const int32_t _pressure)
+{
+    BMP085::OSSR_SETTING current = m_device->getOSSR();
+
+    // Skip the sample still converted with a previous setting after a switch
+    if (m_device->getSampleOSSR() != current)
+        return;
+
+    double tempC, pressurehPa;
+    m_device->calcTempPressure(_temp, _pressure, current, &tempC, &pressurehPa);
+    m_noiseFilter.addValue(pressurehPa);
+
+    // Only decide on a full window of samples from the current setting
+    if (++m_windowCount < m_windowSize)
+        return;
+    m_windowCount = 0;
+
+    m_noisehPa = m_noiseFilter.getStdDev();
+    m_noiseFilter.reset();
+
+    BMP085::OSSR_SETTING next = selectOSSR (current, m_noisehPa);
+    if (next == current)
+        return;
+
+    // Takes effect at the start of the next pressure conversion
+    m_device->setOSSR(next);
+    m_numSwitches++;
+
+    if (m_switchHandler != NULL)
+        m_switchHandler (current, next, m_noisehPa, m_switchData);
+}
+
+BMP085::OSSR_SETTING BMP085OSSRController::selectOSSR (BMP085::OSSR_SETTING _current, double _noisehPa)
+{
+    // Lowest setting predicted to hold the target noise, limited to the
+    // settings fast enough for the minimum sample rate
+    int32_t best = -1;
+    int32_t slowestAllowed = BMP085::OSSR_LOW_POWER;
+    for (int32_t i = BMP085::OSSR_LOW_POWER; i < BMP085::OSSR_NUM; i++)
+    {
+        BMP085::OSSR_SETTING ossr = (BMP085::OSSR_SETTING) i;
+        if (getMaxRate(ossr) < m_minRateHz)
+            break;
+        slowestAllowed = i;
+
+        double predicted = _noisehPa * NOISE_RMS_HPA[i] / NOISE_RMS_HPA[_current];
+        double limit = m_targetNoisehPa;
+        if (i < _current)
+            limit *= SWITCH_DOWN_MARGIN;
+
+        if (predicted <= limit)
+        {
+            best = i;
+            break;
+        }
+    }
+
+    // Nothing meets the target, so take the least noisy setting that
+    // is still fast enough
+    if (best < 0)
+        best = slowestAllowed;
+
+    return (BMP085::OSSR_SETTING) best;
+}
@@ -0,0 +1,382 @@
+/*
+ * Filename: bmp280.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for BMP280 device class
+ */
+
+#include "bmp280.h"
+
+using namespace embed;
+
+const double BMP280::PRESSURE_SEA_LEVEL_HPA = 1013.25;
+const double BMP280::STANDBY_TIME[STANDBY_NUM] = {0.5, 62.5, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0};
+const uint8_t BMP280::OVERSAMPLING_SAMPLES[OVERSAMPLING_NUM] = {0, 1, 2, 4, 8, 16};
+
+BMP280::BMP280 (I2C* _bus, const uint8_t _address, Timer* _timer, Clock* _clock) :
+    m_initialized (false),
+    m_T1 (0),
+    m_T2 (0),
+    m_T3 (0),
+    m_P1 (0),
+    m_P2 (0),
+    m_P3 (0),
+    m_P4 (0),
+    m_P5 (0),
+    m_P6 (0),
+    m_P7 (0),
+    m_P8 (0),
+    m_P9 (0),
+    m_bus (_bus),
+    m_address (_address),
+    m_tempOsrs (OVERSAMPLING_X1),
+    m_pressureOsrs (OVERSAMPLING_X4),
+    m_standby (STANDBY_0_5_MS),
+    m_filter (FILTER_OFF),
+    m_async (false),
+    m_timer (_timer),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_listeners (),
+    m_listenersMutex (),
+    m_dispatching (false),
+    m_unregistered ()
+{
+    // Recursive so listeners can call back into the device, which is why
+    // unregistering during dispatch is deferred
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init (&mutexAttr);
+    pthread_mutexattr_settype (&mutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&m_listenersMutex, &mutexAttr);
+    pthread_mutexattr_destroy (&mutexAttr);
+}
+
+BMP280::~BMP280 ()
+{
+    m_listeners.clear();
+    pthread_mutex_destroy (&m_listenersMutex);
+}
+
+bool BMP280::init (bool _async)
+{
+    if (m_initialized)
+        return true;
+
+    if (_async && m_timer == NULL)
+    {
+        fprintf(stderr, "BMP280::init called specifying async without a valid timer\n");
+        return false;
+    }
+
+    uint8_t id = readReg (ID_REG);
+    if (id != getChipId())
+    {
+        fprintf(stderr, "BMP280::init unexpected chip id 0x%02x\n", id);
+        return false;
+    }
+
+    readDeviceParams();
+
+    if (_async)
+    {
+        m_async = true;
+        // Start continuous sampling and read once per measurement period
+        writeConfig (MODE_NORMAL);
+        m_timer->schedule ((uint64_t) (getSamplePeriod() * 1000.0), sampleTimerHandler, this);
+    }
+    else
+        writeConfig (MODE_SLEEP);
+
+    m_initialized = true;
+
+    return true;
+}
+
+void BMP280::destroy ()
+{
+    if (!m_initialized)
+        return;
+
+    // If async mode, need to stop reads and put the device back to sleep
+    if (m_async)
+    {
+        // A handler already running may reschedule itself before it sees
+        // m_async cleared, the second cancel removes that timer
+        m_async = false;
+        m_timer->cancel (sampleTimerHandler, this);
+        m_timer->cancel (sampleTimerHandler, this);
+        writeConfig (MODE_SLEEP);
+    }
+
+    pthread_mutex_lock (&m_listenersMutex);
+    m_listeners.clear();
+    m_unregistered.clear();
+    pthread_mutex_unlock (&m_listenersMutex);
+
+    m_initialized = false;
+}
+
+void BMP280::reset ()
+{
+    // Soft reset, device needs 2ms to start up and reload its NVM
+    writeReg (RESET_REG, RESET_VALUE);
+    m_clock->sleepUs (2000);
+
+    readDeviceParams();
+
+    // Settings are lost on reset
+    writeConfig (m_async ? MODE_NORMAL : MODE_SLEEP);
+}
+
+double BMP280::getMeasurementTime ()
+{
+    // Datasheet maximum measurement time
+    double timeMs = 1.25 + 2.3 * OVERSAMPLING_SAMPLES[m_tempOsrs];
+    if (m_pressureOsrs != OVERSAMPLING_SKIP)
+        timeMs += 2.3 * OVERSAMPLING_SAMPLES[m_pressureOsrs] + 0.575;
+
+    return timeMs;
+}
+
+double BMP280::getSamplePeriod ()
+{
+    return getMeasurementTime() + getStandbyTime(m_standby);
+}
+
+bool BMP280::readRawSync (int32_t* _temp, int32_t* _pressure, int32_t* _humidity)
+{
+    if (m_async)
+        return false;
+
+    // Forced mode takes one measurement then goes back to sleep, the
+    // rest of the configuration was written at init
+    writeReg (CTRL_MEAS_REG, (m_tempOsrs << 5) | (m_pressureOsrs << 2) | MODE_FORCED);
+
+    // Wait on the measuring bit, using the maximum measurement time as a timeout
+    m_clock->sleepUs (STATUS_POLL_INTERVAL_US);
+    int32_t pollsLeft = (int32_t) (getMeasurementTime() * 1000.0 / STATUS_POLL_INTERVAL_US);
+    while ((readReg (STATUS_REG) & STATUS_MEASURING) && pollsLeft-- > 0)
+        m_clock->sleepUs (STATUS_POLL_INTERVAL_US);
+
+    return readData (_temp, _pressure, _humidity);
+}
+
+void BMP280::registerListener (SampleHandler _handler, void* _data)
+{
+    // std::map is not thread safe and reads occur in the timer thread
+    pthread_mutex_lock (&m_listenersMutex);
+    m_listeners[_handler] = _data;
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+        {
+            m_unregistered.erase(m_unregistered.begin() + i);
+            break;
+        }
+    }
+    pthread_mutex_unlock (&m_listenersMutex);
+}
+
+void BMP280::unregisterListener (SampleHandler _handler)
+{
+    pthread_mutex_lock (&m_listenersMutex);
+    std::map<SampleHandler,void*>::iterator it = m_listeners.find(_handler);
+    if (it != m_listeners.end())
+    {
+        if (m_dispatching)
+            m_unregistered.push_back(_handler);
+        else
+            m_listeners.erase(it);
+    }
+    pthread_mutex_unlock (&m_listenersMutex);
+}
+
+void BMP280::calcTempPressure (const int32_t _rawTemp, const int32_t _rawPressure,
+                               double* _tempC, double* _pressurehPa)
+{
+    int32_t tFine;
+    (*_tempC) = compensateTemp (_rawTemp, &tFine) * 0.01;
+
+    // Q24.8 Pa to hPa
+    (*_pressurehPa) = ((double) compensatePressure64 (_rawPressure, tFine)) / 25600.0;
+}
+
+void BMP280::calcTempPressure32 (const int32_t _rawTemp, const int32_t _rawPressure,
+                                 double* _tempC, double* _pressurehPa)
+{
+    int32_t tFine;
+    (*_tempC) = compensateTemp (_rawTemp, &tFine) * 0.01;
+
+    // Pa to hPa
+    (*_pressurehPa) = ((double) compensatePressure32 (_rawPressure, tFine)) / 100.0;
+}
+
+void BMP280::calcApproxAlt (double _pressurehPa, double* _absAltM)
+{
+    (*_absAltM) = 44330.0 * (1.0 - pow (_pressurehPa / PRESSURE_SEA_LEVEL_HPA, 1 / 5.255));
+}
+
+void BMP280::calcExactAlt (double _pressurehPa, double _seaLevelhPa, double* _absAltM)
+{
+    (*_absAltM) = 44330.0 * (1.0 - pow (_pressurehPa / _seaLevelhPa, 1 / 5.255));
+}
+
+void BMP280::readDeviceParams ()
+{
+    // Read device params from NVM in one burst, values are little endian
+    uint8_t buf[CALIB_LEN];
+    readRegs (CALIB_REG, buf, CALIB_LEN);
+
+    m_T1 = (buf[1] << 8) | buf[0];
+    m_T2 = (buf[3] << 8) | buf[2];
+    m_T3 = (buf[5] << 8) | buf[4];
+    m_P1 = (buf[7] << 8) | buf[6];
+    m_P2 = (buf[9] << 8) | buf[8];
+    m_P3 = (buf[11] << 8) | buf[10];
+    m_P4 = (buf[13] << 8) | buf[12];
+    m_P5 = (buf[15] << 8) | buf[14];
+    m_P6 = (buf[17] << 8) | buf[16];
+    m_P7 = (buf[19] << 8) | buf[18];
+    m_P8 = (buf[21] << 8) | buf[20];
+    m_P9 = (buf[23] << 8) | buf[22];
+}
+
+void BMP280::writeConfig (const uint8_t _mode)
+{
+    // Config is only guaranteed to be written in sleep mode
+    writeReg (CTRL_MEAS_REG, MODE_SLEEP);
+    writeReg (CONFIG_REG, (m_standby << 5) | (m_filter << 2));
+    writeReg (CTRL_MEAS_REG, (m_tempOsrs << 5) | (m_pressureOsrs << 2) | _mode);
+}
+
+void BMP280::sampleTimerHandler (void* _data)
+{
+    BMP280* _this = static_cast<BMP280*>(_data);
+
+    if (!_this->m_async)
+        return;
+
+    // Reschedule first so the read and dispatch time does not add to the period
+    _this->m_timer->schedule ((uint64_t) (_this->getSamplePeriod() * 1000.0), sampleTimerHandler, _this);
+
+    int32_t temp, pressure, humidity;
+    if (!_this->readData (&temp, &pressure, &humidity))
+        return;
+
+    // Notify listeners
+    pthread_mutex_lock (&_this->m_listenersMutex);
+    _this->m_dispatching = true;
+    std::map<SampleHandler,void*>::iterator it;
+    for (it = _this->m_listeners.begin(); it != _this->m_listeners.end(); it++)
+    {
+        if (!_this->isUnregistered (it->first))
+            it->first (temp, pressure, humidity, it->second);
+    }
+    _this->m_dispatching = false;
+
+    for (uint32_t i = 0; i < _this->m_unregistered.size(); i++)
+        _this->m_listeners.erase(_this->m_unregistered[i]);
+    _this->m_unregistered.clear();
+    pthread_mutex_unlock (&_this->m_listenersMutex);
+}
+
+bool BMP280::isUnregistered (SampleHandler _handler)
+{
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+            return true;
+    }
+
+    return false;
+}
+
+bool BMP280::readData (int32_t* _temp, int32_t* _pressure, int32_t* _humidity)
+{
+    // One burst read keeps the measurement registers consistent, the
+    // device shadows them for the duration of the transaction
+    uint8_t data[MAX_DATA_LEN];
+    readRegs (DATA_REG, data, getDataLength());
+
+    (*_pressure) = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
+    (*_temp) = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
+    if (_humidity != NULL)
+        (*_humidity) = parseHumidity (data);
+
+    // 0x80000 is the reset value, no measurement has completed yet
+    return ((*_temp) != 0x80000);
+}
+
+int32_t BMP280::compensateTemp (const int32_t _rawTemp, int32_t* _tFine)
+{
+    int32_t var1 = ((((_rawTemp >> 3) - ((int32_t) m_T1 << 1))) * ((int32_t) m_T2)) >> 11;
+    int32_t var2 = (((((_rawTemp >> 4) - ((int32_t) m_T1)) * ((_rawTemp >> 4) - ((int32_t) m_T1))) >> 12) *
+                    ((int32_t) m_T3)) >> 14;
+    (*_tFine) = var1 + var2;
+
+    // Temperature in 0.01 C
+    return ((*_tFine) * 5 + 128) >> 8;
+}
+
+uint32_t BMP280::compensatePressure64 (const int32_t _rawPressure, const int32_t _tFine)
+{
+    int64_t var1 = ((int64_t) _tFine) - 128000;
+    int64_t var2 = var1 * var1 * (int64_t) m_P6;
+    var2 = var2 + ((var1 * (int64_t) m_P5) << 17);
+    var2 = var2 + (((int64_t) m_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t) m_P3) >> 8) + ((var1 * (int64_t) m_P2) << 12);
+    var1 = (((((int64_t) 1) << 47) + var1)) * ((int64_t) m_P1) >> 33;
+
+    // Avoid division by zero
+    if (var1 == 0)
+        return 0;
+
+    int64_t p = 1048576 - _rawPressure;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t) m_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t) m_P8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t) m_P7) << 4);
+
+    // Pressure in Pa as Q24.8
+    return (uint32_t) p;
+}
+
+uint32_t BMP280::compensatePressure32 (const int32_t _rawPressure, const int32_t _tFine)
+{
+    int32_t var1 = (((int32_t) _tFine) >> 1) - (int32_t) 64000;
+    int32_t var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t) m_P6);
+    var2 = var2 + ((var1 * ((int32_t) m_P5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t) m_P4) << 16);
+    var1 = (((m_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t) m_P2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t) m_P1)) >> 15);
+
+    // Avoid division by zero
+    if (var1 == 0)
+        return 0;
+
+    uint32_t p = (((uint32_t) (((int32_t) 1048576) - _rawPressure) - (var2 >> 12))) * 3125;
+    if (p < 0x80000000)
+        p = (p << 1) / ((uint32_t) var1);
+    else
+        p = (p / (uint32_t) var1) * 2;
+    var1 = (((int32_t) m_P9) * ((int32_t) (((p >> 3) * (p >> 3)) >> 13))) >> 12;
+    var2 = (((int32_t) (p >> 2)) * ((int32_t) m_P8)) >> 13;
+    p = (uint32_t) ((int32_t) p + ((var1 + var2 + m_P7) >> 4));
+
+    // Pressure in Pa
+    return p;
+}
+
+uint8_t BMP280::readReg (const uint8_t _reg)
+{
+    return m_bus->readReg(m_address, _reg);
+}
+
+void BMP280::readRegs (const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+{
+    m_bus->readRegs(m_address, _reg, _buf, _len);
+}
+
+void BMP280::writeReg (const uint8_t _reg, const uint8_t _val)
+{
+    m_bus->writeReg(m_address, _reg, _val);
+}
@@ -0,0 +1,181 @@
+/*
+ * Filename: sim_bmp085.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the simulated BMP085 model
+ */
+
+#include "sim_bmp085.h"
+
+using namespace embed;
+
+// Datasheet example calibration, AC1..MD big endian from 0xAA
+static const uint16_t CALIBRATION[11] = {408, (uint16_t) -72, (uint16_t) -14383, 32741, 32757, 23153,
+                                         6190, 4, (uint16_t) -32768, (uint16_t) -8711, 2868};
+
+// Datasheet typical conversion times in us, so a driver sleeping the
+// maximum time always finds the conversion done
+static const uint32_t TEMP_CONVERSION_US = 3000;
+static const uint32_t PRESSURE_CONVERSION_US[4] = {3000, 5000, 9000, 17000};
+
+SimBMP085::SimBMP085 (Timer* _timer, SimGPIO* _eoc, SimGPIO* _xclr) :
+    m_timer (_timer),
+    m_eoc (_eoc),
+    m_xclr (_xclr),
+    m_regsMutex (),
+    m_command (0),
+    m_rawTemp (EXAMPLE_RAW_TEMP),
+    m_rawPressure (EXAMPLE_RAW_PRESSURE),
+    m_numConversions (0),
+    m_numEdgesToDrop (0)
+{
+    pthread_mutex_init (&m_regsMutex, NULL);
+
+    memset (m_regs, 0, sizeof(m_regs));
+    for (uint32_t i = 0; i < 11; i++)
+    {
+        m_regs[EEPROM_REG + 2 * i] = CALIBRATION[i] >> 8;
+        m_regs[EEPROM_REG + 2 * i + 1] = CALIBRATION[i] & 0xFF;
+    }
+    m_regs[CHIP_ID_REG] = CHIP_ID;
+
+    // EOC is high while idle
+    if (m_eoc != NULL)
+        m_eoc->setLevel(1);
+}
+
+SimBMP085::~SimBMP085 ()
+{
+    if (m_timer != NULL)
+        m_timer->cancel(conversionTimerHandler, this);
+    pthread_mutex_destroy (&m_regsMutex);
+}
+
+void SimBMP085::connectEOC (SimGPIO* _eoc)
+{
+    m_eoc = _eoc;
+    if (m_eoc != NULL)
+        m_eoc->setLevel(1);
+}
+
+void SimBMP085::connectXCLR (SimGPIO* _xclr)
+{
+    m_xclr = _xclr;
+}
+
+void SimBMP085::setRawValues (const int32_t _temp, const int32_t _pressure)
+{
+    pthread_mutex_lock (&m_regsMutex);
+    m_rawTemp = _temp;
+    m_rawPressure = _pressure;
+    pthread_mutex_unlock (&m_regsMutex);
+}
+
+void SimBMP085::dropEOCEdges (const uint32_t _num)
+{
+    pthread_mutex_lock (&m_regsMutex);
+    m_numEdgesToDrop = _num;
+    pthread_mutex_unlock (&m_regsMutex);
+}
+
+uint32_t SimBMP085::getConversionTimeUs (const uint8_t _command)
+{
+    if (_command == TEMPERATURE)
+        return TEMP_CONVERSION_US;
+
+    return PRESSURE_CONVERSION_US[_command >> 6];
+}
+
+uint8_t SimBMP085::readReg (const uint8_t _reg)
+{
+    if (inReset())
+        return 0;
+
+    pthread_mutex_lock (&m_regsMutex);
+    uint8_t val = m_regs[_reg];
+    pthread_mutex_unlock (&m_regsMutex);
+
+    return val;
+}
+
+void SimBMP085::writeReg (const uint8_t _reg, const uint8_t _val)
+{
+    if (inReset())
+        return;
+
+    // Only the control register is writable
+    if (_reg != CTRL_REG)
+        return;
+
+    if (_val == TEMPERATURE || (_val & 0x3F) == PRESSURE_OSRS0)
+        startConversion(_val);
+}
+
+void SimBMP085::conversionTimerHandler (void* _data)
+{
+    SimBMP085* _this = static_cast<SimBMP085*>(_data);
+
+    _this->finishConversion();
+}
+
+bool SimBMP085::inReset ()
+{
+    // XCLR is active low
+    return m_xclr != NULL && m_xclr->digitalRead() == 0;
+}
+
+void SimBMP085::startConversion (const uint8_t _command)
+{
+    pthread_mutex_lock (&m_regsMutex);
+    m_command = _command;
+    m_regs[CTRL_REG] = _command;
+    pthread_mutex_unlock (&m_regsMutex);
+
+    if (m_timer == NULL)
+    {
+        finishConversion();
+        return;
+    }
+
+    // Called from the bus with its lock held, so only lower EOC here, the
+    // rising edge comes from the timer thread
+    if (m_eoc != NULL)
+        m_eoc->setLevel(0);
+    m_timer->schedule(getConversionTimeUs(_command), conversionTimerHandler, this);
+}
+
+void SimBMP085::finishConversion ()
+{
+    pthread_mutex_lock (&m_regsMutex);
+
+    if (m_command == TEMPERATURE)
+    {
+        m_regs[VALUE_MSB_REG] = (m_rawTemp >> 8) & 0xFF;
+        m_regs[VALUE_MSB_REG + 1] = m_rawTemp & 0xFF;
+    }
+    else
+    {
+        // The driver shifts right by 8 - OSSR, so the extra resolution bits
+        // of an oversampled conversion sit below the OSSR 0 value
+        uint8_t ossr = m_command >> 6;
+        int32_t value = (m_rawPressure << ossr) << (8 - ossr);
+        m_regs[VALUE_MSB_REG] = (value >> 16) & 0xFF;
+        m_regs[VALUE_MSB_REG + 1] = (value >> 8) & 0xFF;
+        m_regs[VALUE_MSB_REG + 2] = value & 0xFF;
+    }
+
+    // The control register's start bit clears when the conversion is done
+    m_regs[CTRL_REG] = m_command & ~0x20;
+    m_numConversions++;
+
+    bool dropEdge = m_numEdgesToDrop > 0;
+    if (dropEdge)
+        m_numEdgesToDrop--;
+
+    pthread_mutex_unlock (&m_regsMutex);
+
+    // Handlers run the driver, which takes the bus lock, so this must be
+    // outside the register lock
+    if (m_eoc != NULL && !dropEdge)
+        m_eoc->setLevel(1);
+}
@@ -0,0 +1,121 @@
+/*
+ * Filename: sim_bmp280.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the simulated BMP280/BME280 model
+ */
+
+#include "sim_bmp280.h"
+
+using namespace embed;
+
+// Datasheet example calibration, dig_T1..dig_P9 little endian from 0x88
+static const uint16_t CALIBRATION[12] = {27504, 26435, (uint16_t) -1000, 36477, (uint16_t) -10685, 3024,
+                                         2855, 140, (uint16_t) -7, 15500, (uint16_t) -14600, 6000};
+
+// Typical BME280 humidity calibration (the datasheet gives no example)
+static const uint8_t  CALIB_H1 = 75;
+static const int16_t  CALIB_H2 = 370;
+static const uint8_t  CALIB_H3 = 0;
+static const int16_t  CALIB_H4 = 309;
+static const int16_t  CALIB_H5 = 50;
+static const int8_t   CALIB_H6 = 30;
+
+SimBMP280::SimBMP280 (bool _bme280) :
+    m_bme280 (_bme280),
+    m_rawTemp (EXAMPLE_RAW_TEMP),
+    m_rawPressure (EXAMPLE_RAW_PRESSURE),
+    m_rawHumidity (_bme280 ? EXAMPLE_RAW_HUMIDITY : 0),
+    m_numMeasurements (0)
+{
+    powerOn();
+}
+
+SimBMP280::~SimBMP280 ()
+{
+}
+
+void SimBMP280::setRawValues (const int32_t _temp, const int32_t _pressure, const int32_t _humidity)
+{
+    m_rawTemp = _temp;
+    m_rawPressure = _pressure;
+    m_rawHumidity = _humidity;
+}
+
+uint8_t SimBMP280::readReg (const uint8_t _reg)
+{
+    return m_regs[_reg];
+}
+
+void SimBMP280::writeReg (const uint8_t _reg, const uint8_t _val)
+{
+    if (_reg == RESET_REG)
+    {
+        if (_val == RESET_VALUE)
+            powerOn();
+        return;
+    }
+
+    m_regs[_reg] = _val;
+
+    // Forced mode measures once and drops back to sleep
+    if (_reg == CTRL_MEAS_REG && (_val & 0x03) != 0 && (_val & 0x03) != 0x03)
+    {
+        latchMeasurement();
+        m_regs[CTRL_MEAS_REG] &= ~0x03;
+    }
+}
+
+void SimBMP280::beginRead ()
+{
+    // Normal mode always has a fresh measurement for the next burst read
+    if ((m_regs[CTRL_MEAS_REG] & 0x03) == 0x03)
+        latchMeasurement();
+}
+
+void SimBMP280::powerOn ()
+{
+    memset (m_regs, 0, sizeof(m_regs));
+
+    for (int32_t i = 0; i < 12; i++)
+    {
+        m_regs[0x88 + 2 * i] = CALIBRATION[i] & 0xFF;
+        m_regs[0x89 + 2 * i] = CALIBRATION[i] >> 8;
+    }
+
+    if (m_bme280)
+    {
+        m_regs[0xA1] = CALIB_H1;
+        m_regs[0xE1] = CALIB_H2 & 0xFF;
+        m_regs[0xE2] = (CALIB_H2 >> 8) & 0xFF;
+        m_regs[0xE3] = CALIB_H3;
+        m_regs[0xE4] = (CALIB_H4 >> 4) & 0xFF;
+        m_regs[0xE5] = (CALIB_H4 & 0x0F) | ((CALIB_H5 & 0x0F) << 4);
+        m_regs[0xE6] = (CALIB_H5 >> 4) & 0xFF;
+        m_regs[0xE7] = (uint8_t) CALIB_H6;
+    }
+
+    m_regs[ID_REG] = m_bme280 ? 0x60 : 0x58;
+
+    // Data registers reset to 0x80000, humidity to 0x8000
+    m_regs[DATA_REG] = 0x80;
+    m_regs[DATA_REG + 3] = 0x80;
+    m_regs[DATA_REG + 6] = 0x80;
+}
+
+void SimBMP280::latchMeasurement ()
+{
+    m_regs[DATA_REG]     = (m_rawPressure >> 12) & 0xFF;
+    m_regs[DATA_REG + 1] = (m_rawPressure >> 4) & 0xFF;
+    m_regs[DATA_REG + 2] = (m_rawPressure << 4) & 0xF0;
+    m_regs[DATA_REG + 3] = (m_rawTemp >> 12) & 0xFF;
+    m_regs[DATA_REG + 4] = (m_rawTemp >> 4) & 0xFF;
+    m_regs[DATA_REG + 5] = (m_rawTemp << 4) & 0xF0;
+    if (m_bme280)
+    {
+        m_regs[DATA_REG + 6] = (m_rawHumidity >> 8) & 0xFF;
+        m_regs[DATA_REG + 7] = m_rawHumidity & 0xFF;
+    }
+
+    m_numMeasurements++;
+}
@@ -360,6 +360,7 @@ void BBBGPIO::detachInterrupt (GPIOIntHandler _handler)
 void BBBGPIO::intHandler (void* _data)
 {
     BBBGPIO* _this = static_cast<BBBGPIO*>(_data);
+    EMBED_TRACE_SCOPE("gpio", "BBBGPIO::intHandler", _this->m_gpio);
 
     // Notify listeners
     std::map<GPIOIntHandler,void*>::iterator it;
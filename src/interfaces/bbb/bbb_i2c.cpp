@@ -35,6 +35,9 @@ bool BBBI2C::init ()
 
 uint8_t BBBI2C::readReg (const uint8_t _addr, const uint8_t _reg)
 {
+    // Traced with the address in the high byte and the register in the low
+    EMBED_TRACE_SCOPE("i2c", "BBBI2C::readReg", (_addr << 8) | _reg);
+
     if (m_handle == -1)
         return 0;
 
@@ -62,6 +65,8 @@ uint8_t BBBI2C::readReg (const uint8_t _addr, const uint8_t _reg)
 
 void BBBI2C::writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val)
 {
+    EMBED_TRACE_SCOPE("i2c", "BBBI2C::writeReg", (_addr << 8) | _reg);
+
     if (m_handle == -1)
         return;
 
@@ -79,6 +84,46 @@ void BBBI2C::writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _v
         fprintf(stderr, "BBBI2C::writeReg write error: %s\n", strerror(errno));
 }
 
+void BBBI2C::readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+{
+    // The length goes above the address and register
+    EMBED_TRACE_SCOPE("i2c", "BBBI2C::readRegs", (((uint64_t) _len) << 16) | (_addr << 8) | _reg);
+
+    memset (_buf, 0, _len);
+
+    if (m_handle == -1)
+        return;
+
+    if (_len > 0xFFFF)
+    {
+        fprintf(stderr, "BBBI2C::readRegs called with more than 65535 bytes\n");
+        return;
+    }
+
+    // The register write and the read go out as one transaction with a
+    // repeated start between them, so nothing else on the bus can get in
+    // between. The device auto-increments the register through the read.
+    uint8_t reg = _reg;
+    struct i2c_msg msgs[2];
+    msgs[0].addr = _addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = _addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = _len;
+    msgs[1].buf = _buf;
+
+    struct i2c_rdwr_ioctl_data transfer;
+    transfer.msgs = msgs;
+    transfer.nmsgs = 2;
+    if (ioctl(m_handle, I2C_RDWR, &transfer) != 2)
+    {
+        fprintf(stderr, "BBBI2C::readRegs ioctl error: %s\n", strerror(errno));
+        memset (_buf, 0, _len);
+    }
+}
+
 void BBBI2C::destroy ()
 {
     close(m_handle);
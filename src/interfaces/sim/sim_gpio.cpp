@@ -0,0 +1,153 @@
+/*
+ * Filename: sim_gpio.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the simulated GPIO
+ */
+
+#include "sim_gpio.h"
+
+using namespace embed;
+
+SimGPIO::SimGPIO (const uint8_t _level) :
+    m_initialized (false),
+    m_pinDir (INVALID),
+    m_level (_level != 0 ? 1 : 0),
+    m_mode (RISING),
+    m_listeners (),
+    m_pinMutex (),
+    m_numInterrupts (0)
+{
+    pthread_mutex_init (&m_pinMutex, NULL);
+}
+
+SimGPIO::~SimGPIO ()
+{
+    m_listeners.clear();
+    pthread_mutex_destroy (&m_pinMutex);
+}
+
+bool SimGPIO::init ()
+{
+    m_initialized = true;
+
+    return true;
+}
+
+void SimGPIO::destroy ()
+{
+    pthread_mutex_lock (&m_pinMutex);
+    m_listeners.clear();
+    pthread_mutex_unlock (&m_pinMutex);
+
+    m_initialized = false;
+}
+
+void SimGPIO::setMode (const PIN_DIR _dir)
+{
+    if (!m_initialized)
+        return;
+
+    m_pinDir = _dir;
+}
+
+uint8_t SimGPIO::digitalRead ()
+{
+    pthread_mutex_lock (&m_pinMutex);
+    uint8_t level = m_level;
+    pthread_mutex_unlock (&m_pinMutex);
+
+    return level;
+}
+
+void SimGPIO::digitalWrite (const uint8_t _val)
+{
+    if (!m_initialized)
+        return;
+
+    if (m_pinDir != OUTPUT)
+    {
+        fprintf(stderr, "SimGPIO::digitalWrite called without pin direction set to output\n");
+        return;
+    }
+
+    pthread_mutex_lock (&m_pinMutex);
+    m_level = (_val != 0) ? 1 : 0;
+    pthread_mutex_unlock (&m_pinMutex);
+}
+
+void SimGPIO::attachInterrupt (GPIOIntHandler _handler, INT_MODE _mode, void* _data)
+{
+    if (!m_initialized)
+        return;
+
+    if (m_pinDir != INPUT)
+    {
+        fprintf(stderr, "SimGPIO::attachInterrupt called without pin direction set to input\n");
+        return;
+    }
+
+    pthread_mutex_lock (&m_pinMutex);
+
+    if (m_listeners.size() > 0 && _mode != m_mode)
+    {
+        pthread_mutex_unlock (&m_pinMutex);
+        fprintf(stderr, "SimGPIO::attachInterrupt called with conflicting interrupt mode\n");
+        return;
+    }
+
+    m_mode = _mode;
+    m_listeners[_handler] = _data;
+
+    pthread_mutex_unlock (&m_pinMutex);
+}
+
+void SimGPIO::detachInterrupt (GPIOIntHandler _handler)
+{
+    if (!m_initialized)
+        return;
+
+    pthread_mutex_lock (&m_pinMutex);
+    m_listeners.erase(_handler);
+    pthread_mutex_unlock (&m_pinMutex);
+}
+
+void SimGPIO::setLevel (const uint8_t _level)
+{
+    uint8_t level = (_level != 0) ? 1 : 0;
+
+    pthread_mutex_lock (&m_pinMutex);
+
+    uint8_t prevLevel = m_level;
+    m_level = level;
+
+    bool edge = false;
+    if (level != prevLevel)
+    {
+        if (m_mode == CHANGE)
+            edge = true;
+        else if (m_mode == RISING)
+            edge = (level == 1);
+        else
+            edge = (level == 0);
+    }
+
+    // Run the handlers on a copy, without the lock, so they can attach and
+    // detach handlers themselves
+    std::map<GPIOIntHandler,void*> listeners;
+    if (edge && m_listeners.size() > 0)
+    {
+        listeners = m_listeners;
+        m_numInterrupts++;
+    }
+
+    pthread_mutex_unlock (&m_pinMutex);
+
+    if (listeners.size() == 0)
+        return;
+
+    EMBED_TRACE_SCOPE("gpio", "SimGPIO::intHandler", listeners.size());
+    std::map<GPIOIntHandler,void*>::iterator it;
+    for (it = listeners.begin(); it != listeners.end(); it++)
+        it->first (it->second);
+}
@@ -159,10 +159,14 @@ void* BBBIntThread::threadMain(void* _data)
 {
     BBBIntThread* _this = static_cast<BBBIntThread*>(_data);
 
+    EMBED_TRACE_THREAD_NAME("BBBIntThread");
+
     char buf[MAX_BUF];
     while(1)
     {
         int32_t rc = poll(&(_this->m_fds[0]), _this->m_fds.size(), POLL_TIMEOUT_MS);
+        // The number of fds ready, 0 for a timeout
+        EMBED_TRACE_INSTANT("int", "BBBIntThread::wakeup", rc);
 
         if (rc < 0)
         {
@@ -182,6 +186,8 @@ void* BBBIntThread::threadMain(void* _data)
             // Check for interrupt
             if (it->revents & POLLPRI)
             {
+                EMBED_TRACE_SCOPE("int", "BBBIntThread::dispatch", it->fd);
+
                 // Acknowledge interrupt
                 read(it->fd, buf, MAX_BUF);
 
@@ -0,0 +1,135 @@
+/*
+ * Filename: biquad_filter.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for a cascaded biquad IIR filter
+ */
+
+#include <math.h>
+#include <assert.h>
+
+#include "biquad_filter.h"
+
+using namespace embed;
+
+BiquadFilter::BiquadFilter (const BiquadCoeffs* _sections, uint32_t _numSections) :
+    m_numSections (_numSections),
+    m_sections (_sections, _sections + _numSections),
+    m_state (2 * _numSections)
+{
+    assert (m_numSections > 0);
+
+    reset();
+}
+
+BiquadFilter::~BiquadFilter ()
+{
+}
+
+BiquadFilter::BiquadCoeffs BiquadFilter::designLowPass (double _cutoff, double _q)
+{
+    // Bilinear transform of the analog prototype (RBJ audio EQ cookbook)
+    double w0 = 2.0 * M_PI * _cutoff;
+    double alpha = sin(w0) / (2.0 * _q);
+    double cosW0 = cos(w0);
+    double a0 = 1.0 + alpha;
+
+    BiquadCoeffs coeffs;
+    coeffs.m_b0 = (1.0 - cosW0) / 2.0 / a0;
+    coeffs.m_b1 = (1.0 - cosW0) / a0;
+    coeffs.m_b2 = (1.0 - cosW0) / 2.0 / a0;
+    coeffs.m_a1 = -2.0 * cosW0 / a0;
+    coeffs.m_a2 = (1.0 - alpha) / a0;
+    return coeffs;
+}
+
+void BiquadFilter::designButterworthLowPass (double _cutoff, uint32_t _order, BiquadCoeffs* _sections)
+{
+    assert (_order > 0 && _order % 2 == 0);
+
+    // Each section takes a conjugate pair of the Butterworth poles
+    for (uint32_t k = 0; k < _order / 2; k++)
+    {
+        double theta = M_PI * (2.0 * k + 1.0) / (2.0 * _order);
+        _sections[k] = designLowPass(_cutoff, 1.0 / (2.0 * cos(theta)));
+    }
+}
+
+void BiquadFilter::reset ()
+{
+    m_primed = false;
+    m_output = nan("");
+}
+
+void BiquadFilter::addValue (double _val)
+{
+    process(&_val, 1, &m_output);
+}
+
+void BiquadFilter::addValues (const double* _vals, size_t _num)
+{
+    for (size_t i = 0; i < _num; i++)
+        addValue(_vals[i]);
+}
+
+double BiquadFilter::getAvg ()
+{
+    return m_output;
+}
+
+double BiquadFilter::getStdDev ()
+{
+    return nan("");
+}
+
+void BiquadFilter::process (const double* _in, size_t _num, double* _out)
+{
+    if (_num == 0)
+        return;
+
+    if (!m_primed)
+        prime(_in[0]);
+
+    const double* in = _in;
+    for (uint32_t s = 0; s < m_numSections; s++)
+    {
+        const BiquadCoeffs& c = m_sections[s];
+        double s1 = m_state[2 * s];
+        double s2 = m_state[2 * s + 1];
+
+        for (size_t i = 0; i < _num; i++)
+        {
+            double x = in[i];
+            double y = c.m_b0 * x + s1;
+            s1 = c.m_b1 * x - c.m_a1 * y + s2;
+            s2 = c.m_b2 * x - c.m_a2 * y;
+            _out[i] = y;
+        }
+
+        m_state[2 * s] = s1;
+        m_state[2 * s + 1] = s2;
+
+        // Later sections work in place on the output
+        in = _out;
+    }
+
+    m_output = _out[_num - 1];
+}
+
+void BiquadFilter::prime (double _val)
+{
+    // Steady state of each section for a constant input, which is the
+    // previous section's steady state output
+    double x = _val;
+    for (uint32_t s = 0; s < m_numSections; s++)
+    {
+        const BiquadCoeffs& c = m_sections[s];
+        double y = x * (c.m_b0 + c.m_b1 + c.m_b2) / (1.0 + c.m_a1 + c.m_a2);
+        double s2 = c.m_b2 * x - c.m_a2 * y;
+        m_state[2 * s] = c.m_b1 * x - c.m_a1 * y + s2;
+        m_state[2 * s + 1] = s2;
+        x = y;
+    }
+
+    m_primed = true;
+}
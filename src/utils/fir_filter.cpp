@@ -0,0 +1,125 @@
+/*
+ * Filename: fir_filter.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for a decimating FIR filter
+ */
+
+#include <math.h>
+#include <assert.h>
+
+#include "fir_filter.h"
+#include "reduce.h"
+
+using namespace embed;
+
+FirFilter::FirFilter (const double* _taps, uint32_t _numTaps, uint32_t _decimation) :
+    m_numTaps (_numTaps),
+    m_decimation (_decimation),
+    m_taps (_numTaps),
+    m_delay (2 * _numTaps)
+{
+    assert (m_numTaps > 0);
+    assert (m_decimation > 0);
+
+    for (uint32_t i = 0; i < m_numTaps; i++)
+        m_taps[i] = _taps[m_numTaps - 1 - i];
+
+    reset();
+}
+
+FirFilter::~FirFilter ()
+{
+}
+
+void FirFilter::designLowPass (double _cutoff, uint32_t _numTaps, double* _taps)
+{
+    // Ideal low-pass impulse response shaped by a Blackman window
+    double center = (_numTaps - 1) / 2.0;
+    double sum = 0.0;
+    for (uint32_t i = 0; i < _numTaps; i++)
+    {
+        double n = i - center;
+        double ideal = (n == 0.0) ? 2.0 * _cutoff : sin(2.0 * M_PI * _cutoff * n) / (M_PI * n);
+        double window = (_numTaps > 1) ?
+            0.42 - 0.5 * cos(2.0 * M_PI * i / (_numTaps - 1)) + 0.08 * cos(4.0 * M_PI * i / (_numTaps - 1)) : 1.0;
+        _taps[i] = ideal * window;
+        sum += _taps[i];
+    }
+
+    for (uint32_t i = 0; i < _numTaps; i++)
+        _taps[i] /= sum;
+}
+
+void FirFilter::reset ()
+{
+    m_pos = 0;
+    m_phase = 0;
+    m_primed = false;
+    m_output = nan("");
+}
+
+void FirFilter::addValue (double _val)
+{
+    if (push(_val))
+        m_output = output();
+}
+
+void FirFilter::addValues (const double* _vals, size_t _num)
+{
+    for (size_t i = 0; i < _num; i++)
+    {
+        if (push(_vals[i]))
+            m_output = output();
+    }
+}
+
+double FirFilter::getAvg ()
+{
+    return m_output;
+}
+
+double FirFilter::getStdDev ()
+{
+    return nan("");
+}
+
+size_t FirFilter::process (const double* _in, size_t _num, double* _out)
+{
+    size_t numOut = 0;
+    for (size_t i = 0; i < _num; i++)
+    {
+        if (push(_in[i]))
+        {
+            m_output = output();
+            _out[numOut++] = m_output;
+        }
+    }
+
+    return numOut;
+}
+
+bool FirFilter::push (double _val)
+{
+    if (!m_primed)
+    {
+        for (uint32_t i = 0; i < 2 * m_numTaps; i++)
+            m_delay[i] = _val;
+        m_primed = true;
+    }
+
+    // Each sample is written to both copies, the window for the newest
+    // sample is then m_delay[m_pos, m_pos + m_numTaps) oldest first
+    m_delay[m_pos] = _val;
+    m_delay[m_pos + m_numTaps] = _val;
+    m_pos = (m_pos + 1 == m_numTaps) ? 0 : m_pos + 1;
+
+    bool due = (m_phase == 0);
+    m_phase = (m_phase + 1 == m_decimation) ? 0 : m_phase + 1;
+    return due;
+}
+
+double FirFilter::output () const
+{
+    return reduceDot(&m_taps[0], &m_delay[m_pos], m_numTaps);
+}
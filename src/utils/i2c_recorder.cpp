@@ -0,0 +1,253 @@
+/*
+ * Filename: i2c_recorder.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the recording I2C bus wrapper
+ */
+
+#include "i2c_recorder.h"
+
+using namespace embed;
+
+I2CRecorder::I2CRecorder (I2C* _bus, const char* _path, Clock* _clock, const uint32_t _bufferSize) :
+    m_bus (_bus),
+    m_path (_path),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_fd (-1),
+    m_buffer (_bufferSize),
+    m_bufferLen (0),
+    m_spare (_bufferSize),
+    m_spareLen (0),
+    m_lastTimeUs (0),
+    m_numTransactions (0),
+    m_numBytes (0),
+    m_recordMutex (),
+    m_writeMutex ()
+{
+    pthread_mutex_init (&m_recordMutex, NULL);
+    pthread_mutex_init (&m_writeMutex, NULL);
+}
+
+I2CRecorder::~I2CRecorder ()
+{
+    destroy();
+    pthread_mutex_destroy (&m_writeMutex);
+    pthread_mutex_destroy (&m_recordMutex);
+}
+
+bool I2CRecorder::init ()
+{
+    if (m_fd != -1)
+        return true;
+
+    if ((m_fd = open(m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0)
+    {
+        fprintf(stderr, "I2CRecorder::init open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    if (!m_bus->init())
+    {
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    pthread_mutex_lock (&m_recordMutex);
+
+    // A new trace needs its header, an existing one gets another session
+    m_bufferLen = 0;
+    if (lseek(m_fd, 0, SEEK_END) == 0)
+    {
+        memcpy (&m_buffer[0], I2C_TRACE_MAGIC, sizeof(I2C_TRACE_MAGIC));
+        m_buffer[sizeof(I2C_TRACE_MAGIC)] = I2C_TRACE_VERSION;
+        m_bufferLen = I2C_TRACE_HEADER_SIZE;
+    }
+
+    m_lastTimeUs = m_clock->nowUs();
+    bool full = beginRecord (I2C_TRACE_SYNC, m_lastTimeUs, VARINT_MAX_BYTES);
+    m_bufferLen += encodeVarint (m_lastTimeUs, &m_buffer[m_bufferLen]);
+
+    pthread_mutex_unlock (&m_recordMutex);
+
+    if (full)
+        writeSpare();
+
+    return true;
+}
+
+void I2CRecorder::destroy ()
+{
+    pthread_mutex_lock (&m_recordMutex);
+
+    if (m_fd == -1)
+    {
+        pthread_mutex_unlock (&m_recordMutex);
+        return;
+    }
+
+    // Waits for a handed over buffer to be written first
+    flushLocked();
+    pthread_mutex_lock (&m_writeMutex);
+    close(m_fd);
+    m_fd = -1;
+    pthread_mutex_unlock (&m_writeMutex);
+
+    pthread_mutex_unlock (&m_recordMutex);
+
+    m_bus->destroy();
+}
+
+uint8_t I2CRecorder::readReg (const uint8_t _addr, const uint8_t _reg)
+{
+    uint8_t val = m_bus->readReg(_addr, _reg);
+
+    pthread_mutex_lock (&m_recordMutex);
+
+    bool full = false;
+    if (m_fd != -1)
+    {
+        full = beginRecord (I2C_TRACE_READ, m_clock->nowUs(), 3);
+        m_buffer[m_bufferLen++] = _addr;
+        m_buffer[m_bufferLen++] = _reg;
+        m_buffer[m_bufferLen++] = val;
+    }
+
+    pthread_mutex_unlock (&m_recordMutex);
+
+    if (full)
+        writeSpare();
+
+    return val;
+}
+
+void I2CRecorder::writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val)
+{
+    pthread_mutex_lock (&m_recordMutex);
+
+    bool full = false;
+    if (m_fd != -1)
+    {
+        full = beginRecord (I2C_TRACE_WRITE, m_clock->nowUs(), 3);
+        m_buffer[m_bufferLen++] = _addr;
+        m_buffer[m_bufferLen++] = _reg;
+        m_buffer[m_bufferLen++] = _val;
+    }
+
+    pthread_mutex_unlock (&m_recordMutex);
+
+    if (full)
+        writeSpare();
+
+    m_bus->writeReg(_addr, _reg, _val);
+}
+
+void I2CRecorder::readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+{
+    m_bus->readRegs(_addr, _reg, _buf, _len);
+
+    pthread_mutex_lock (&m_recordMutex);
+
+    bool full = false;
+    if (m_fd != -1)
+    {
+        full = beginRecord (I2C_TRACE_READ_BURST, m_clock->nowUs(), 2 + VARINT_MAX_BYTES + _len);
+        m_buffer[m_bufferLen++] = _addr;
+        m_buffer[m_bufferLen++] = _reg;
+        m_bufferLen += encodeVarint (_len, &m_buffer[m_bufferLen]);
+        memcpy (&m_buffer[m_bufferLen], _buf, _len);
+        m_bufferLen += _len;
+    }
+
+    pthread_mutex_unlock (&m_recordMutex);
+
+    if (full)
+        writeSpare();
+}
+
+bool I2CRecorder::flush ()
+{
+    pthread_mutex_lock (&m_recordMutex);
+    bool success = flushLocked();
+    pthread_mutex_unlock (&m_recordMutex);
+
+    return success;
+}
+
+bool I2CRecorder::beginRecord (I2C_TRACE_RECORD _type, uint64_t _timeUs, uint32_t _maxSize)
+{
+    // Make room for the whole record so the payload can be written without
+    // checks, growing the buffer for bursts longer than it. A full buffer
+    // is swapped for the spare, once any earlier one has been written, and
+    // the write lock stays held until the caller writes it.
+    bool full = false;
+    uint32_t maxSize = VARINT_MAX_BYTES + _maxSize;
+    if (m_bufferLen + maxSize > m_buffer.size())
+    {
+        if (m_bufferLen > 0)
+        {
+            pthread_mutex_lock (&m_writeMutex);
+            m_buffer.swap(m_spare);
+            m_spareLen = m_bufferLen;
+            m_bufferLen = 0;
+            full = true;
+        }
+        if (maxSize > m_buffer.size())
+            m_buffer.resize(maxSize);
+    }
+
+    // A SYNC record carries the absolute time instead of a delta
+    uint64_t deltaUs = 0;
+    if (_type != I2C_TRACE_SYNC && _timeUs > m_lastTimeUs)
+        deltaUs = _timeUs - m_lastTimeUs;
+    if (_timeUs > m_lastTimeUs)
+        m_lastTimeUs = _timeUs;
+
+    m_bufferLen += encodeVarint ((deltaUs << I2C_TRACE_TYPE_BITS) | _type, &m_buffer[m_bufferLen]);
+    if (_type != I2C_TRACE_SYNC)
+        m_numTransactions++;
+
+    return full;
+}
+
+void I2CRecorder::writeSpare ()
+{
+    // The write lock was taken when the buffer was handed over
+    writeBuffer (&m_spare[0], m_spareLen);
+    m_spareLen = 0;
+    pthread_mutex_unlock (&m_writeMutex);
+}
+
+bool I2CRecorder::flushLocked ()
+{
+    if (m_fd == -1)
+        return false;
+
+    pthread_mutex_lock (&m_writeMutex);
+    bool success = writeBuffer (&m_buffer[0], m_bufferLen);
+    m_bufferLen = 0;
+    pthread_mutex_unlock (&m_writeMutex);
+
+    return success;
+}
+
+bool I2CRecorder::writeBuffer (const uint8_t* _buf, const uint32_t _len)
+{
+    uint32_t written = 0;
+    while (written < _len)
+    {
+        ssize_t rc = write(m_fd, &_buf[written], _len - written);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+        {
+            fprintf(stderr, "I2CRecorder::flush write error: %s\n", strerror(errno));
+            return false;
+        }
+        written += rc;
+    }
+
+    m_numBytes += _len;
+
+    return true;
+}
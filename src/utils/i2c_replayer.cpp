@@ -0,0 +1,285 @@
+/*
+ * Filename: i2c_replayer.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the trace replaying I2C bus
+ */
+
+#include "i2c_replayer.h"
+
+using namespace embed;
+
+static const char* RECORD_NAMES[I2C_TRACE_RECORD_NUM] = {"sync", "read", "write", "burst read"};
+
+I2CReplayer::I2CReplayer (const char* _path, Clock* _clock) :
+    m_path (_path),
+    m_clock (_clock),
+    m_initialized (false),
+    m_transactions (),
+    m_data (),
+    m_position (0),
+    m_numMismatches (0),
+    m_sessionStartUs (0),
+    m_sessionPosition (UINT32_MAX),
+    m_replayMutex ()
+{
+    pthread_mutex_init (&m_replayMutex, NULL);
+}
+
+I2CReplayer::~I2CReplayer ()
+{
+    m_transactions.clear();
+    m_data.clear();
+    pthread_mutex_destroy (&m_replayMutex);
+}
+
+bool I2CReplayer::init ()
+{
+    if (m_initialized)
+        return true;
+
+    int32_t fd = open(m_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "I2CReplayer::init open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        fprintf(stderr, "I2CReplayer::init fstat error: %s\n", strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    std::vector<uint8_t> buf(st.st_size);
+    size_t num = 0;
+    while (num < buf.size())
+    {
+        ssize_t rc = read(fd, &buf[num], buf.size() - num);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+        {
+            fprintf(stderr, "I2CReplayer::init read error: %s\n", strerror(errno));
+            close(fd);
+            return false;
+        }
+        num += rc;
+    }
+    close(fd);
+
+    if (buf.size() < I2C_TRACE_HEADER_SIZE ||
+        memcmp (&buf[0], I2C_TRACE_MAGIC, sizeof(I2C_TRACE_MAGIC)) != 0)
+    {
+        fprintf(stderr, "I2CReplayer::init %s is not an I2C trace\n", m_path.c_str());
+        return false;
+    }
+
+    if (buf[sizeof(I2C_TRACE_MAGIC)] != I2C_TRACE_VERSION)
+    {
+        fprintf(stderr, "I2CReplayer::init unsupported trace version %d\n", buf[sizeof(I2C_TRACE_MAGIC)]);
+        return false;
+    }
+
+    if (!parse(&buf[I2C_TRACE_HEADER_SIZE], &buf[0] + buf.size()))
+        return false;
+
+    rewind();
+    m_initialized = true;
+
+    return true;
+}
+
+void I2CReplayer::destroy ()
+{
+    pthread_mutex_lock (&m_replayMutex);
+    m_transactions.clear();
+    m_data.clear();
+    m_position = 0;
+    m_initialized = false;
+    pthread_mutex_unlock (&m_replayMutex);
+}
+
+uint8_t I2CReplayer::readReg (const uint8_t _addr, const uint8_t _reg)
+{
+    waitForNext();
+    pthread_mutex_lock (&m_replayMutex);
+
+    uint8_t val = 0;
+    const Transaction* t = next (I2C_TRACE_READ, _addr, _reg, 1, NULL, "readReg");
+    if (t != NULL)
+        val = m_data[t->m_dataOffset];
+
+    pthread_mutex_unlock (&m_replayMutex);
+
+    return val;
+}
+
+void I2CReplayer::writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val)
+{
+    waitForNext();
+    pthread_mutex_lock (&m_replayMutex);
+    next (I2C_TRACE_WRITE, _addr, _reg, 1, &_val, "writeReg");
+    pthread_mutex_unlock (&m_replayMutex);
+}
+
+void I2CReplayer::readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+{
+    waitForNext();
+    pthread_mutex_lock (&m_replayMutex);
+
+    memset (_buf, 0, _len);
+    const Transaction* t = next (I2C_TRACE_READ_BURST, _addr, _reg, _len, NULL, "readRegs");
+    if (t != NULL)
+        memcpy (_buf, &m_data[t->m_dataOffset], _len);
+
+    pthread_mutex_unlock (&m_replayMutex);
+}
+
+void I2CReplayer::rewind ()
+{
+    pthread_mutex_lock (&m_replayMutex);
+    m_position = 0;
+    m_numMismatches = 0;
+    m_sessionStartUs = (m_clock != NULL) ? m_clock->nowUs() : 0;
+    m_sessionPosition = UINT32_MAX;
+    pthread_mutex_unlock (&m_replayMutex);
+}
+
+bool I2CReplayer::finished ()
+{
+    pthread_mutex_lock (&m_replayMutex);
+    bool done = m_position >= m_transactions.size();
+    pthread_mutex_unlock (&m_replayMutex);
+
+    return done;
+}
+
+bool I2CReplayer::parse (const uint8_t* _buf, const uint8_t* _end)
+{
+    m_transactions.clear();
+    m_data.clear();
+
+    const uint8_t* p = _buf;
+    uint64_t timeUs = 0;
+    bool sessionStart = false;
+    while (p < _end)
+    {
+        uint64_t header;
+        if (!decodeVarint(p, _end, &header))
+            break;
+
+        I2C_TRACE_RECORD type = (I2C_TRACE_RECORD) (header & ((1 << I2C_TRACE_TYPE_BITS) - 1));
+        timeUs += header >> I2C_TRACE_TYPE_BITS;
+
+        if (type == I2C_TRACE_SYNC)
+        {
+            // Times within a session are relative to its start
+            uint64_t absUs;
+            if (!decodeVarint(p, _end, &absUs))
+                break;
+            timeUs = 0;
+            sessionStart = true;
+            continue;
+        }
+
+        Transaction t;
+        t.m_timeUs = timeUs;
+        t.m_sessionStart = sessionStart;
+        t.m_type = type;
+        if (_end - p < 2)
+            break;
+        t.m_addr = *p++;
+        t.m_reg = *p++;
+        t.m_len = 1;
+        if (type == I2C_TRACE_READ_BURST)
+        {
+            uint64_t len;
+            if (!decodeVarint(p, _end, &len))
+                break;
+            t.m_len = (uint32_t) len;
+        }
+        if ((uint64_t) (_end - p) < t.m_len)
+            break;
+
+        t.m_dataOffset = m_data.size();
+        m_data.insert(m_data.end(), p, p + t.m_len);
+        p += t.m_len;
+
+        m_transactions.push_back(t);
+        sessionStart = false;
+    }
+
+    // The recorder may have been stopped mid write, keep what is complete
+    if (p < _end)
+        fprintf(stderr, "I2CReplayer::init trace truncated after %u transactions\n",
+                (uint32_t) m_transactions.size());
+
+    return true;
+}
+
+void I2CReplayer::waitForNext ()
+{
+    if (m_clock == NULL)
+        return;
+
+    pthread_mutex_lock (&m_replayMutex);
+
+    if (m_position >= m_transactions.size())
+    {
+        pthread_mutex_unlock (&m_replayMutex);
+        return;
+    }
+
+    // Sessions start when their first transaction is replayed
+    const Transaction& t = m_transactions[m_position];
+    uint64_t nowUs = m_clock->nowUs();
+    if (t.m_sessionStart && m_position != m_sessionPosition)
+    {
+        m_sessionStartUs = nowUs - t.m_timeUs;
+        m_sessionPosition = m_position;
+    }
+    uint64_t dueUs = m_sessionStartUs + t.m_timeUs;
+
+    pthread_mutex_unlock (&m_replayMutex);
+
+    // Not holding the lock, a virtual clock runs timers that may use the bus
+    if (dueUs > nowUs)
+        m_clock->sleepUs(dueUs - nowUs);
+}
+
+const I2CReplayer::Transaction* I2CReplayer::next (I2C_TRACE_RECORD _type, const uint8_t _addr,
+                                                   const uint8_t _reg, const uint32_t _len,
+                                                   const uint8_t* _writeVal, const char* _caller)
+{
+    if (m_position >= m_transactions.size())
+    {
+        if (m_numMismatches++ == 0)
+            fprintf(stderr, "I2CReplayer::%s past the end of the trace\n", _caller);
+        return NULL;
+    }
+
+    const Transaction* t = &m_transactions[m_position++];
+
+    if (t->m_type != _type || t->m_addr != _addr || t->m_reg != _reg || t->m_len != _len ||
+        (_writeVal != NULL && m_data[t->m_dataOffset] != (*_writeVal)))
+    {
+        if (m_numMismatches++ == 0 && _writeVal != NULL && t->m_type == _type)
+            fprintf(stderr, "I2CReplayer::%s transaction %u mismatch: recorded 0x%02x to 0x%02x reg 0x%02x, "
+                    "replayed 0x%02x to 0x%02x reg 0x%02x\n", _caller, m_position - 1,
+                    m_data[t->m_dataOffset], t->m_addr, t->m_reg, (*_writeVal), _addr, _reg);
+        else if (m_numMismatches == 1)
+            fprintf(stderr, "I2CReplayer::%s transaction %u mismatch: recorded %s 0x%02x reg 0x%02x "
+                    "len %u, replayed %s 0x%02x reg 0x%02x len %u\n", _caller, m_position - 1,
+                    RECORD_NAMES[t->m_type], t->m_addr, t->m_reg, t->m_len,
+                    RECORD_NAMES[_type], _addr, _reg, _len);
+
+        // Reads of a different length cannot use the recorded values
+        if (t->m_type != _type || t->m_len != _len)
+            return NULL;
+    }
+
+    return t;
+}
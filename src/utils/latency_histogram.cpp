@@ -0,0 +1,130 @@
+/*
+ * Filename: latency_histogram.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for a log-linear latency histogram
+ */
+
+#include <math.h>
+
+#include "latency_histogram.h"
+
+using namespace embed;
+
+LatencyHistogram::LatencyHistogram () :
+    m_count (0),
+    m_min (UINT32_MAX),
+    m_max (0),
+    m_sum (0)
+{
+    memset (m_buckets, 0, sizeof(m_buckets));
+}
+
+LatencyHistogram::~LatencyHistogram ()
+{
+}
+
+void LatencyHistogram::reset ()
+{
+    memset (m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_min = UINT32_MAX;
+    m_max = 0;
+    m_sum = 0;
+}
+
+void LatencyHistogram::addValue (uint32_t _us)
+{
+    m_buckets[bucketIndex(_us)]++;
+    m_count++;
+    m_sum += _us;
+    if (_us < m_min)
+        m_min = _us;
+    if (_us > m_max)
+        m_max = _us;
+}
+
+void LatencyHistogram::merge (const LatencyHistogram& _other)
+{
+    for (uint32_t i = 0; i < NUM_BUCKETS; i++)
+        m_buckets[i] += _other.m_buckets[i];
+    m_count += _other.m_count;
+    m_sum += _other.m_sum;
+    if (_other.m_min < m_min)
+        m_min = _other.m_min;
+    if (_other.m_max > m_max)
+        m_max = _other.m_max;
+}
+
+double LatencyHistogram::getMean () const
+{
+    if (m_count == 0)
+        return 0.0;
+
+    return ((double) m_sum) / ((double) m_count);
+}
+
+uint32_t LatencyHistogram::getPercentile (double _percentile) const
+{
+    if (m_count == 0)
+        return 0;
+
+    // Nearest rank, the smallest rank covering _percentile of the samples
+    uint64_t rank = (uint64_t) ceil(_percentile * m_count / 100.0);
+    if (rank < 1)
+        rank = 1;
+    if (rank > m_count)
+        rank = m_count;
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < NUM_BUCKETS; i++)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+        {
+            // Report the bucket's upper bound, clamped to what was observed
+            uint32_t value = bucketUpperBound(i);
+            if (value > m_max)
+                value = m_max;
+            if (value < m_min)
+                value = m_min;
+            return value;
+        }
+    }
+
+    return m_max;
+}
+
+void LatencyHistogram::getSummary (Summary* _summary) const
+{
+    _summary->m_count = m_count;
+    _summary->m_minUs = getMin();
+    _summary->m_p50Us = getPercentile(50.0);
+    _summary->m_p99Us = getPercentile(99.0);
+    _summary->m_maxUs = m_max;
+    _summary->m_meanUs = getMean();
+}
+
+uint32_t LatencyHistogram::bucketIndex (uint32_t _us)
+{
+    // Values below SUB_BUCKETS get a bucket each
+    if (_us < SUB_BUCKETS)
+        return _us;
+
+    // Otherwise the top SUB_BUCKET_BITS bits below the MSB pick the
+    // sub-bucket within the power of two range
+    uint32_t msb = 31 - __builtin_clz(_us);
+    uint32_t shift = msb - SUB_BUCKET_BITS;
+    return ((msb - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) + ((_us >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint32_t LatencyHistogram::bucketUpperBound (uint32_t _index)
+{
+    if (_index < SUB_BUCKETS)
+        return _index;
+
+    uint32_t shift = (_index >> SUB_BUCKET_BITS) - 1;
+    uint64_t lower = ((uint64_t) (SUB_BUCKETS + (_index & (SUB_BUCKETS - 1)))) << shift;
+    uint64_t upper = lower + (((uint64_t) 1) << shift) - 1;
+    return upper > UINT32_MAX ? UINT32_MAX : (uint32_t) upper;
+}
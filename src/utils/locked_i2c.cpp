@@ -0,0 +1,76 @@
+/*
+ * Filename: locked_i2c.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the serializing I2C bus wrapper
+ */
+
+#include "locked_i2c.h"
+
+using namespace embed;
+
+LockedI2C::LockedI2C (I2C* _bus) :
+    m_bus (_bus),
+    m_busMutex ()
+{
+    // Recursive so a held bus can still run transactions
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init (&mutexAttr);
+    pthread_mutexattr_settype (&mutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&m_busMutex, &mutexAttr);
+    pthread_mutexattr_destroy (&mutexAttr);
+}
+
+LockedI2C::~LockedI2C ()
+{
+    pthread_mutex_destroy (&m_busMutex);
+}
+
+bool LockedI2C::init ()
+{
+    pthread_mutex_lock (&m_busMutex);
+    bool success = m_bus->init();
+    pthread_mutex_unlock (&m_busMutex);
+
+    return success;
+}
+
+void LockedI2C::destroy ()
+{
+    pthread_mutex_lock (&m_busMutex);
+    m_bus->destroy();
+    pthread_mutex_unlock (&m_busMutex);
+}
+
+uint8_t LockedI2C::readReg (const uint8_t _addr, const uint8_t _reg)
+{
+    pthread_mutex_lock (&m_busMutex);
+    uint8_t val = m_bus->readReg(_addr, _reg);
+    pthread_mutex_unlock (&m_busMutex);
+
+    return val;
+}
+
+void LockedI2C::writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val)
+{
+    pthread_mutex_lock (&m_busMutex);
+    m_bus->writeReg(_addr, _reg, _val);
+    pthread_mutex_unlock (&m_busMutex);
+}
+
+void LockedI2C::readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+{
+    pthread_mutex_lock (&m_busMutex);
+    m_bus->readRegs(_addr, _reg, _buf, _len);
+    pthread_mutex_unlock (&m_busMutex);
+}
+
+void LockedI2C::lock ()
+{
+    pthread_mutex_lock (&m_busMutex);
+}
+
+void LockedI2C::unlock ()
+{
+    pthread_mutex_unlock (&m_busMutex);
+}
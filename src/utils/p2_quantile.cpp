@@ -0,0 +1,131 @@
+/*
+ * Filename: p2_quantile.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for a P-squared streaming quantile
+ *              estimator
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#include "p2_quantile.h"
+
+using namespace embed;
+
+P2Quantile::P2Quantile (double _quantile) :
+    m_quantile (_quantile)
+{
+    reset();
+}
+
+P2Quantile::~P2Quantile ()
+{
+}
+
+void P2Quantile::reset ()
+{
+    m_count = 0;
+    for (uint32_t i = 0; i < NUM_MARKERS; i++)
+    {
+        m_heights[i] = 0.0;
+        m_positions[i] = i;
+    }
+
+    m_desired[0] = 0.0;
+    m_desired[1] = 2.0 * m_quantile;
+    m_desired[2] = 4.0 * m_quantile;
+    m_desired[3] = 2.0 + 2.0 * m_quantile;
+    m_desired[4] = 4.0;
+
+    m_increments[0] = 0.0;
+    m_increments[1] = m_quantile / 2.0;
+    m_increments[2] = m_quantile;
+    m_increments[3] = (1.0 + m_quantile) / 2.0;
+    m_increments[4] = 1.0;
+}
+
+void P2Quantile::addValue (double _val)
+{
+    // The first samples are kept as they are and become the markers
+    if (m_count < NUM_MARKERS)
+    {
+        m_heights[m_count++] = _val;
+        if (m_count == NUM_MARKERS)
+            std::sort(m_heights, m_heights + NUM_MARKERS);
+        return;
+    }
+    m_count++;
+
+    // Find the cell the sample falls in, extending the extremes if needed
+    uint32_t cell;
+    if (_val < m_heights[0])
+    {
+        m_heights[0] = _val;
+        cell = 0;
+    }
+    else if (_val >= m_heights[NUM_MARKERS - 1])
+    {
+        m_heights[NUM_MARKERS - 1] = _val;
+        cell = NUM_MARKERS - 2;
+    }
+    else
+    {
+        cell = 0;
+        while (_val >= m_heights[cell + 1])
+            cell++;
+    }
+
+    for (uint32_t i = cell + 1; i < NUM_MARKERS; i++)
+        m_positions[i] += 1.0;
+    for (uint32_t i = 0; i < NUM_MARKERS; i++)
+        m_desired[i] += m_increments[i];
+
+    // Move the middle markers one position towards where they should be
+    for (uint32_t i = 1; i < NUM_MARKERS - 1; i++)
+    {
+        double offset = m_desired[i] - m_positions[i];
+        if ((offset >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0) ||
+            (offset <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0))
+        {
+            int32_t d = (offset > 0.0) ? 1 : -1;
+            double height = parabolic(i, d);
+            if (m_heights[i - 1] < height && height < m_heights[i + 1])
+                m_heights[i] = height;
+            else
+                m_heights[i] = linear(i, d);
+            m_positions[i] += d;
+        }
+    }
+}
+
+double P2Quantile::getQuantile () const
+{
+    if (m_count == 0)
+        return nan("");
+
+    if (m_count >= NUM_MARKERS)
+        return m_heights[2];
+
+    // Too few samples for the markers, pick the nearest rank directly
+    double sorted[NUM_MARKERS];
+    std::copy(m_heights, m_heights + m_count, sorted);
+    std::sort(sorted, sorted + m_count);
+    uint32_t rank = (uint32_t) (m_quantile * (m_count - 1) + 0.5);
+    return sorted[rank];
+}
+
+double P2Quantile::parabolic (uint32_t _i, double _d) const
+{
+    const double* q = m_heights;
+    const double* n = m_positions;
+
+    return q[_i] + _d / (n[_i + 1] - n[_i - 1]) *
+        ((n[_i] - n[_i - 1] + _d) * (q[_i + 1] - q[_i]) / (n[_i + 1] - n[_i]) +
+         (n[_i + 1] - n[_i] - _d) * (q[_i] - q[_i - 1]) / (n[_i] - n[_i - 1]));
+}
+
+double P2Quantile::linear (uint32_t _i, int32_t _d) const
+{
+    return m_heights[_i] + _d * (m_heights[_i + _d] - m_heights[_i]) / (m_positions[_i + _d] - m_positions[_i]);
+}
@@ -0,0 +1,237 @@
+/*
+ * Filename: sample_block_decoder.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the compressed sample archive reader
+ */
+
+#include "sample_block_decoder.h"
+
+using namespace embed;
+
+// Most values fit in a byte, so that case skips the varint loop
+static inline bool decodeZigzag (const uint8_t*& _buf, const uint8_t* _end, int64_t* _val)
+{
+    if (_buf < _end && *_buf < 0x80)
+    {
+        (*_val) = zigzagDecode (*_buf++);
+        return true;
+    }
+
+    uint64_t val;
+    if (!decodeVarint (_buf, _end, &val))
+        return false;
+
+    (*_val) = zigzagDecode (val);
+    return true;
+}
+
+SampleBlockDecoder::SampleBlockDecoder (const char* _path) :
+    m_path (_path),
+    m_map (NULL),
+    m_mapSize (0),
+    m_index (),
+    m_numSamples (0),
+    m_scratch ()
+{
+}
+
+SampleBlockDecoder::~SampleBlockDecoder ()
+{
+    destroy();
+}
+
+bool SampleBlockDecoder::init ()
+{
+    if (m_map != NULL)
+        return true;
+
+    int32_t fd = open(m_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "SampleBlockDecoder::init open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < SAMPLE_BLOCK_FILE_HEADER_SIZE)
+    {
+        fprintf(stderr, "SampleBlockDecoder::init %s is too short\n", m_path.c_str());
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "SampleBlockDecoder::init mmap error: %s\n", strerror(errno));
+        return false;
+    }
+
+    const uint8_t* buf = static_cast<const uint8_t*>(map);
+    if (memcmp (buf, SAMPLE_BLOCK_MAGIC, sizeof(SAMPLE_BLOCK_MAGIC)) != 0 ||
+        buf[sizeof(SAMPLE_BLOCK_MAGIC)] != SAMPLE_BLOCK_VERSION)
+    {
+        fprintf(stderr, "SampleBlockDecoder::init %s is not a version %u sample archive\n",
+                m_path.c_str(), SAMPLE_BLOCK_VERSION);
+        munmap (map, st.st_size);
+        return false;
+    }
+
+    m_map = static_cast<uint8_t*>(map);
+    m_mapSize = st.st_size;
+
+    // Index the block headers, stopping at a partial block or a header
+    // that cannot be right, as m_size can no longer be trusted to find the
+    // next one. Every sample takes at least a byte in the pressure and temp
+    // columns, all but the first in the time column, and the OSSR column
+    // has at least one pair.
+    m_index.clear();
+    m_numSamples = 0;
+    uint32_t maxSamples = 0;
+    const uint8_t* end = m_map + m_mapSize;
+    const uint8_t* p = m_map + SAMPLE_BLOCK_FILE_HEADER_SIZE;
+    while (p < end)
+    {
+        BlockIndex entry;
+        if ((size_t) (end - p) < sizeof(SampleBlockHeader))
+            break;
+        memcpy (&entry.m_header, p, sizeof(SampleBlockHeader));
+        p += sizeof(SampleBlockHeader);
+
+        const SampleBlockHeader& header = entry.m_header;
+        uint64_t num = header.m_numSamples;
+        if ((size_t) (end - p) < header.m_size ||
+            ((uint64_t) header.m_timeSize) + header.m_pressureSize + header.m_tempSize > header.m_size ||
+            (num > 0 && (header.m_timeSize < num - 1 || header.m_pressureSize < num || header.m_tempSize < num ||
+                         header.m_size - header.m_timeSize - header.m_pressureSize - header.m_tempSize < 2)))
+        {
+            p -= sizeof(SampleBlockHeader);
+            break;
+        }
+
+        entry.m_data = p;
+        p += header.m_size;
+
+        m_index.push_back(entry);
+        m_numSamples += header.m_numSamples;
+        if (header.m_numSamples > maxSamples)
+            maxSamples = header.m_numSamples;
+    }
+
+    if (p < end)
+        fprintf(stderr, "SampleBlockDecoder::init ignoring %llu bytes of partial or corrupt block at the end of %s\n",
+                (unsigned long long) (end - p), m_path.c_str());
+
+    m_scratch.resize(maxSamples);
+
+    return true;
+}
+
+void SampleBlockDecoder::destroy ()
+{
+    if (m_map == NULL)
+        return;
+
+    munmap (m_map, m_mapSize);
+    m_map = NULL;
+    m_mapSize = 0;
+    m_index.clear();
+    m_numSamples = 0;
+}
+
+bool SampleBlockDecoder::decodeBlock (const uint32_t _index, SampleRecord* _records)
+{
+    if (_index >= m_index.size())
+        return false;
+
+    const SampleBlockHeader& header = m_index[_index].m_header;
+    uint32_t num = header.m_numSamples;
+    if (num == 0)
+        return true;
+
+    // Columns one at a time, each loop has a single dependency chain
+    const uint8_t* p = m_index[_index].m_data;
+    const uint8_t* end = p + header.m_timeSize;
+    uint64_t timeUs = header.m_baseTimeUs;
+    int64_t delta = 0;
+    int64_t val;
+    _records[0].m_timeUs = timeUs;
+    for (uint32_t i = 1; i < num; i++)
+    {
+        if (!decodeZigzag (p, end, &val))
+            return corrupt(_index);
+        delta += val;
+        timeUs += delta;
+        _records[i].m_timeUs = timeUs;
+    }
+
+    end += header.m_pressureSize;
+    val = 0;
+    for (uint32_t i = 0; i < num; i++)
+    {
+        int64_t diff;
+        if (!decodeZigzag (p, end, &diff))
+            return corrupt(_index);
+        val += diff;
+        _records[i].m_rawPressure = (int32_t) val;
+    }
+
+    end += header.m_tempSize;
+    val = 0;
+    for (uint32_t i = 0; i < num; i++)
+    {
+        int64_t diff;
+        if (!decodeZigzag (p, end, &diff))
+            return corrupt(_index);
+        val += diff;
+        _records[i].m_rawTemp = (int16_t) val;
+    }
+
+    end = m_index[_index].m_data + header.m_size;
+    for (uint32_t i = 0; i < num; )
+    {
+        uint64_t ossr, run;
+        if (!decodeVarint (p, end, &ossr) || !decodeVarint (p, end, &run) || run > num - i)
+            return corrupt(_index);
+
+        for (uint32_t j = 0; j < run; j++, i++)
+        {
+            _records[i].m_ossr = (uint8_t) ossr;
+            _records[i].m_reserved = 0;
+        }
+    }
+
+    return true;
+}
+
+bool SampleBlockDecoder::corrupt (const uint32_t _index)
+{
+    fprintf(stderr, "SampleBlockDecoder::decodeBlock block %u of %s is corrupt\n", _index, m_path.c_str());
+    return false;
+}
+
+uint32_t SampleBlockDecoder::query (const uint64_t _startUs, const uint64_t _endUs,
+                                    std::vector<SampleRecord>* _records)
+{
+    uint32_t numDecoded = 0;
+    for (uint32_t i = 0; i < m_index.size(); i++)
+    {
+        const SampleBlockHeader& header = m_index[i].m_header;
+        if (header.m_maxTimeUs < _startUs || header.m_minTimeUs >= _endUs)
+            continue;
+
+        if (!decodeBlock(i, &m_scratch[0]))
+            continue;
+        numDecoded++;
+
+        for (uint32_t j = 0; j < header.m_numSamples; j++)
+        {
+            if (m_scratch[j].m_timeUs >= _startUs && m_scratch[j].m_timeUs < _endUs)
+                _records->push_back(m_scratch[j]);
+        }
+    }
+
+    return numDecoded;
+}
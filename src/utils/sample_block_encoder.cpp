@@ -0,0 +1,217 @@
+/*
+ * Filename: sample_block_encoder.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the compressed sample archive writer
+ */
+
+#include "sample_block_encoder.h"
+
+using namespace embed;
+
+SampleBlockEncoder::SampleBlockEncoder (const char* _path, const uint32_t _samplesPerBlock) :
+    m_path (_path),
+    m_samplesPerBlock (_samplesPerBlock),
+    m_fd (-1),
+    m_calibration (),
+    m_hasCalibration (false),
+    m_wallOffsetUs (0),
+    m_pending (),
+    // Worst case block, three full varints and an OSSR run per sample
+    m_buffer (sizeof(SampleBlockHeader) + ((size_t) _samplesPerBlock) * 5 * VARINT_MAX_BYTES),
+    m_numSamples (0),
+    m_numBlocks (0),
+    m_numBytes (0)
+{
+    m_pending.reserve(_samplesPerBlock);
+}
+
+SampleBlockEncoder::~SampleBlockEncoder ()
+{
+    destroy();
+}
+
+bool SampleBlockEncoder::init ()
+{
+    if (m_fd != -1)
+        return true;
+
+    if ((m_fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644)) < 0)
+    {
+        fprintf(stderr, "SampleBlockEncoder::init open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    // A new archive needs its header, an existing one must be an archive
+    uint8_t header[SAMPLE_BLOCK_FILE_HEADER_SIZE];
+    ssize_t rc = pread(m_fd, header, sizeof(header), 0);
+    if (rc == 0)
+    {
+        memcpy (header, SAMPLE_BLOCK_MAGIC, sizeof(SAMPLE_BLOCK_MAGIC));
+        header[sizeof(SAMPLE_BLOCK_MAGIC)] = SAMPLE_BLOCK_VERSION;
+        if (!writeAll(header, sizeof(header)))
+        {
+            close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+    }
+    else if (rc != (ssize_t) sizeof(header) || memcmp (header, SAMPLE_BLOCK_MAGIC, sizeof(SAMPLE_BLOCK_MAGIC)) != 0 ||
+             header[sizeof(SAMPLE_BLOCK_MAGIC)] != SAMPLE_BLOCK_VERSION)
+    {
+        fprintf(stderr, "SampleBlockEncoder::init %s is not a version %u sample archive\n",
+                m_path.c_str(), SAMPLE_BLOCK_VERSION);
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void SampleBlockEncoder::destroy ()
+{
+    if (m_fd == -1)
+        return;
+
+    flush();
+    close(m_fd);
+    m_fd = -1;
+}
+
+void SampleBlockEncoder::setCalibration (const BMP085::Calibration& _calibration)
+{
+    flush();
+    m_calibration = _calibration;
+    m_hasCalibration = true;
+}
+
+void SampleBlockEncoder::setWallOffsetUs (const int64_t _wallOffsetUs)
+{
+    flush();
+    m_wallOffsetUs = _wallOffsetUs;
+}
+
+bool SampleBlockEncoder::append (const SampleRecord& _record)
+{
+    if (m_fd == -1)
+        return false;
+
+    m_pending.push_back(_record);
+    m_numSamples++;
+
+    if (m_pending.size() >= m_samplesPerBlock)
+        return flush();
+
+    return true;
+}
+
+bool SampleBlockEncoder::flush ()
+{
+    if (m_fd == -1 || m_pending.empty())
+        return true;
+
+    const SampleRecord* records = &m_pending[0];
+    uint32_t num = m_pending.size();
+
+    SampleBlockHeader header;
+    memset (&header, 0, sizeof(header));
+    header.m_numSamples = num;
+    header.m_baseTimeUs = records[0].m_timeUs;
+    header.m_minTimeUs = records[0].m_timeUs;
+    header.m_maxTimeUs = records[0].m_timeUs;
+    header.m_minPressure = records[0].m_rawPressure;
+    header.m_maxPressure = records[0].m_rawPressure;
+    header.m_minTemp = records[0].m_rawTemp;
+    header.m_maxTemp = records[0].m_rawTemp;
+    header.m_wallOffsetUs = m_wallOffsetUs;
+    header.m_calibration = m_calibration;
+    header.m_hasCalibration = m_hasCalibration ? 1 : 0;
+
+    uint8_t* buf = &m_buffer[0];
+    uint32_t len = sizeof(SampleBlockHeader);
+
+    // Time, the first delta of delta is the first delta itself. The index
+    // covers the whole block even if times go backwards within it.
+    int64_t prevDelta = 0;
+    for (uint32_t i = 1; i < num; i++)
+    {
+        int64_t delta = (int64_t) (records[i].m_timeUs - records[i - 1].m_timeUs);
+        len += encodeVarint (zigzagEncode (delta - prevDelta), &buf[len]);
+        prevDelta = delta;
+
+        if (records[i].m_timeUs < header.m_minTimeUs)
+            header.m_minTimeUs = records[i].m_timeUs;
+        if (records[i].m_timeUs > header.m_maxTimeUs)
+            header.m_maxTimeUs = records[i].m_timeUs;
+    }
+    header.m_timeSize = len - sizeof(SampleBlockHeader);
+
+    int64_t prev = 0;
+    for (uint32_t i = 0; i < num; i++)
+    {
+        len += encodeVarint (zigzagEncode (((int64_t) records[i].m_rawPressure) - prev), &buf[len]);
+        prev = records[i].m_rawPressure;
+
+        if (records[i].m_rawPressure < header.m_minPressure)
+            header.m_minPressure = records[i].m_rawPressure;
+        if (records[i].m_rawPressure > header.m_maxPressure)
+            header.m_maxPressure = records[i].m_rawPressure;
+    }
+    header.m_pressureSize = len - sizeof(SampleBlockHeader) - header.m_timeSize;
+
+    prev = 0;
+    for (uint32_t i = 0; i < num; i++)
+    {
+        len += encodeVarint (zigzagEncode (((int64_t) records[i].m_rawTemp) - prev), &buf[len]);
+        prev = records[i].m_rawTemp;
+
+        if (records[i].m_rawTemp < header.m_minTemp)
+            header.m_minTemp = records[i].m_rawTemp;
+        if (records[i].m_rawTemp > header.m_maxTemp)
+            header.m_maxTemp = records[i].m_rawTemp;
+    }
+    header.m_tempSize = len - sizeof(SampleBlockHeader) - header.m_timeSize - header.m_pressureSize;
+
+    for (uint32_t i = 0; i < num; )
+    {
+        uint32_t run = 1;
+        while (i + run < num && records[i + run].m_ossr == records[i].m_ossr)
+            run++;
+
+        len += encodeVarint (records[i].m_ossr, &buf[len]);
+        len += encodeVarint (run, &buf[len]);
+        i += run;
+    }
+
+    header.m_size = len - sizeof(SampleBlockHeader);
+    memcpy (buf, &header, sizeof(header));
+
+    m_pending.clear();
+    if (!writeAll(buf, len))
+        return false;
+
+    m_numBlocks++;
+    return true;
+}
+
+bool SampleBlockEncoder::writeAll (const uint8_t* _buf, const size_t _len)
+{
+    size_t num = 0;
+    while (num < _len)
+    {
+        ssize_t rc = write(m_fd, _buf + num, _len - num);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            fprintf(stderr, "SampleBlockEncoder::writeAll write error: %s\n", strerror(errno));
+            return false;
+        }
+        num += rc;
+    }
+    m_numBytes += _len;
+
+    return true;
+}
@@ -0,0 +1,198 @@
+/*
+ * Filename: sample_bus_publisher.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sample bus publisher
+ */
+
+#include "sample_bus_publisher.h"
+
+using namespace embed;
+
+SampleBusPublisher::SampleBusPublisher (const char* _name, const uint32_t _capacity, Clock* _clock) :
+    m_name (std::string("/") + _name),
+    m_capacity (1),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_device (NULL),
+    m_map (NULL),
+    m_mapSize (0),
+    m_header (NULL),
+    m_slots (NULL),
+    m_numPublished (0),
+    m_busMutex ()
+{
+    while (m_capacity < _capacity)
+        m_capacity <<= 1;
+
+    pthread_mutex_init (&m_busMutex, NULL);
+}
+
+SampleBusPublisher::~SampleBusPublisher ()
+{
+    destroy();
+    pthread_mutex_destroy (&m_busMutex);
+}
+
+bool SampleBusPublisher::init ()
+{
+    if (m_map != NULL)
+        return true;
+
+    // A bus left by a crashed publisher is replaced, its subscribers see
+    // it has gone through isPublisherAlive()
+    shm_unlink(m_name.c_str());
+    int32_t fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "SampleBusPublisher::init shm_open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    size_t size = sizeof(SampleBusHeader) + ((size_t) m_capacity) * sizeof(SampleBusSlot);
+    if (ftruncate(fd, size) < 0)
+    {
+        fprintf(stderr, "SampleBusPublisher::init ftruncate error: %s\n", strerror(errno));
+        close(fd);
+        shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "SampleBusPublisher::init mmap error: %s\n", strerror(errno));
+        shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    pthread_mutex_lock (&m_busMutex);
+
+    // The object starts zeroed, so every slot is empty
+    m_map = static_cast<uint8_t*>(map);
+    m_mapSize = size;
+    m_header = static_cast<SampleBusHeader*>(map);
+    m_slots = reinterpret_cast<SampleBusSlot*>(m_map + sizeof(SampleBusHeader));
+    m_numPublished = 0;
+
+    m_header->m_version = SAMPLE_BUS_VERSION;
+    m_header->m_headerSize = sizeof(SampleBusHeader);
+    m_header->m_slotSize = sizeof(SampleBusSlot);
+    m_header->m_capacity = m_capacity;
+    m_header->m_publisherPid = getpid();
+
+    // Subscribers check the magic first
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+    memcpy (m_header->m_magic, SAMPLE_BUS_MAGIC, sizeof(SAMPLE_BUS_MAGIC));
+
+    pthread_mutex_unlock (&m_busMutex);
+
+    return true;
+}
+
+void SampleBusPublisher::destroy ()
+{
+    if (m_map == NULL)
+        return;
+
+    detach();
+
+    pthread_mutex_lock (&m_busMutex);
+    munmap (m_map, m_mapSize);
+    shm_unlink(m_name.c_str());
+    m_map = NULL;
+    m_mapSize = 0;
+    m_header = NULL;
+    m_slots = NULL;
+    pthread_mutex_unlock (&m_busMutex);
+}
+
+void SampleBusPublisher::setCalibration (const BMP085::Calibration& _calibration)
+{
+    pthread_mutex_lock (&m_busMutex);
+
+    if (m_header != NULL)
+    {
+        __atomic_store_n (&m_header->m_calibrationSeq, m_header->m_calibrationSeq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence (__ATOMIC_RELEASE);
+        m_header->m_calibration = _calibration;
+        m_header->m_hasCalibration = 1;
+        __atomic_store_n (&m_header->m_calibrationSeq, m_header->m_calibrationSeq + 1, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock (&m_busMutex);
+}
+
+bool SampleBusPublisher::publish (const int16_t _rawTemp, const int32_t _rawPressure, const uint8_t _ossr)
+{
+    return publish (m_clock->nowUs(), _rawTemp, _rawPressure, _ossr);
+}
+
+bool SampleBusPublisher::publish (const uint64_t _timeUs, const int16_t _rawTemp, const int32_t _rawPressure,
+                                  const uint8_t _ossr)
+{
+    SampleRecord record;
+    record.m_timeUs = _timeUs;
+    record.m_rawPressure = _rawPressure;
+    record.m_rawTemp = _rawTemp;
+    record.m_ossr = _ossr;
+    record.m_reserved = 0;
+
+    uint64_t words[sizeof(SampleRecord) / sizeof(uint64_t)];
+    memcpy (words, &record, sizeof(record));
+
+    pthread_mutex_lock (&m_busMutex);
+
+    if (m_header == NULL)
+    {
+        pthread_mutex_unlock (&m_busMutex);
+        return false;
+    }
+
+    // Mark the slot as being written before any of the record changes
+    SampleBusSlot* slot = &m_slots[m_numPublished & (m_capacity - 1)];
+    __atomic_store_n (&slot->m_seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+    for (uint32_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        __atomic_store_n (&slot->m_words[i], words[i], __ATOMIC_RELAXED);
+    __atomic_store_n (&slot->m_seq, m_numPublished + 1, __ATOMIC_RELEASE);
+
+    m_numPublished++;
+    __atomic_store_n (&m_header->m_numPublished, m_numPublished, __ATOMIC_RELEASE);
+
+    // Subscribers cannot register as waiters on a read-only mapping, so
+    // always wake, at the sample rate it costs little
+    __atomic_add_fetch (&m_header->m_futex, 1, __ATOMIC_RELEASE);
+    sampleBusWake (&m_header->m_futex);
+
+    pthread_mutex_unlock (&m_busMutex);
+
+    return true;
+}
+
+void SampleBusPublisher::attach (BMP085* _device)
+{
+    BMP085::Calibration calibration;
+    _device->getCalibration(&calibration);
+    setCalibration(calibration);
+
+    m_device = _device;
+    m_device->registerListener(sampleHandler, this);
+}
+
+void SampleBusPublisher::detach ()
+{
+    if (m_device == NULL)
+        return;
+
+    m_device->unregisterListener(sampleHandler);
+    m_device = NULL;
+}
+
+void SampleBusPublisher::sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    SampleBusPublisher* _this = static_cast<SampleBusPublisher*>(_data);
+
+    // Listeners run during the dispatch, so the sample OSSR is this sample's
+    _this->publish (_temp, _pressure, (uint8_t) _this->m_device->getSampleOSSR());
+}
@@ -0,0 +1,282 @@
+/*
+ * Filename: sample_bus_subscriber.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sample bus subscriber
+ */
+
+#include "sample_bus_subscriber.h"
+
+using namespace embed;
+
+SampleBusSubscriber::SampleBusSubscriber (const char* _name) :
+    m_name (std::string("/") + _name),
+    m_map (NULL),
+    m_mapSize (0),
+    m_header (NULL),
+    m_slots (NULL),
+    m_mask (0),
+    m_next (0),
+    m_numRead (0),
+    m_numDropped (0),
+    m_listeners (),
+    m_listenersMutex (),
+    m_dispatching (false),
+    m_unregistered (),
+    m_stop (false),
+    m_sample ()
+{
+    // Recursive so listeners can call back into the subscriber, which is
+    // why unregistering during dispatch is deferred
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init (&mutexAttr);
+    pthread_mutexattr_settype (&mutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&m_listenersMutex, &mutexAttr);
+    pthread_mutexattr_destroy (&mutexAttr);
+}
+
+SampleBusSubscriber::~SampleBusSubscriber ()
+{
+    destroy();
+    m_listeners.clear();
+    pthread_mutex_destroy (&m_listenersMutex);
+}
+
+bool SampleBusSubscriber::init ()
+{
+    destroy();
+
+    int32_t fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        fprintf(stderr, "SampleBusSubscriber::init shm_open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(SampleBusHeader))
+    {
+        fprintf(stderr, "SampleBusSubscriber::init %s is not ready\n", m_name.c_str());
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "SampleBusSubscriber::init mmap error: %s\n", strerror(errno));
+        return false;
+    }
+
+    const SampleBusHeader* header = static_cast<const SampleBusHeader*>(map);
+    bool ready = memcmp (header->m_magic, SAMPLE_BUS_MAGIC, sizeof(SAMPLE_BUS_MAGIC)) == 0;
+    __atomic_thread_fence (__ATOMIC_ACQUIRE);
+    if (!ready || header->m_version != SAMPLE_BUS_VERSION || header->m_headerSize != sizeof(SampleBusHeader) ||
+        header->m_slotSize != sizeof(SampleBusSlot) || header->m_capacity == 0 ||
+        (header->m_capacity & (header->m_capacity - 1)) != 0 ||
+        header->m_headerSize + ((uint64_t) header->m_capacity) * header->m_slotSize > (uint64_t) st.st_size)
+    {
+        fprintf(stderr, "SampleBusSubscriber::init %s is not a version %u sample bus\n",
+                m_name.c_str(), SAMPLE_BUS_VERSION);
+        munmap (map, st.st_size);
+        return false;
+    }
+
+    m_map = static_cast<const uint8_t*>(map);
+    m_mapSize = st.st_size;
+    m_header = header;
+    m_slots = reinterpret_cast<const SampleBusSlot*>(m_map + header->m_headerSize);
+    m_mask = header->m_capacity - 1;
+    m_next = __atomic_load_n (&m_header->m_numPublished, __ATOMIC_ACQUIRE);
+    m_numRead = 0;
+    m_numDropped = 0;
+
+    return true;
+}
+
+void SampleBusSubscriber::destroy ()
+{
+    if (m_map == NULL)
+        return;
+
+    munmap (const_cast<uint8_t*>(m_map), m_mapSize);
+    m_map = NULL;
+    m_mapSize = 0;
+    m_header = NULL;
+    m_slots = NULL;
+}
+
+void SampleBusSubscriber::seekOldest ()
+{
+    if (m_header == NULL)
+        return;
+
+    uint64_t published = __atomic_load_n (&m_header->m_numPublished, __ATOMIC_ACQUIRE);
+    m_next = published > m_mask + 1 ? published - (m_mask + 1) : 0;
+}
+
+bool SampleBusSubscriber::read (SampleRecord* _record)
+{
+    if (m_header == NULL)
+        return false;
+
+    while (true)
+    {
+        uint64_t published = __atomic_load_n (&m_header->m_numPublished, __ATOMIC_ACQUIRE);
+        if (m_next >= published)
+            return false;
+
+        // Lapped, skip to the oldest sample still in the ring
+        if (published - m_next > m_mask + 1)
+        {
+            m_numDropped += published - (m_mask + 1) - m_next;
+            m_next = published - (m_mask + 1);
+        }
+
+        const SampleBusSlot* slot = &m_slots[m_next & m_mask];
+        uint64_t words[sizeof(SampleRecord) / sizeof(uint64_t)];
+        uint64_t seq = __atomic_load_n (&slot->m_seq, __ATOMIC_ACQUIRE);
+        for (uint32_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+            words[i] = __atomic_load_n (&slot->m_words[i], __ATOMIC_RELAXED);
+        __atomic_thread_fence (__ATOMIC_ACQUIRE);
+
+        // The slot changed under the copy, the publisher has moved past it
+        if (seq != m_next + 1 || __atomic_load_n (&slot->m_seq, __ATOMIC_RELAXED) != seq)
+        {
+            m_numDropped++;
+            m_next++;
+            continue;
+        }
+
+        memcpy (_record, words, sizeof(SampleRecord));
+        m_next++;
+        m_numRead++;
+
+        return true;
+    }
+}
+
+bool SampleBusSubscriber::wait (SampleRecord* _record, const uint64_t _timeoutUs)
+{
+    if (m_header == NULL)
+        return false;
+
+    uint64_t deadlineUs = SystemClock::Instance()->nowUs() + _timeoutUs;
+    while (true)
+    {
+        // Load the futex word before checking, so a sample published in
+        // between changes it and the wait returns at once
+        uint32_t futex = __atomic_load_n (&m_header->m_futex, __ATOMIC_ACQUIRE);
+        if (read(_record))
+            return true;
+
+        uint64_t nowUs = SystemClock::Instance()->nowUs();
+        if (nowUs >= deadlineUs)
+            return false;
+
+        sampleBusWait (&m_header->m_futex, futex, deadlineUs - nowUs);
+    }
+}
+
+void SampleBusSubscriber::registerListener (BMP085::EOCIntHandler _handler, void* _data)
+{
+    pthread_mutex_lock (&m_listenersMutex);
+    m_listeners[_handler] = _data;
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+        {
+            m_unregistered.erase(m_unregistered.begin() + i);
+            break;
+        }
+    }
+    pthread_mutex_unlock (&m_listenersMutex);
+}
+
+void SampleBusSubscriber::unregisterListener (BMP085::EOCIntHandler _handler)
+{
+    pthread_mutex_lock (&m_listenersMutex);
+    std::map<BMP085::EOCIntHandler,void*>::iterator it = m_listeners.find(_handler);
+    if (it != m_listeners.end())
+    {
+        if (m_dispatching)
+            m_unregistered.push_back(_handler);
+        else
+            m_listeners.erase(it);
+    }
+    pthread_mutex_unlock (&m_listenersMutex);
+}
+
+void SampleBusSubscriber::run ()
+{
+    m_stop = false;
+    while (!m_stop)
+    {
+        if (!wait(&m_sample, RUN_POLL_US))
+            continue;
+
+        pthread_mutex_lock (&m_listenersMutex);
+        m_dispatching = true;
+        std::map<BMP085::EOCIntHandler,void*>::iterator it;
+        for (it = m_listeners.begin(); it != m_listeners.end(); it++)
+        {
+            if (!isUnregistered (it->first))
+                it->first (m_sample.m_rawTemp, m_sample.m_rawPressure, it->second);
+        }
+        m_dispatching = false;
+
+        for (uint32_t i = 0; i < m_unregistered.size(); i++)
+            m_listeners.erase(m_unregistered[i]);
+        m_unregistered.clear();
+        pthread_mutex_unlock (&m_listenersMutex);
+    }
+}
+
+void SampleBusSubscriber::stop ()
+{
+    m_stop = true;
+}
+
+bool SampleBusSubscriber::getCalibration (BMP085::Calibration* _calibration)
+{
+    if (m_header == NULL)
+        return false;
+
+    // Retry while the publisher is changing it
+    while (true)
+    {
+        uint32_t seq = __atomic_load_n (&m_header->m_calibrationSeq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) != 0)
+            continue;
+
+        BMP085::Calibration calibration = m_header->m_calibration;
+        bool hasCalibration = m_header->m_hasCalibration != 0;
+        __atomic_thread_fence (__ATOMIC_ACQUIRE);
+        if (__atomic_load_n (&m_header->m_calibrationSeq, __ATOMIC_RELAXED) != seq)
+            continue;
+
+        if (hasCalibration)
+            (*_calibration) = calibration;
+        return hasCalibration;
+    }
+}
+
+bool SampleBusSubscriber::isUnregistered (BMP085::EOCIntHandler _handler)
+{
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+            return true;
+    }
+
+    return false;
+}
+
+bool SampleBusSubscriber::isPublisherAlive ()
+{
+    if (m_header == NULL)
+        return false;
+
+    return kill(m_header->m_publisherPid, 0) == 0 || errno == EPERM;
+}
@@ -0,0 +1,154 @@
+/*
+ * Filename: sample_log_reader.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sample log reader
+ */
+
+#include "sample_log_reader.h"
+
+using namespace embed;
+
+SampleLogReader::SampleLogReader (const char* _dir, const char* _name) :
+    m_dir (_dir),
+    m_name (_name),
+    m_sequences (),
+    m_map (NULL),
+    m_mapSize (0),
+    m_header (NULL),
+    m_records (NULL)
+{
+}
+
+SampleLogReader::~SampleLogReader ()
+{
+    closeSegment();
+}
+
+bool SampleLogReader::refresh ()
+{
+    DIR* dir = opendir(m_dir.c_str());
+    if (dir == NULL)
+    {
+        fprintf(stderr, "SampleLogReader::refresh opendir error: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Segments are <name>-<sequence>.slog, temporary files are skipped
+    m_sequences.clear();
+    std::string prefix = m_name + "-";
+    size_t extLen = strlen(SAMPLE_LOG_EXTENSION);
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        std::string file = entry->d_name;
+        if (file.size() <= prefix.size() + extLen || file.compare(0, prefix.size(), prefix) != 0 ||
+            file.compare(file.size() - extLen, extLen, SAMPLE_LOG_EXTENSION) != 0)
+            continue;
+
+        m_sequences.push_back(strtoull(file.c_str() + prefix.size(), NULL, 10));
+    }
+    closedir(dir);
+
+    std::sort(m_sequences.begin(), m_sequences.end());
+
+    return true;
+}
+
+bool SampleLogReader::openSegment (const uint32_t _index)
+{
+    closeSegment();
+
+    if (_index >= m_sequences.size())
+        return false;
+
+    char name[32];
+    snprintf(name, sizeof(name), "-%08llu", (unsigned long long) m_sequences[_index]);
+    std::string path = m_dir + "/" + m_name + name + SAMPLE_LOG_EXTENSION;
+
+    int32_t fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "SampleLogReader::openSegment open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(SampleSegmentHeader))
+    {
+        fprintf(stderr, "SampleLogReader::openSegment %s is too short\n", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "SampleLogReader::openSegment mmap error: %s\n", strerror(errno));
+        return false;
+    }
+
+    const SampleSegmentHeader* header = static_cast<const SampleSegmentHeader*>(map);
+    if (memcmp (header->m_magic, SAMPLE_LOG_MAGIC, sizeof(SAMPLE_LOG_MAGIC)) != 0 ||
+        header->m_version != SAMPLE_LOG_VERSION || header->m_headerSize != sizeof(SampleSegmentHeader) ||
+        header->m_recordSize != sizeof(SampleRecord) ||
+        header->m_headerSize + header->m_capacity * header->m_recordSize > (uint64_t) st.st_size)
+    {
+        fprintf(stderr, "SampleLogReader::openSegment %s is not a version %u sample log segment\n",
+                path.c_str(), SAMPLE_LOG_VERSION);
+        munmap (map, st.st_size);
+        return false;
+    }
+
+    m_map = static_cast<uint8_t*>(map);
+    m_mapSize = st.st_size;
+    m_header = header;
+    m_records = reinterpret_cast<const SampleRecord*>(m_map + header->m_headerSize);
+
+    return true;
+}
+
+void SampleLogReader::closeSegment ()
+{
+    if (m_map == NULL)
+        return;
+
+    munmap (m_map, m_mapSize);
+    m_map = NULL;
+    m_mapSize = 0;
+    m_header = NULL;
+    m_records = NULL;
+}
+
+const SampleRecord* SampleLogReader::getRecords (uint64_t* _numRecords)
+{
+    if (m_header == NULL)
+    {
+        (*_numRecords) = 0;
+        return NULL;
+    }
+
+    // Pairs with the writer's release store, records before the count are
+    // complete
+    uint64_t num = __atomic_load_n (&m_header->m_numRecords, __ATOMIC_ACQUIRE);
+    (*_numRecords) = std::min(num, m_header->m_capacity);
+
+    return m_records;
+}
+
+bool SampleLogReader::isSealed ()
+{
+    if (m_header == NULL)
+        return false;
+
+    return __atomic_load_n (&m_header->m_sealed, __ATOMIC_ACQUIRE) != 0;
+}
+
+uint64_t SampleLogReader::toWallUs (const uint64_t _timeUs)
+{
+    if (m_header == NULL)
+        return 0;
+
+    return m_header->m_wallStartUs + (_timeUs - m_header->m_clockStartUs);
+}
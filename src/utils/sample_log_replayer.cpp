@@ -0,0 +1,215 @@
+/*
+ * Filename: sample_log_replayer.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sample log replayer
+ */
+
+#include "sample_log_replayer.h"
+
+using namespace embed;
+
+constexpr double SampleLogReplayer::AS_FAST_AS_POSSIBLE;
+
+SampleLogReplayer::SampleLogReplayer (const char* _dir, const char* _name, Clock* _clock) :
+    m_dir (_dir),
+    m_name (_name),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_speed (1.0),
+    m_maxGapUs (DEFAULT_MAX_GAP_US),
+    m_stop (false),
+    m_listeners (),
+    m_listenersMutex (),
+    m_dispatching (false),
+    m_unregistered (),
+    m_scheduled (false),
+    m_baseRecordUs (0),
+    m_baseClockUs (0),
+    m_lastRecordUs (0),
+    m_header (NULL),
+    m_sampleTimeUs (0),
+    m_sampleOssr (BMP085::OSSR_LOW_POWER),
+    m_numDispatched (0),
+    m_numGapsSkipped (0),
+    m_runUs (0),
+    m_listenerUs (0),
+    m_maxLagUs (0)
+{
+    // Recursive so listeners can call back into the replayer, which is
+    // why unregistering during dispatch is deferred
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init (&mutexAttr);
+    pthread_mutexattr_settype (&mutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&m_listenersMutex, &mutexAttr);
+    pthread_mutexattr_destroy (&mutexAttr);
+}
+
+SampleLogReplayer::~SampleLogReplayer ()
+{
+    m_listeners.clear();
+    pthread_mutex_destroy (&m_listenersMutex);
+}
+
+void SampleLogReplayer::registerListener (BMP085::EOCIntHandler _handler, void* _data)
+{
+    pthread_mutex_lock (&m_listenersMutex);
+    m_listeners[_handler] = _data;
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+        {
+            m_unregistered.erase(m_unregistered.begin() + i);
+            break;
+        }
+    }
+    pthread_mutex_unlock (&m_listenersMutex);
+}
+
+void SampleLogReplayer::unregisterListener (BMP085::EOCIntHandler _handler)
+{
+    pthread_mutex_lock (&m_listenersMutex);
+    std::map<BMP085::EOCIntHandler,void*>::iterator it = m_listeners.find(_handler);
+    if (it != m_listeners.end())
+    {
+        if (m_dispatching)
+            m_unregistered.push_back(_handler);
+        else
+            m_listeners.erase(it);
+    }
+    pthread_mutex_unlock (&m_listenersMutex);
+}
+
+bool SampleLogReplayer::run ()
+{
+    m_stop = false;
+    m_scheduled = false;
+    m_numDispatched = 0;
+    m_numGapsSkipped = 0;
+    m_runUs = 0;
+    m_listenerUs = 0;
+    m_maxLagUs = 0;
+
+    SampleLogReader reader(m_dir.c_str(), m_name.c_str());
+    if (!reader.refresh())
+        return false;
+
+    if (reader.getNumSegments() == 0)
+    {
+        fprintf(stderr, "SampleLogReplayer::run no segments of %s/%s\n", m_dir.c_str(), m_name.c_str());
+        return false;
+    }
+
+    SystemClock* systemClock = SystemClock::Instance();
+    uint64_t runStartUs = systemClock->nowUs();
+    for (uint32_t i = 0; i < reader.getNumSegments() && !m_stop; i++)
+    {
+        if (!reader.openSegment(i))
+            continue;
+        m_header = reader.getHeader();
+
+        uint64_t num;
+        const SampleRecord* records = reader.getRecords(&num);
+        for (uint64_t j = 0; j < num && !m_stop; j++)
+        {
+            waitForSample(records[j].m_timeUs);
+
+            m_sampleTimeUs = records[j].m_timeUs;
+            m_sampleOssr = (BMP085::OSSR_SETTING) records[j].m_ossr;
+
+            uint64_t listenerStartUs = systemClock->nowUs();
+            pthread_mutex_lock (&m_listenersMutex);
+            m_dispatching = true;
+            std::map<BMP085::EOCIntHandler,void*>::iterator it;
+            for (it = m_listeners.begin(); it != m_listeners.end(); it++)
+            {
+                if (!isUnregistered (it->first))
+                    it->first (records[j].m_rawTemp, records[j].m_rawPressure, it->second);
+            }
+            m_dispatching = false;
+
+            for (uint32_t k = 0; k < m_unregistered.size(); k++)
+                m_listeners.erase(m_unregistered[k]);
+            m_unregistered.clear();
+            pthread_mutex_unlock (&m_listenersMutex);
+            m_listenerUs += systemClock->nowUs() - listenerStartUs;
+
+            m_numDispatched++;
+        }
+    }
+    m_header = NULL;
+    reader.closeSegment();
+    m_runUs = systemClock->nowUs() - runStartUs;
+
+    return true;
+}
+
+void SampleLogReplayer::stop ()
+{
+    m_stop = true;
+}
+
+bool SampleLogReplayer::getCalibration (BMP085::Calibration* _calibration)
+{
+    if (m_header == NULL || !m_header->m_hasCalibration)
+        return false;
+
+    (*_calibration) = m_header->m_calibration;
+    return true;
+}
+
+double SampleLogReplayer::getDispatchRate ()
+{
+    if (m_runUs == 0)
+        return 0.0;
+
+    return ((double) m_numDispatched) * 1e6 / ((double) m_runUs);
+}
+
+double SampleLogReplayer::getListenerRate ()
+{
+    if (m_listenerUs == 0)
+        return 0.0;
+
+    return ((double) m_numDispatched) * 1e6 / ((double) m_listenerUs);
+}
+
+bool SampleLogReplayer::isUnregistered (BMP085::EOCIntHandler _handler)
+{
+    for (uint32_t i = 0; i < m_unregistered.size(); i++)
+    {
+        if (m_unregistered[i] == _handler)
+            return true;
+    }
+
+    return false;
+}
+
+void SampleLogReplayer::waitForSample (const uint64_t _timeUs)
+{
+    if (m_speed <= AS_FAST_AS_POSSIBLE)
+        return;
+
+    // A sample that goes backwards or comes after a long gap starts a new
+    // schedule and is due immediately
+    if (!m_scheduled || _timeUs < m_lastRecordUs || _timeUs - m_lastRecordUs > m_maxGapUs)
+    {
+        if (m_scheduled)
+            m_numGapsSkipped++;
+
+        m_scheduled = true;
+        m_baseRecordUs = _timeUs;
+        m_baseClockUs = m_clock->nowUs();
+    }
+    m_lastRecordUs = _timeUs;
+
+    uint64_t dueUs = m_baseClockUs + (uint64_t) (((double) (_timeUs - m_baseRecordUs)) / m_speed);
+    uint64_t nowUs = m_clock->nowUs();
+    if (nowUs < dueUs)
+    {
+        m_clock->sleepUs(dueUs - nowUs);
+        nowUs = m_clock->nowUs();
+    }
+
+    if (nowUs > dueUs && nowUs - dueUs > m_maxLagUs)
+        m_maxLagUs = nowUs - dueUs;
+}
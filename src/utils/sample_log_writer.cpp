@@ -0,0 +1,452 @@
+/*
+ * Filename: sample_log_writer.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sample log writer
+ */
+
+#include "sample_log_writer.h"
+
+using namespace embed;
+
+SampleLogWriter::SampleLogWriter (const char* _dir, const char* _name, const uint32_t _recordsPerSegment,
+                                  Clock* _clock) :
+    m_dir (_dir),
+    m_name (_name),
+    m_recordsPerSegment (_recordsPerSegment),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_initialized (false),
+    m_calibration (),
+    m_hasCalibration (false),
+    m_device (NULL),
+    m_sequence (0),
+    m_segment (),
+    m_header (NULL),
+    m_records (NULL),
+    m_segmentRecords (0),
+    m_numRecords (0),
+    m_logMutex (),
+    m_thread (),
+    m_running (false),
+    m_spare (),
+    m_spareReady (false),
+    m_spareFailed (false),
+    m_unpublished (),
+    m_retired (),
+    m_segmentMutex (),
+    m_segmentCond (),
+    m_spareCond ()
+{
+    pthread_mutex_init (&m_logMutex, NULL);
+    pthread_mutex_init (&m_segmentMutex, NULL);
+    pthread_cond_init (&m_segmentCond, NULL);
+    pthread_cond_init (&m_spareCond, NULL);
+}
+
+SampleLogWriter::~SampleLogWriter ()
+{
+    destroy();
+    pthread_cond_destroy (&m_spareCond);
+    pthread_cond_destroy (&m_segmentCond);
+    pthread_mutex_destroy (&m_segmentMutex);
+    pthread_mutex_destroy (&m_logMutex);
+}
+
+bool SampleLogWriter::init ()
+{
+    if (m_initialized)
+        return true;
+
+    if (m_recordsPerSegment == 0)
+    {
+        fprintf(stderr, "SampleLogWriter::init called with no records per segment\n");
+        return false;
+    }
+
+    // The first segment and the spare after it are made here, later spares
+    // on the segment thread
+    Segment segment;
+    uint64_t sequence = findNextSequence();
+    if (!prepareSegment(sequence, &segment))
+        return false;
+
+    pthread_mutex_lock (&m_logMutex);
+    m_numRecords = 0;
+    startSegment(segment);
+    pthread_mutex_unlock (&m_logMutex);
+
+    if (!publishSegment(sequence))
+    {
+        pthread_mutex_lock (&m_logMutex);
+        closeSegment();
+        pthread_mutex_unlock (&m_logMutex);
+        unlink((segmentPath(sequence) + ".tmp").c_str());
+        return false;
+    }
+
+    m_unpublished.reserve(MAX_PENDING_SEGMENTS);
+    m_retired.reserve(MAX_PENDING_SEGMENTS);
+    m_spareReady = prepareSegment(sequence + 1, &m_spare);
+    m_spareFailed = !m_spareReady;
+    m_running = true;
+    if (pthread_create(&m_thread, NULL, segmentThread, this) != 0)
+    {
+        fprintf(stderr, "SampleLogWriter::init pthread_create error\n");
+        m_running = false;
+        m_initialized = true;
+        destroy();
+        return false;
+    }
+
+    // Waking the thread must not preempt the appender on a single core,
+    // it only needs the CPU time the sampling leaves over
+    struct sched_param params;
+    params.sched_priority = 0;
+    if (pthread_setschedparam(m_thread, SCHED_IDLE, &params) != 0)
+        fprintf(stderr, "SampleLogWriter::init pthread_setschedparam error\n");
+
+    m_initialized = true;
+
+    return true;
+}
+
+void SampleLogWriter::destroy ()
+{
+    if (!m_initialized)
+        return;
+
+    detach();
+
+    // The thread finishes publishing and unmapping before it exits
+    if (m_running)
+    {
+        pthread_mutex_lock (&m_segmentMutex);
+        m_running = false;
+        pthread_cond_signal (&m_segmentCond);
+        pthread_mutex_unlock (&m_segmentMutex);
+        pthread_join(m_thread, NULL);
+    }
+
+    pthread_mutex_lock (&m_logMutex);
+    closeSegment();
+    m_initialized = false;
+    pthread_mutex_unlock (&m_logMutex);
+
+    // The unused spare never becomes part of the log
+    if (m_spareReady)
+    {
+        munmap (m_spare.m_map, m_spare.m_mapSize);
+        unlink((segmentPath(m_spare.m_sequence) + ".tmp").c_str());
+        m_spareReady = false;
+    }
+    m_spareFailed = false;
+}
+
+void SampleLogWriter::setCalibration (const BMP085::Calibration& _calibration)
+{
+    pthread_mutex_lock (&m_logMutex);
+
+    m_calibration = _calibration;
+    m_hasCalibration = true;
+
+    // Segments without samples yet can still take it
+    if (m_header != NULL && m_segmentRecords == 0)
+    {
+        m_header->m_calibration = m_calibration;
+        m_header->m_hasCalibration = 1;
+    }
+
+    pthread_mutex_unlock (&m_logMutex);
+}
+
+bool SampleLogWriter::append (const int16_t _rawTemp, const int32_t _rawPressure, const uint8_t _ossr)
+{
+    return append (m_clock->nowUs(), _rawTemp, _rawPressure, _ossr);
+}
+
+bool SampleLogWriter::append (const uint64_t _timeUs, const int16_t _rawTemp, const int32_t _rawPressure,
+                              const uint8_t _ossr)
+{
+    pthread_mutex_lock (&m_logMutex);
+
+    if (m_header == NULL || (m_segmentRecords == m_header->m_capacity && !rotate()))
+    {
+        pthread_mutex_unlock (&m_logMutex);
+        return false;
+    }
+
+    SampleRecord& record = m_records[m_segmentRecords];
+    record.m_timeUs = _timeUs;
+    record.m_rawPressure = _rawPressure;
+    record.m_rawTemp = _rawTemp;
+    record.m_ossr = _ossr;
+    record.m_reserved = 0;
+
+    // Publish the record to readers
+    m_segmentRecords++;
+    __atomic_store_n (&m_header->m_numRecords, m_segmentRecords, __ATOMIC_RELEASE);
+    m_numRecords++;
+
+    pthread_mutex_unlock (&m_logMutex);
+
+    return true;
+}
+
+void SampleLogWriter::attach (BMP085* _device)
+{
+    BMP085::Calibration calibration;
+    _device->getCalibration(&calibration);
+    setCalibration(calibration);
+
+    m_device = _device;
+    m_device->registerListener(sampleHandler, this);
+}
+
+void SampleLogWriter::detach ()
+{
+    if (m_device == NULL)
+        return;
+
+    m_device->unregisterListener(sampleHandler);
+    m_device = NULL;
+}
+
+void SampleLogWriter::sync ()
+{
+    pthread_mutex_lock (&m_logMutex);
+    if (m_header != NULL)
+        msync (m_segment.m_map, m_segment.m_mapSize, MS_ASYNC);
+    pthread_mutex_unlock (&m_logMutex);
+}
+
+void SampleLogWriter::sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    SampleLogWriter* _this = static_cast<SampleLogWriter*>(_data);
+
+    // Listeners run during the dispatch, so the sample OSSR is this sample's
+    _this->append (_temp, _pressure, (uint8_t) _this->m_device->getSampleOSSR());
+}
+
+void* SampleLogWriter::segmentThread (void* _data)
+{
+    SampleLogWriter* _this = static_cast<SampleLogWriter*>(_data);
+    EMBED_TRACE_THREAD_NAME("SampleLogWriter");
+
+    pthread_mutex_lock (&_this->m_segmentMutex);
+    while (true)
+    {
+        bool needSpare = _this->m_running && !_this->m_spareReady && !_this->m_spareFailed;
+        if (!needSpare && _this->m_unpublished.empty() && _this->m_retired.empty())
+        {
+            if (!_this->m_running)
+                break;
+
+            pthread_cond_wait (&_this->m_segmentCond, &_this->m_segmentMutex);
+            continue;
+        }
+
+        // Copied out so the members keep their capacity and rotating
+        // never allocates
+        std::vector<uint64_t> unpublished(_this->m_unpublished);
+        std::vector<Segment> retired(_this->m_retired);
+        _this->m_unpublished.clear();
+        _this->m_retired.clear();
+        // The last spare handed out, or the first from init
+        uint64_t spareSequence = _this->m_spare.m_sequence + 1;
+        pthread_mutex_unlock (&_this->m_segmentMutex);
+
+        // Publish the new segment before letting go of the sealed one
+        for (uint32_t i = 0; i < unpublished.size(); i++)
+            _this->publishSegment(unpublished[i]);
+        for (uint32_t i = 0; i < retired.size(); i++)
+        {
+            msync (retired[i].m_map, retired[i].m_mapSize, MS_ASYNC);
+            munmap (retired[i].m_map, retired[i].m_mapSize);
+        }
+
+        Segment spare;
+        bool spareReady = needSpare && _this->prepareSegment(spareSequence, &spare);
+
+        pthread_mutex_lock (&_this->m_segmentMutex);
+        if (needSpare)
+        {
+            _this->m_spare = spare;
+            _this->m_spareReady = spareReady;
+            _this->m_spareFailed = !spareReady;
+            pthread_cond_broadcast (&_this->m_spareCond);
+        }
+    }
+    pthread_mutex_unlock (&_this->m_segmentMutex);
+
+    return NULL;
+}
+
+bool SampleLogWriter::rotate ()
+{
+    // Readers following the log move on once the segment is sealed
+    __atomic_store_n (&m_header->m_sealed, 1, __ATOMIC_RELEASE);
+    Segment sealed = m_segment;
+    m_header = NULL;
+    m_records = NULL;
+
+    // Only waits if rotations come faster than the thread makes segments
+    pthread_mutex_lock (&m_segmentMutex);
+    while (!m_spareReady && !m_spareFailed)
+        pthread_cond_wait (&m_spareCond, &m_segmentMutex);
+    Segment spare = m_spare;
+    bool spareReady = m_spareReady;
+    m_spareReady = false;
+    pthread_mutex_unlock (&m_segmentMutex);
+
+    if (spareReady)
+        startSegment(spare);
+
+    // The segment is stamped before the thread makes it visible
+    pthread_mutex_lock (&m_segmentMutex);
+    m_retired.push_back(sealed);
+    if (spareReady)
+        m_unpublished.push_back(spare.m_sequence);
+    pthread_cond_signal (&m_segmentCond);
+    pthread_mutex_unlock (&m_segmentMutex);
+
+    if (!spareReady)
+        fprintf(stderr, "SampleLogWriter::rotate no segment to rotate to\n");
+
+    return spareReady;
+}
+
+void SampleLogWriter::startSegment (const Segment& _segment)
+{
+    m_segment = _segment;
+    m_sequence = _segment.m_sequence;
+    m_header = reinterpret_cast<SampleSegmentHeader*>(m_segment.m_map);
+    m_records = reinterpret_cast<SampleRecord*>(m_segment.m_map + sizeof(SampleSegmentHeader));
+    m_segmentRecords = 0;
+
+    struct timespec wall;
+    clock_gettime (CLOCK_REALTIME, &wall);
+
+    m_header->m_clockStartUs = m_clock->nowUs();
+    m_header->m_wallStartUs = ((uint64_t) wall.tv_sec) * 1000000 + wall.tv_nsec / 1000;
+    m_header->m_calibration = m_calibration;
+    m_header->m_hasCalibration = m_hasCalibration ? 1 : 0;
+}
+
+void SampleLogWriter::closeSegment ()
+{
+    if (m_header == NULL)
+        return;
+
+    // Readers following the log move on once the segment is sealed
+    __atomic_store_n (&m_header->m_sealed, 1, __ATOMIC_RELEASE);
+    msync (m_segment.m_map, m_segment.m_mapSize, MS_ASYNC);
+    munmap (m_segment.m_map, m_segment.m_mapSize);
+
+    m_segment.m_map = NULL;
+    m_segment.m_mapSize = 0;
+    m_header = NULL;
+    m_records = NULL;
+    m_segmentRecords = 0;
+}
+
+bool SampleLogWriter::prepareSegment (const uint64_t _sequence, Segment* _segment)
+{
+    std::string tmpPath = segmentPath(_sequence) + ".tmp";
+
+    int32_t fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "SampleLogWriter::prepareSegment open error: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Allocate the blocks now, a full disk would otherwise be a SIGBUS on
+    // a later record store
+    size_t size = sizeof(SampleSegmentHeader) + ((size_t) m_recordsPerSegment) * sizeof(SampleRecord);
+    int32_t rc = posix_fallocate(fd, 0, size);
+    if (rc != 0)
+    {
+        fprintf(stderr, "SampleLogWriter::prepareSegment posix_fallocate error: %s\n", strerror(rc));
+        close(fd);
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "SampleLogWriter::prepareSegment mmap error: %s\n", strerror(errno));
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    _segment->m_sequence = _sequence;
+    _segment->m_map = static_cast<uint8_t*>(map);
+    _segment->m_mapSize = size;
+
+    // Take the write faults here rather than on the record stores
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < size; offset += pageSize)
+        _segment->m_map[offset] = 0;
+
+    // The start times and calibration are filled in when it is started
+    SampleSegmentHeader* header = reinterpret_cast<SampleSegmentHeader*>(_segment->m_map);
+    memcpy (header->m_magic, SAMPLE_LOG_MAGIC, sizeof(SAMPLE_LOG_MAGIC));
+    header->m_version = SAMPLE_LOG_VERSION;
+    header->m_headerSize = sizeof(SampleSegmentHeader);
+    header->m_recordSize = sizeof(SampleRecord);
+    header->m_sequence = _sequence;
+    header->m_capacity = m_recordsPerSegment;
+    header->m_numRecords = 0;
+    header->m_sealed = 0;
+
+    return true;
+}
+
+bool SampleLogWriter::publishSegment (const uint64_t _sequence)
+{
+    std::string path = segmentPath(_sequence);
+    if (rename((path + ".tmp").c_str(), path.c_str()) < 0)
+    {
+        fprintf(stderr, "SampleLogWriter::publishSegment rename error: %s\n", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+std::string SampleLogWriter::segmentPath (const uint64_t _sequence)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "-%08llu", (unsigned long long) _sequence);
+    return m_dir + "/" + m_name + name + SAMPLE_LOG_EXTENSION;
+}
+
+uint64_t SampleLogWriter::findNextSequence ()
+{
+    // Segments are <name>-<sequence>.slog, start after the highest
+    uint64_t next = 1;
+
+    DIR* dir = opendir(m_dir.c_str());
+    if (dir == NULL)
+        return next;
+
+    std::string prefix = m_name + "-";
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        std::string file = entry->d_name;
+        size_t extLen = strlen(SAMPLE_LOG_EXTENSION);
+        if (file.size() <= prefix.size() + extLen || file.compare(0, prefix.size(), prefix) != 0 ||
+            file.compare(file.size() - extLen, extLen, SAMPLE_LOG_EXTENSION) != 0)
+            continue;
+
+        uint64_t sequence = strtoull(file.c_str() + prefix.size(), NULL, 10);
+        if (sequence >= next)
+            next = sequence + 1;
+    }
+    closedir(dir);
+
+    return next;
+}
@@ -0,0 +1,281 @@
+/*
+ * Filename: sensor_client.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sensor daemon client
+ */
+
+#include "sensor_client.h"
+
+using namespace embed;
+
+SensorClient::SensorClient (const char* _path, const uint32_t _maxQueued) :
+    m_path (_path),
+    m_maxQueued (_maxQueued),
+    m_fd (-1),
+    m_samples (),
+    m_numSamplesDropped (0),
+    m_calibration (),
+    m_hasCalibration (false),
+    m_batchId (0),
+    m_resultLen (0),
+    m_resultReady (false)
+{
+}
+
+SensorClient::~SensorClient ()
+{
+    destroy();
+}
+
+bool SensorClient::init ()
+{
+    if (m_fd != -1)
+        return true;
+
+    struct sockaddr_un addr;
+    memset (&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (m_path.size() >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "SensorClient::init socket path %s is too long\n", m_path.c_str());
+        return false;
+    }
+    strcpy (addr.sun_path, m_path.c_str());
+
+    if ((m_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)) < 0)
+    {
+        fprintf(stderr, "SensorClient::init socket error: %s\n", strerror(errno));
+        return false;
+    }
+
+    if (connect(m_fd, (struct sockaddr*) &addr, sizeof(addr)) < 0)
+    {
+        fprintf(stderr, "SensorClient::init connect error: %s\n", strerror(errno));
+        destroy();
+        return false;
+    }
+
+    if (!receiveUntil(SENSOR_HELLO, REPLY_TIMEOUT_US))
+    {
+        fprintf(stderr, "SensorClient::init no compatible daemon at %s\n", m_path.c_str());
+        destroy();
+        return false;
+    }
+
+    return true;
+}
+
+void SensorClient::destroy ()
+{
+    if (m_fd == -1)
+        return;
+
+    close(m_fd);
+    m_fd = -1;
+    m_samples.clear();
+    m_hasCalibration = false;
+}
+
+uint8_t SensorClient::readReg (const uint8_t _addr, const uint8_t _reg)
+{
+    SensorBatchOp op = {SENSOR_OP_READ, _addr, _reg, 0};
+    uint8_t val = 0;
+    transfer(&op, 1, &val, 1);
+
+    return val;
+}
+
+void SensorClient::writeReg (const uint8_t _addr, const uint8_t _reg, const uint8_t _val)
+{
+    SensorBatchOp op = {SENSOR_OP_WRITE, _addr, _reg, _val};
+    transfer(&op, 1, NULL, 0);
+}
+
+void SensorClient::readRegs (const uint8_t _addr, const uint8_t _reg, uint8_t* _buf, const uint32_t _len)
+{
+    // Bursts longer than an operation allows are split
+    memset (_buf, 0, _len);
+    SensorBatchOp ops[SENSOR_MAX_BATCH_OPS];
+    uint32_t num = 0;
+    for (uint32_t offset = 0; offset < _len && num < SENSOR_MAX_BATCH_OPS; offset += UINT8_MAX, num++)
+    {
+        uint32_t len = _len - offset < UINT8_MAX ? _len - offset : UINT8_MAX;
+        SensorBatchOp op = {SENSOR_OP_READ_BURST, _addr, (uint8_t) (_reg + offset), (uint8_t) len};
+        ops[num] = op;
+    }
+    transfer(ops, num, _buf, _len);
+}
+
+bool SensorClient::transfer (const SensorBatchOp* _ops, const uint32_t _num, uint8_t* _readBuf,
+                             const uint32_t _readLen)
+{
+    if (m_fd == -1 || _num > SENSOR_MAX_BATCH_OPS)
+        return false;
+
+    uint8_t msg[SENSOR_MAX_MESSAGE_SIZE];
+    m_batchId++;
+    msg[0] = SENSOR_BATCH;
+    memcpy (&msg[1], &m_batchId, sizeof(m_batchId));
+    msg[3] = (uint8_t) _num;
+    memcpy (&msg[SENSOR_BATCH_HEADER_SIZE], _ops, _num * sizeof(SensorBatchOp));
+    size_t len = SENSOR_BATCH_HEADER_SIZE + _num * sizeof(SensorBatchOp);
+    if (send(m_fd, msg, len, MSG_NOSIGNAL) != (ssize_t) len)
+    {
+        fprintf(stderr, "SensorClient::transfer send error: %s\n", strerror(errno));
+        return false;
+    }
+
+    m_resultReady = false;
+    if (!receiveUntil(SENSOR_BATCH_RESULT, REPLY_TIMEOUT_US) || !m_resultReady)
+    {
+        fprintf(stderr, "SensorClient::transfer no result\n");
+        return false;
+    }
+
+    if (m_result[3] != SENSOR_STATUS_OK || m_resultLen - SENSOR_BATCH_RESULT_HEADER_SIZE != _readLen)
+    {
+        fprintf(stderr, "SensorClient::transfer batch rejected\n");
+        return false;
+    }
+
+    if (_readLen > 0)
+        memcpy (_readBuf, &m_result[SENSOR_BATCH_RESULT_HEADER_SIZE], _readLen);
+
+    return true;
+}
+
+bool SensorClient::subscribe (const BMP085::OSSR_SETTING _ossr)
+{
+    if (m_fd == -1)
+        return false;
+
+    uint8_t msg[2] = {SENSOR_SUBSCRIBE, (uint8_t) _ossr};
+    if (send(m_fd, msg, sizeof(msg), MSG_NOSIGNAL) != (ssize_t) sizeof(msg))
+    {
+        fprintf(stderr, "SensorClient::subscribe send error: %s\n", strerror(errno));
+        return false;
+    }
+
+    return receiveUntil(SENSOR_CALIBRATION, REPLY_TIMEOUT_US);
+}
+
+bool SensorClient::unsubscribe ()
+{
+    if (m_fd == -1)
+        return false;
+
+    uint8_t msg[1] = {SENSOR_UNSUBSCRIBE};
+    if (send(m_fd, msg, sizeof(msg), MSG_NOSIGNAL) != (ssize_t) sizeof(msg))
+    {
+        fprintf(stderr, "SensorClient::unsubscribe send error: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Samples already sent are of no use now
+    m_samples.clear();
+
+    return true;
+}
+
+bool SensorClient::getCalibration (BMP085::Calibration* _calibration)
+{
+    if (!m_hasCalibration)
+        return false;
+
+    (*_calibration) = m_calibration;
+    return true;
+}
+
+bool SensorClient::readSample (SampleRecord* _record, const uint64_t _timeoutUs)
+{
+    if (m_samples.empty() && !receiveUntil(SENSOR_SAMPLE, _timeoutUs))
+        return false;
+
+    (*_record) = m_samples.front();
+    m_samples.pop_front();
+
+    return true;
+}
+
+SENSOR_MESSAGE SensorClient::receive (const uint64_t _timeoutUs)
+{
+    struct pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, (_timeoutUs + 999) / 1000) <= 0)
+        return SENSOR_MESSAGE_NUM;
+
+    uint8_t msg[SENSOR_MAX_MESSAGE_SIZE];
+    ssize_t len = recv(m_fd, msg, sizeof(msg), MSG_DONTWAIT);
+    if (len <= 0)
+    {
+        // The daemon has gone, later calls fail at once
+        if (len == 0 || (errno != EAGAIN && errno != EINTR))
+        {
+            fprintf(stderr, "SensorClient::receive daemon closed the connection\n");
+            destroy();
+        }
+        return SENSOR_MESSAGE_NUM;
+    }
+
+    switch (msg[0])
+    {
+        case SENSOR_HELLO:
+            if (len != 2 || msg[1] != SENSOR_PROTOCOL_VERSION)
+                return SENSOR_MESSAGE_NUM;
+            return SENSOR_HELLO;
+        case SENSOR_CALIBRATION:
+            if (len != 1 + sizeof(BMP085::Calibration))
+                return SENSOR_MESSAGE_NUM;
+            memcpy (&m_calibration, &msg[1], sizeof(m_calibration));
+            m_hasCalibration = true;
+            return SENSOR_CALIBRATION;
+        case SENSOR_SAMPLE:
+        {
+            if (len != 1 + sizeof(SampleRecord))
+                return SENSOR_MESSAGE_NUM;
+            SampleRecord record;
+            memcpy (&record, &msg[1], sizeof(record));
+            if (m_samples.size() >= m_maxQueued)
+            {
+                m_samples.pop_front();
+                m_numSamplesDropped++;
+            }
+            m_samples.push_back(record);
+            return SENSOR_SAMPLE;
+        }
+        case SENSOR_BATCH_RESULT:
+        {
+            uint16_t id;
+            if (len < (ssize_t) SENSOR_BATCH_RESULT_HEADER_SIZE)
+                return SENSOR_MESSAGE_NUM;
+            memcpy (&id, &msg[1], sizeof(id));
+            if (id != m_batchId)
+                return SENSOR_MESSAGE_NUM;
+            memcpy (m_result, msg, len);
+            m_resultLen = len;
+            m_resultReady = true;
+            return SENSOR_BATCH_RESULT;
+        }
+        default:
+            return SENSOR_MESSAGE_NUM;
+    }
+}
+
+bool SensorClient::receiveUntil (SENSOR_MESSAGE _type, const uint64_t _timeoutUs)
+{
+    uint64_t deadlineUs = SystemClock::Instance()->nowUs() + _timeoutUs;
+    while (m_fd != -1)
+    {
+        uint64_t nowUs = SystemClock::Instance()->nowUs();
+        if (receive(nowUs < deadlineUs ? deadlineUs - nowUs : 0) == _type)
+            return true;
+
+        if (SystemClock::Instance()->nowUs() >= deadlineUs)
+            return false;
+    }
+
+    return false;
+}
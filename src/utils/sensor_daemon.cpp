@@ -0,0 +1,430 @@
+/*
+ * Filename: sensor_daemon.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the sensor daemon
+ */
+
+#include "sensor_daemon.h"
+
+using namespace embed;
+
+SensorDaemon::SensorDaemon (const char* _path, LockedI2C* _bus, BMP085* _device, Clock* _clock) :
+    m_path (_path),
+    m_bus (_bus),
+    m_device (_device),
+    m_clock (_clock != NULL ? _clock : SystemClock::Instance()),
+    m_listenFd (-1),
+    m_thread (),
+    m_running (false),
+    m_clients (),
+    m_clientsMutex (),
+    m_streaming (false),
+    m_streamOssr (BMP085::OSSR_LOW_POWER),
+    m_numStreamStarts (0),
+    m_numSamples (0),
+    m_numSamplesSent (0),
+    m_numSamplesDropped (0),
+    m_numBatches (0)
+{
+    m_wakePipe[0] = -1;
+    m_wakePipe[1] = -1;
+    pthread_mutex_init (&m_clientsMutex, NULL);
+}
+
+SensorDaemon::~SensorDaemon ()
+{
+    destroy();
+    pthread_mutex_destroy (&m_clientsMutex);
+}
+
+bool SensorDaemon::init ()
+{
+    if (m_running)
+        return true;
+
+    struct sockaddr_un addr;
+    memset (&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (m_path.size() >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "SensorDaemon::init socket path %s is too long\n", m_path.c_str());
+        return false;
+    }
+    strcpy (addr.sun_path, m_path.c_str());
+
+    if ((m_listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)) < 0)
+    {
+        fprintf(stderr, "SensorDaemon::init socket error: %s\n", strerror(errno));
+        return false;
+    }
+
+    unlink(m_path.c_str());
+    if (bind(m_listenFd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(m_listenFd, 16) < 0)
+    {
+        fprintf(stderr, "SensorDaemon::init bind error: %s\n", strerror(errno));
+        close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    if (pipe2(m_wakePipe, O_CLOEXEC) < 0)
+    {
+        fprintf(stderr, "SensorDaemon::init pipe error: %s\n", strerror(errno));
+        close(m_listenFd);
+        m_listenFd = -1;
+        unlink(m_path.c_str());
+        return false;
+    }
+
+    m_running = true;
+    if (pthread_create(&m_thread, NULL, serveThread, this) != 0)
+    {
+        fprintf(stderr, "SensorDaemon::init pthread_create error\n");
+        m_running = false;
+        close(m_wakePipe[0]);
+        close(m_wakePipe[1]);
+        close(m_listenFd);
+        m_listenFd = -1;
+        unlink(m_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void SensorDaemon::destroy ()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    char wake = 0;
+    if (write(m_wakePipe[1], &wake, 1) != 1)
+        fprintf(stderr, "SensorDaemon::destroy write error: %s\n", strerror(errno));
+    pthread_join(m_thread, NULL);
+
+    // The serve thread has closed the clients and stopped the stream
+    close(m_wakePipe[0]);
+    close(m_wakePipe[1]);
+    close(m_listenFd);
+    m_listenFd = -1;
+    unlink(m_path.c_str());
+}
+
+uint32_t SensorDaemon::getNumClients ()
+{
+    pthread_mutex_lock (&m_clientsMutex);
+    uint32_t num = m_clients.size();
+    pthread_mutex_unlock (&m_clientsMutex);
+
+    return num;
+}
+
+uint32_t SensorDaemon::getNumSubscribers ()
+{
+    pthread_mutex_lock (&m_clientsMutex);
+    uint32_t num = 0;
+    std::map<int32_t,Client>::iterator it;
+    for (it = m_clients.begin(); it != m_clients.end(); it++)
+        num += it->second.m_ossr != NO_OSSR ? 1 : 0;
+    pthread_mutex_unlock (&m_clientsMutex);
+
+    return num;
+}
+
+void* SensorDaemon::serveThread (void* _data)
+{
+    static_cast<SensorDaemon*>(_data)->serve();
+    return NULL;
+}
+
+void SensorDaemon::serve ()
+{
+    std::vector<struct pollfd> fds;
+    uint8_t buf[SENSOR_MAX_MESSAGE_SIZE];
+    while (m_running)
+    {
+        fds.clear();
+        struct pollfd pfd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        pfd.fd = m_wakePipe[0];
+        fds.push_back(pfd);
+        pfd.fd = m_listenFd;
+        fds.push_back(pfd);
+
+        pthread_mutex_lock (&m_clientsMutex);
+        std::map<int32_t,Client>::iterator it;
+        for (it = m_clients.begin(); it != m_clients.end(); it++)
+        {
+            pfd.fd = it->first;
+            fds.push_back(pfd);
+        }
+        pthread_mutex_unlock (&m_clientsMutex);
+
+        if (poll(&fds[0], fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            fprintf(stderr, "SensorDaemon::serve poll error: %s\n", strerror(errno));
+            break;
+        }
+
+        if (fds[0].revents != 0)
+            break;
+
+        if (fds[1].revents & POLLIN)
+            acceptClient();
+
+        for (uint32_t i = 2; i < fds.size(); i++)
+        {
+            if (fds[i].revents == 0)
+                continue;
+
+            ssize_t len = recv(fds[i].fd, buf, sizeof(buf), MSG_DONTWAIT | MSG_TRUNC);
+            if (len < 0 && (errno == EAGAIN || errno == EINTR))
+                continue;
+
+            // Closed, failed or sent a message longer than any valid one
+            if (len <= 0 || len > (ssize_t) sizeof(buf) || !handleMessage(fds[i].fd, buf, len))
+                closeClient(fds[i].fd);
+        }
+    }
+
+    // Shut down
+    std::vector<int32_t> clients;
+    pthread_mutex_lock (&m_clientsMutex);
+    std::map<int32_t,Client>::iterator it;
+    for (it = m_clients.begin(); it != m_clients.end(); it++)
+        clients.push_back(it->first);
+    pthread_mutex_unlock (&m_clientsMutex);
+    for (uint32_t i = 0; i < clients.size(); i++)
+        closeClient(clients[i]);
+}
+
+void SensorDaemon::acceptClient ()
+{
+    int32_t fd = accept4(m_listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+    {
+        fprintf(stderr, "SensorDaemon::acceptClient accept error: %s\n", strerror(errno));
+        return;
+    }
+
+    uint8_t hello[2] = {SENSOR_HELLO, SENSOR_PROTOCOL_VERSION};
+    if (!send(fd, hello, sizeof(hello)))
+    {
+        close(fd);
+        return;
+    }
+
+    Client client;
+    client.m_fd = fd;
+    client.m_ossr = NO_OSSR;
+    pthread_mutex_lock (&m_clientsMutex);
+    m_clients[fd] = client;
+    pthread_mutex_unlock (&m_clientsMutex);
+}
+
+void SensorDaemon::closeClient (const int32_t _fd)
+{
+    pthread_mutex_lock (&m_clientsMutex);
+    bool subscribed = m_clients[_fd].m_ossr != NO_OSSR;
+    m_clients.erase(_fd);
+    pthread_mutex_unlock (&m_clientsMutex);
+
+    close(_fd);
+    if (subscribed)
+        updateStream();
+}
+
+bool SensorDaemon::handleMessage (const int32_t _fd, const uint8_t* _buf, const size_t _len)
+{
+    switch (_buf[0])
+    {
+        case SENSOR_SUBSCRIBE:
+        {
+            if (_len != 2 || _buf[1] >= BMP085::OSSR_NUM)
+                return false;
+
+            // A client subscribing again is left out until the calibration
+            // has gone, so its old setting does not hold the stream up
+            pthread_mutex_lock (&m_clientsMutex);
+            m_clients[_fd].m_ossr = NO_OSSR;
+            pthread_mutex_unlock (&m_clientsMutex);
+
+            // Start the stream first so the calibration has been read and
+            // goes out before any sample. A device that would not start
+            // has no calibration to send, the client is dropped instead.
+            updateStream(_buf[1]);
+            if (!m_streaming)
+                return false;
+
+            uint8_t msg[1 + sizeof(BMP085::Calibration)];
+            msg[0] = SENSOR_CALIBRATION;
+            BMP085::Calibration calibration;
+            m_device->getCalibration(&calibration);
+            memcpy (&msg[1], &calibration, sizeof(calibration));
+            if (!send(_fd, msg, sizeof(msg)))
+                return false;
+
+            pthread_mutex_lock (&m_clientsMutex);
+            m_clients[_fd].m_ossr = _buf[1];
+            pthread_mutex_unlock (&m_clientsMutex);
+            return true;
+        }
+        case SENSOR_UNSUBSCRIBE:
+        {
+            pthread_mutex_lock (&m_clientsMutex);
+            m_clients[_fd].m_ossr = NO_OSSR;
+            pthread_mutex_unlock (&m_clientsMutex);
+
+            updateStream();
+            return true;
+        }
+        case SENSOR_BATCH:
+            return handleBatch(_fd, _buf, _len);
+        default:
+            return false;
+    }
+}
+
+bool SensorDaemon::handleBatch (const int32_t _fd, const uint8_t* _buf, const size_t _len)
+{
+    if (_len < SENSOR_BATCH_HEADER_SIZE)
+        return false;
+
+    uint16_t id;
+    memcpy (&id, &_buf[1], sizeof(id));
+    uint32_t numOps = _buf[3];
+
+    uint8_t result[SENSOR_MAX_MESSAGE_SIZE];
+    result[0] = SENSOR_BATCH_RESULT;
+    memcpy (&result[1], &id, sizeof(id));
+    result[3] = SENSOR_STATUS_OK;
+    uint32_t resultLen = SENSOR_BATCH_RESULT_HEADER_SIZE;
+
+    // Check the whole batch before touching the bus
+    const SensorBatchOp* ops = reinterpret_cast<const SensorBatchOp*>(&_buf[SENSOR_BATCH_HEADER_SIZE]);
+    bool valid = _len == SENSOR_BATCH_HEADER_SIZE + numOps * sizeof(SensorBatchOp);
+    uint32_t readLen = 0;
+    for (uint32_t i = 0; valid && i < numOps; i++)
+    {
+        if (ops[i].m_type == SENSOR_OP_READ)
+            readLen += 1;
+        else if (ops[i].m_type == SENSOR_OP_READ_BURST)
+            readLen += ops[i].m_arg;
+        else if (ops[i].m_type != SENSOR_OP_WRITE)
+            valid = false;
+    }
+    valid &= resultLen + readLen <= sizeof(result);
+
+    if (valid)
+    {
+        m_bus->lock();
+        for (uint32_t i = 0; i < numOps; i++)
+        {
+            const SensorBatchOp& op = ops[i];
+            if (op.m_type == SENSOR_OP_READ)
+                result[resultLen++] = m_bus->readReg(op.m_addr, op.m_reg);
+            else if (op.m_type == SENSOR_OP_WRITE)
+                m_bus->writeReg(op.m_addr, op.m_reg, op.m_arg);
+            else
+            {
+                m_bus->readRegs(op.m_addr, op.m_reg, &result[resultLen], op.m_arg);
+                resultLen += op.m_arg;
+            }
+        }
+        m_bus->unlock();
+        m_numBatches++;
+    }
+    else
+        result[3] = SENSOR_STATUS_BAD_REQUEST;
+
+    return send(_fd, result, resultLen);
+}
+
+bool SensorDaemon::send (const int32_t _fd, const uint8_t* _buf, const size_t _len)
+{
+    // Replies are rare next to samples, a client whose queue is full of
+    // samples it has not read is not reading
+    if (::send(_fd, _buf, _len, MSG_DONTWAIT | MSG_NOSIGNAL) != (ssize_t) _len)
+    {
+        fprintf(stderr, "SensorDaemon::send error: %s\n", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void SensorDaemon::updateStream (const int32_t _extraOssr)
+{
+    int32_t ossr = _extraOssr;
+    pthread_mutex_lock (&m_clientsMutex);
+    std::map<int32_t,Client>::iterator it;
+    for (it = m_clients.begin(); it != m_clients.end(); it++)
+    {
+        if (it->second.m_ossr > ossr)
+            ossr = it->second.m_ossr;
+    }
+    pthread_mutex_unlock (&m_clientsMutex);
+
+    if (ossr == NO_OSSR)
+    {
+        if (m_streaming)
+        {
+            m_device->unregisterListener(sampleHandler);
+            m_device->destroy();
+            m_streaming = false;
+        }
+        return;
+    }
+
+    m_streamOssr = (BMP085::OSSR_SETTING) ossr;
+    m_device->setOSSR(m_streamOssr);
+    if (!m_streaming)
+    {
+        if (!m_device->init(true))
+        {
+            fprintf(stderr, "SensorDaemon::updateStream BMP085 init failed\n");
+            return;
+        }
+        m_device->registerListener(sampleHandler, this);
+        m_streaming = true;
+        m_numStreamStarts++;
+    }
+}
+
+void SensorDaemon::sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    SensorDaemon* _this = static_cast<SensorDaemon*>(_data);
+
+    uint8_t msg[1 + sizeof(SampleRecord)];
+    SampleRecord record;
+    record.m_timeUs = _this->m_clock->nowUs();
+    record.m_rawPressure = _pressure;
+    record.m_rawTemp = _temp;
+    record.m_ossr = (uint8_t) _this->m_device->getSampleOSSR();
+    record.m_reserved = 0;
+    msg[0] = SENSOR_SAMPLE;
+    memcpy (&msg[1], &record, sizeof(record));
+
+    // One encoding for every subscriber, a full socket drops the sample
+    // for that client only
+    pthread_mutex_lock (&_this->m_clientsMutex);
+    _this->m_numSamples++;
+    std::map<int32_t,Client>::iterator it;
+    for (it = _this->m_clients.begin(); it != _this->m_clients.end(); it++)
+    {
+        if (it->second.m_ossr == NO_OSSR)
+            continue;
+
+        if (::send(it->first, msg, sizeof(msg), MSG_DONTWAIT | MSG_NOSIGNAL) == (ssize_t) sizeof(msg))
+            _this->m_numSamplesSent++;
+        else
+            _this->m_numSamplesDropped++;
+    }
+    pthread_mutex_unlock (&_this->m_clientsMutex);
+}
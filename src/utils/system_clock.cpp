@@ -0,0 +1,47 @@
+/*
+ * Filename: system_clock.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the clock backed by CLOCK_MONOTONIC
+ */
+
+#include "system_clock.h"
+
+using namespace embed;
+
+SystemClock* SystemClock::m_instance = NULL;
+
+SystemClock* SystemClock::Instance()
+{
+    if (!m_instance)
+        m_instance = new SystemClock;
+
+    return m_instance;
+}
+
+uint64_t SystemClock::nowUs ()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+void SystemClock::sleepUs (uint64_t _delayUs)
+{
+    // Sleep to an absolute deadline so signals do not cut it short
+    uint64_t deadlineUs = nowUs() + _delayUs;
+    struct timespec deadline;
+    deadline.tv_sec = deadlineUs / 1000000;
+    deadline.tv_nsec = (deadlineUs % 1000000) * 1000;
+
+    while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+}
+
+bool SystemClock::waitUntil (pthread_cond_t* _cond, pthread_mutex_t* _mutex, uint64_t _deadlineUs)
+{
+    struct timespec deadline;
+    deadline.tv_sec = _deadlineUs / 1000000;
+    deadline.tv_nsec = (_deadlineUs % 1000000) * 1000;
+
+    return pthread_cond_timedwait (_cond, _mutex, &deadline) != ETIMEDOUT;
+}
@@ -0,0 +1,185 @@
+/*
+ * Filename: t_digest.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for a merging t-digest
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#include "t_digest.h"
+
+using namespace embed;
+
+TDigest::TDigest (double _compression) :
+    m_compression (_compression),
+    m_numCentroids (0),
+    m_numBuffered (0),
+    m_totalWeight (0.0),
+    m_min (INFINITY),
+    m_max (-INFINITY)
+{
+    // The scale function spans _compression / 2, and two neighbouring
+    // centroids always span more than 1 or they would have been merged
+    m_maxCentroids = ((uint32_t) ceil(m_compression)) + 2;
+    m_bufferSize = 5 * m_maxCentroids;
+
+    m_centroids.resize(m_maxCentroids);
+    m_buffer.resize(m_bufferSize);
+    m_scratch.resize(m_maxCentroids + m_bufferSize);
+}
+
+TDigest::~TDigest ()
+{
+}
+
+void TDigest::reset ()
+{
+    m_numCentroids = 0;
+    m_numBuffered = 0;
+    m_totalWeight = 0.0;
+    m_min = INFINITY;
+    m_max = -INFINITY;
+}
+
+void TDigest::addValue (double _val, double _weight)
+{
+    if (m_numBuffered == m_bufferSize)
+        flush();
+
+    m_buffer[m_numBuffered].m_mean = _val;
+    m_buffer[m_numBuffered].m_weight = _weight;
+    m_numBuffered++;
+
+    m_totalWeight += _weight;
+    if (_val < m_min)
+        m_min = _val;
+    if (_val > m_max)
+        m_max = _val;
+}
+
+void TDigest::merge (const TDigest& _other)
+{
+    // The other digest's centroids are just weighted samples to this one
+    for (uint32_t i = 0; i < _other.m_numCentroids; i++)
+        addValue(_other.m_centroids[i].m_mean, _other.m_centroids[i].m_weight);
+    for (uint32_t i = 0; i < _other.m_numBuffered; i++)
+        addValue(_other.m_buffer[i].m_mean, _other.m_buffer[i].m_weight);
+
+    // Centroid means lie inside the range, the extremes are exact
+    if (_other.m_min < m_min)
+        m_min = _other.m_min;
+    if (_other.m_max > m_max)
+        m_max = _other.m_max;
+}
+
+double TDigest::getMin () const
+{
+    return (m_totalWeight > 0.0) ? m_min : nan("");
+}
+
+double TDigest::getMax () const
+{
+    return (m_totalWeight > 0.0) ? m_max : nan("");
+}
+
+double TDigest::getQuantile (double _quantile)
+{
+    flush();
+
+    if (m_numCentroids == 0)
+        return nan("");
+    if (m_numCentroids == 1)
+        return m_centroids[0].m_mean;
+
+    // Rank of the requested sample, each centroid's weight is taken to be
+    // centred on its mean and the extremes are single samples
+    double index = _quantile * m_totalWeight;
+    if (index <= 0.5)
+        return m_min;
+    if (index >= m_totalWeight - 0.5)
+        return m_max;
+
+    const Centroid& first = m_centroids[0];
+    if (index < first.m_weight / 2.0)
+        return m_min + (index - 0.5) / (first.m_weight / 2.0 - 0.5) * (first.m_mean - m_min);
+
+    double cumulative = first.m_weight / 2.0;
+    for (uint32_t i = 0; i + 1 < m_numCentroids; i++)
+    {
+        const Centroid& left = m_centroids[i];
+        const Centroid& right = m_centroids[i + 1];
+        double span = (left.m_weight + right.m_weight) / 2.0;
+        if (index < cumulative + span)
+            return left.m_mean + (index - cumulative) / span * (right.m_mean - left.m_mean);
+        cumulative += span;
+    }
+
+    const Centroid& last = m_centroids[m_numCentroids - 1];
+    return last.m_mean + (index - cumulative) / (last.m_weight / 2.0 - 0.5) * (m_max - last.m_mean);
+}
+
+uint32_t TDigest::getNumCentroids ()
+{
+    flush();
+
+    return m_numCentroids;
+}
+
+void TDigest::flush ()
+{
+    if (m_numBuffered == 0)
+        return;
+
+    // Sort the buffer and merge it with the centroids, which are sorted
+    std::sort(m_buffer.begin(), m_buffer.begin() + m_numBuffered);
+    std::merge(m_centroids.begin(), m_centroids.begin() + m_numCentroids,
+               m_buffer.begin(), m_buffer.begin() + m_numBuffered, m_scratch.begin());
+    uint32_t numScratch = m_numCentroids + m_numBuffered;
+
+    // Greedily grow each centroid while it spans at most 1 in scale, which
+    // is a limit on the weight before its end
+    Centroid current = m_scratch[0];
+    double weightBefore = 0.0;
+    double weightLimit = weightLimitAfter(weightBefore);
+    m_numCentroids = 0;
+    for (uint32_t i = 1; i < numScratch; i++)
+    {
+        const Centroid& next = m_scratch[i];
+        double proposed = current.m_weight + next.m_weight;
+
+        // The last slot takes everything that is left
+        if (weightBefore + proposed <= weightLimit || m_numCentroids + 1 == m_maxCentroids)
+        {
+            current.m_mean += (next.m_mean - current.m_mean) * next.m_weight / proposed;
+            current.m_weight = proposed;
+        }
+        else
+        {
+            weightBefore += current.m_weight;
+            weightLimit = weightLimitAfter(weightBefore);
+            m_centroids[m_numCentroids++] = current;
+            current = next;
+        }
+    }
+    m_centroids[m_numCentroids++] = current;
+
+    m_numBuffered = 0;
+}
+
+double TDigest::weightLimitAfter (double _weightBefore) const
+{
+    // k1 scale function, k(q) = compression / (2 pi) * asin(2q - 1), which
+    // is steep at the tails so centroids there stay small. A centroid
+    // starting at quantile q may end at k^-1(k(q) + 1).
+    double quantile = _weightBefore / m_totalWeight;
+    if (quantile >= 1.0)
+        return m_totalWeight;
+
+    double angle = asin(2.0 * quantile - 1.0) + 2.0 * M_PI / m_compression;
+    if (angle >= M_PI / 2.0)
+        return m_totalWeight;
+
+    return m_totalWeight * (sin(angle) + 1.0) / 2.0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Filename: timer_thread.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the one-shot timer thread
+ */
+
+#include "timer_thread.h"
+
+using namespace embed;
+
+TimerThread::TimerThread() :
+    m_started (false),
+    m_exit (false),
+    m_thread (),
+    m_timers (),
+    m_runningHandler (NULL),
+    m_runningData (NULL),
+    m_mutexTimers (),
+    m_condTimers ()
+{
+    pthread_mutex_init (&m_mutexTimers, NULL);
+
+    // Wait on the monotonic clock so deadlines are not affected by time changes
+    pthread_condattr_t condAttr;
+    pthread_condattr_init (&condAttr);
+    pthread_condattr_setclock (&condAttr, CLOCK_MONOTONIC);
+    pthread_cond_init (&m_condTimers, &condAttr);
+    pthread_condattr_destroy (&condAttr);
+}
+
+TimerThread::~TimerThread()
+{
+    end();
+    m_timers.clear();
+    pthread_cond_destroy (&m_condTimers);
+    pthread_mutex_destroy (&m_mutexTimers);
+}
+
+bool TimerThread::start()
+{
+    if (m_started)
+        return true;
+
+    m_exit = false;
+    if (pthread_create(&m_thread, NULL, threadMain, this) != 0)
+    {
+        fprintf(stderr, "TimerThread::start pthread_create error\n");
+        return false;
+    }
+
+    m_started = true;
+
+    return true;
+}
+
+void TimerThread::end()
+{
+    if (!m_started)
+        return;
+
+    pthread_mutex_lock (&m_mutexTimers);
+    m_exit = true;
+    pthread_cond_broadcast (&m_condTimers);
+    pthread_mutex_unlock (&m_mutexTimers);
+
+    pthread_join(m_thread, NULL);
+
+    m_started = false;
+    m_exit = false;
+}
+
+void TimerThread::schedule (uint64_t _delayUs, TimerHandler _handler, void* _data)
+{
+    TimerInfo info;
+    info.m_deadlineUs = nowUs() + _delayUs;
+    info.m_handler = _handler;
+    info.m_data = _data;
+
+    pthread_mutex_lock (&m_mutexTimers);
+
+    // Remove the timer if already pending (only a handful are expected)
+    std::vector<TimerInfo>::iterator it;
+    for (it = m_timers.begin(); it != m_timers.end(); it++)
+    {
+        if (it->m_handler == _handler && it->m_data == _data)
+        {
+            m_timers.erase(it);
+            break;
+        }
+    }
+
+    // Insert sorted by deadline
+    for (it = m_timers.begin(); it != m_timers.end(); it++)
+    {
+        if (it->m_deadlineUs > info.m_deadlineUs)
+            break;
+    }
+    m_timers.insert(it, info);
+
+    pthread_cond_broadcast (&m_condTimers);
+    pthread_mutex_unlock (&m_mutexTimers);
+}
+
+void TimerThread::cancel (TimerHandler _handler, void* _data)
+{
+    pthread_mutex_lock (&m_mutexTimers);
+
+    std::vector<TimerInfo>::iterator it;
+    for (it = m_timers.begin(); it != m_timers.end(); it++)
+    {
+        if (it->m_handler == _handler && it->m_data == _data)
+        {
+            m_timers.erase(it);
+            break;
+        }
+    }
+
+    // Make sure the handler is not still running so its data can be
+    // freed, unless we are being called from the handler itself
+    if (!m_started || !pthread_equal(pthread_self(), m_thread))
+    {
+        while (m_runningHandler == _handler && m_runningData == _data)
+            pthread_cond_wait (&m_condTimers, &m_mutexTimers);
+    }
+
+    pthread_mutex_unlock (&m_mutexTimers);
+}
+
+void* TimerThread::threadMain(void* _data)
+{
+    TimerThread* _this = static_cast<TimerThread*>(_data);
+    EMBED_TRACE_THREAD_NAME("TimerThread");
+
+    pthread_mutex_lock (&_this->m_mutexTimers);
+    while (!_this->m_exit)
+    {
+        if (_this->m_timers.size() == 0)
+        {
+            pthread_cond_wait (&_this->m_condTimers, &_this->m_mutexTimers);
+            continue;
+        }
+
+        TimerInfo next = _this->m_timers.front();
+        if (nowUs() < next.m_deadlineUs)
+        {
+            struct timespec deadline;
+            deadline.tv_sec = next.m_deadlineUs / 1000000;
+            deadline.tv_nsec = (next.m_deadlineUs % 1000000) * 1000;
+            pthread_cond_timedwait (&_this->m_condTimers, &_this->m_mutexTimers, &deadline);
+            continue;
+        }
+
+        // Run the expired timer without holding the lock, so the
+        // handler can schedule again
+        _this->m_timers.erase(_this->m_timers.begin());
+        _this->m_runningHandler = next.m_handler;
+        _this->m_runningData = next.m_data;
+        pthread_mutex_unlock (&_this->m_mutexTimers);
+
+        {
+            EMBED_TRACE_SCOPE("timer", "TimerThread::handler", 0);
+            next.m_handler (next.m_data);
+        }
+
+        pthread_mutex_lock (&_this->m_mutexTimers);
+        _this->m_runningHandler = NULL;
+        _this->m_runningData = NULL;
+        pthread_cond_broadcast (&_this->m_condTimers);
+    }
+    pthread_mutex_unlock (&_this->m_mutexTimers);
+
+    return NULL;
+}
+
+uint64_t TimerThread::nowUs()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
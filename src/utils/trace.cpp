@@ -0,0 +1,207 @@
+/*
+ * Filename: trace.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for lightweight event tracing
+ */
+
+#include "trace.h"
+
+using namespace embed;
+
+bool Trace::s_enabled = false;
+uint32_t Trace::s_eventsPerThread = Trace::DEFAULT_EVENTS_PER_THREAD;
+__thread TraceBuffer* Trace::s_buffer = NULL;
+__thread const char* Trace::s_threadName = NULL;
+std::vector<TraceBuffer*> Trace::s_buffers;
+pthread_mutex_t Trace::s_buffersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+TraceBuffer::TraceBuffer (const uint32_t _capacity, const pid_t _tid, const char* _name) :
+    m_slots (NULL),
+    m_mask (0),
+    m_head (0),
+    m_tid (_tid),
+    m_name (_name)
+{
+    uint64_t capacity = 1;
+    while (capacity < _capacity)
+        capacity <<= 1;
+
+    m_slots = new Slot[capacity];
+    memset (m_slots, 0, capacity * sizeof(Slot));
+    m_mask = capacity - 1;
+}
+
+TraceBuffer::~TraceBuffer ()
+{
+    delete[] m_slots;
+}
+
+void TraceBuffer::snapshot (std::vector<TraceEvent>* _events)
+{
+    uint64_t capacity = m_mask + 1;
+    uint64_t head = __atomic_load_n (&m_head, __ATOMIC_ACQUIRE);
+    uint64_t first = head > capacity ? head - capacity : 0;
+
+    // Events the owning thread overwrites during the copy change their
+    // slot's sequence and are left out
+    for (uint64_t i = first; i < head; i++)
+    {
+        Slot& slot = m_slots[i & m_mask];
+        if (__atomic_load_n (&slot.m_seq, __ATOMIC_ACQUIRE) != i + 1)
+            continue;
+
+        uint64_t words[SLOT_WORDS];
+        for (uint32_t j = 0; j < SLOT_WORDS; j++)
+            words[j] = __atomic_load_n (&slot.m_words[j], __ATOMIC_RELAXED);
+        __atomic_thread_fence (__ATOMIC_ACQUIRE);
+        if (__atomic_load_n (&slot.m_seq, __ATOMIC_RELAXED) != i + 1)
+            continue;
+
+        TraceEvent event;
+        memcpy (&event, words, sizeof(event));
+        _events->push_back(event);
+    }
+}
+
+void TraceBuffer::clear ()
+{
+    __atomic_store_n (&m_head, 0, __ATOMIC_RELEASE);
+}
+
+uint64_t TraceBuffer::getNumOverwritten ()
+{
+    uint64_t head = getNumRecorded();
+    return head > m_mask + 1 ? head - (m_mask + 1) : 0;
+}
+
+void Trace::setEventsPerThread (const uint32_t _numEvents)
+{
+    if (_numEvents == 0)
+    {
+        fprintf(stderr, "Trace::setEventsPerThread called with no events\n");
+        return;
+    }
+
+    __atomic_store_n (&s_eventsPerThread, _numEvents, __ATOMIC_RELAXED);
+}
+
+void Trace::setThreadName (const char* _name)
+{
+    s_threadName = _name;
+    if (s_buffer != NULL)
+        s_buffer->setName(_name);
+}
+
+TraceBuffer* Trace::createBuffer ()
+{
+    TraceBuffer* buffer = new TraceBuffer(__atomic_load_n (&s_eventsPerThread, __ATOMIC_RELAXED),
+                                          (pid_t) syscall(SYS_gettid), s_threadName);
+
+    pthread_mutex_lock (&s_buffersMutex);
+    s_buffers.push_back(buffer);
+    pthread_mutex_unlock (&s_buffersMutex);
+
+    s_buffer = buffer;
+    return buffer;
+}
+
+uint64_t Trace::getNumRecorded ()
+{
+    uint64_t num = 0;
+    pthread_mutex_lock (&s_buffersMutex);
+    for (uint32_t i = 0; i < s_buffers.size(); i++)
+        num += s_buffers[i]->getNumRecorded();
+    pthread_mutex_unlock (&s_buffersMutex);
+
+    return num;
+}
+
+uint64_t Trace::getNumOverwritten ()
+{
+    uint64_t num = 0;
+    pthread_mutex_lock (&s_buffersMutex);
+    for (uint32_t i = 0; i < s_buffers.size(); i++)
+        num += s_buffers[i]->getNumOverwritten();
+    pthread_mutex_unlock (&s_buffersMutex);
+
+    return num;
+}
+
+uint32_t Trace::getNumThreads ()
+{
+    pthread_mutex_lock (&s_buffersMutex);
+    uint32_t num = s_buffers.size();
+    pthread_mutex_unlock (&s_buffersMutex);
+
+    return num;
+}
+
+void Trace::clear ()
+{
+    pthread_mutex_lock (&s_buffersMutex);
+    for (uint32_t i = 0; i < s_buffers.size(); i++)
+        s_buffers[i]->clear();
+    pthread_mutex_unlock (&s_buffersMutex);
+}
+
+bool Trace::writeChromeJson (const char* _path)
+{
+    FILE* file = fopen(_path, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Trace::writeChromeJson fopen error: %s\n", strerror(errno));
+        return false;
+    }
+
+    pid_t pid = getpid();
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"embed\"}}",
+            pid, pid);
+
+    // Buffers are never removed, so they can be used after the lock is
+    // dropped; timestamps are written in microseconds with ns precision
+    pthread_mutex_lock (&s_buffersMutex);
+    std::vector<TraceBuffer*> buffers = s_buffers;
+    pthread_mutex_unlock (&s_buffersMutex);
+
+    std::vector<TraceEvent> events;
+    for (uint32_t i = 0; i < buffers.size(); i++)
+    {
+        TraceBuffer* buffer = buffers[i];
+        pid_t tid = buffer->getTid();
+        if (buffer->getName() != NULL)
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    pid, tid, buffer->getName());
+
+        events.clear();
+        buffer->snapshot(&events);
+        for (uint32_t j = 0; j < events.size(); j++)
+        {
+            const TraceEvent& event = events[j];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%llu.%03u",
+                    event.m_name, event.m_category, pid, tid,
+                    (unsigned long long) (event.m_startNs / 1000), (uint32_t) (event.m_startNs % 1000));
+            if (event.m_type == TRACE_COMPLETE)
+                fprintf(file, ",\"ph\":\"X\",\"dur\":%llu.%03u,\"args\":{\"arg\":%llu}}",
+                        (unsigned long long) (event.m_durationNs / 1000), (uint32_t) (event.m_durationNs % 1000),
+                        (unsigned long long) event.m_arg);
+            else if (event.m_type == TRACE_INSTANT)
+                fprintf(file, ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"arg\":%llu}}",
+                        (unsigned long long) event.m_arg);
+            else
+                fprintf(file, ",\"ph\":\"C\",\"args\":{\"value\":%llu}}",
+                        (unsigned long long) event.m_arg);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    bool ok = !ferror(file);
+    if (fclose(file) != 0)
+        ok = false;
+    if (!ok)
+        fprintf(stderr, "Trace::writeChromeJson write error\n");
+
+    return ok;
+}
@@ -0,0 +1,173 @@
+/*
+ * Filename: virtual_clock.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for the virtual time clock and timer
+ */
+
+#include "virtual_clock.h"
+
+using namespace embed;
+
+VirtualClock::VirtualClock (uint64_t _startUs) :
+    m_nowUs (_startUs),
+    m_timers (),
+    m_runningHandler (NULL),
+    m_runningData (NULL),
+    m_runningThread (),
+    m_numTimersRun (0),
+    m_mutexTimers (),
+    m_condTimers ()
+{
+    pthread_mutex_init (&m_mutexTimers, NULL);
+    pthread_cond_init (&m_condTimers, NULL);
+}
+
+VirtualClock::~VirtualClock ()
+{
+    m_timers.clear();
+    pthread_cond_destroy (&m_condTimers);
+    pthread_mutex_destroy (&m_mutexTimers);
+}
+
+uint64_t VirtualClock::nowUs ()
+{
+    pthread_mutex_lock (&m_mutexTimers);
+    uint64_t now = m_nowUs;
+    pthread_mutex_unlock (&m_mutexTimers);
+
+    return now;
+}
+
+void VirtualClock::sleepUs (uint64_t _delayUs)
+{
+    advanceTo(nowUs() + _delayUs);
+}
+
+bool VirtualClock::waitUntil (pthread_cond_t* _cond, pthread_mutex_t* _mutex, uint64_t _deadlineUs)
+{
+    // Only a timer can signal the condition, so run the next one due
+    // before the deadline in place of blocking, and let the caller check
+    // its predicate
+    pthread_mutex_unlock (_mutex);
+    bool ran = runNext(_deadlineUs);
+    if (!ran)
+        advanceTo(_deadlineUs);
+    pthread_mutex_lock (_mutex);
+
+    return ran;
+}
+
+void VirtualClock::schedule (uint64_t _delayUs, TimerHandler _handler, void* _data)
+{
+    pthread_mutex_lock (&m_mutexTimers);
+
+    TimerInfo info;
+    info.m_deadlineUs = m_nowUs + _delayUs;
+    info.m_handler = _handler;
+    info.m_data = _data;
+
+    // Remove the timer if already pending (only a handful are expected)
+    std::vector<TimerInfo>::iterator it;
+    for (it = m_timers.begin(); it != m_timers.end(); it++)
+    {
+        if (it->m_handler == _handler && it->m_data == _data)
+        {
+            m_timers.erase(it);
+            break;
+        }
+    }
+
+    // Insert sorted by deadline, after timers with the same deadline
+    for (it = m_timers.begin(); it != m_timers.end(); it++)
+    {
+        if (it->m_deadlineUs > info.m_deadlineUs)
+            break;
+    }
+    m_timers.insert(it, info);
+
+    pthread_mutex_unlock (&m_mutexTimers);
+}
+
+void VirtualClock::cancel (TimerHandler _handler, void* _data)
+{
+    pthread_mutex_lock (&m_mutexTimers);
+
+    std::vector<TimerInfo>::iterator it;
+    for (it = m_timers.begin(); it != m_timers.end(); it++)
+    {
+        if (it->m_handler == _handler && it->m_data == _data)
+        {
+            m_timers.erase(it);
+            break;
+        }
+    }
+
+    // Make sure the handler is not still running in another thread so its
+    // data can be freed
+    while (m_runningHandler == _handler && m_runningData == _data &&
+           !pthread_equal(pthread_self(), m_runningThread))
+        pthread_cond_wait (&m_condTimers, &m_mutexTimers);
+
+    pthread_mutex_unlock (&m_mutexTimers);
+}
+
+void VirtualClock::advanceTo (uint64_t _timeUs)
+{
+    while (runNext(_timeUs));
+
+    pthread_mutex_lock (&m_mutexTimers);
+    if (_timeUs > m_nowUs)
+        m_nowUs = _timeUs;
+    pthread_mutex_unlock (&m_mutexTimers);
+}
+
+uint32_t VirtualClock::getNumPending ()
+{
+    pthread_mutex_lock (&m_mutexTimers);
+    uint32_t num = m_timers.size();
+    pthread_mutex_unlock (&m_mutexTimers);
+
+    return num;
+}
+
+bool VirtualClock::runNext (uint64_t _timeUs)
+{
+    pthread_mutex_lock (&m_mutexTimers);
+
+    if (m_timers.size() == 0 || m_timers.front().m_deadlineUs > _timeUs)
+    {
+        pthread_mutex_unlock (&m_mutexTimers);
+        return false;
+    }
+
+    TimerInfo next = m_timers.front();
+    m_timers.erase(m_timers.begin());
+    if (next.m_deadlineUs > m_nowUs)
+        m_nowUs = next.m_deadlineUs;
+
+    // Handlers can sleep and run timers themselves, so restore whatever
+    // timer was running before this one
+    TimerHandler prevHandler = m_runningHandler;
+    void* prevData = m_runningData;
+    pthread_t prevThread = m_runningThread;
+    m_runningHandler = next.m_handler;
+    m_runningData = next.m_data;
+    m_runningThread = pthread_self();
+    m_numTimersRun++;
+
+    // Run the timer without holding the lock, so the handler can schedule
+    // again
+    pthread_mutex_unlock (&m_mutexTimers);
+
+    next.m_handler (next.m_data);
+
+    pthread_mutex_lock (&m_mutexTimers);
+    m_runningHandler = prevHandler;
+    m_runningData = prevData;
+    m_runningThread = prevThread;
+    pthread_cond_broadcast (&m_condTimers);
+    pthread_mutex_unlock (&m_mutexTimers);
+
+    return true;
+}
@@ -14,9 +14,9 @@
 #include "i2c.h"
 #include "bbb_gpio.h"
 #include "bbb_i2c.h"
-#include "avg_filter.h"
-#include "simple_avg_filter.h"
-#include "exp_avg_filter.h"
+#include "timer_thread.h"
+#include "filter_bank.h"
+#include "min_max_window.h"
 #include "screen.h"
 
 using namespace embed;
@@ -107,8 +107,12 @@ int main (int argc, char *argv[])
         return 1;
     }
 
+    // Timer thread lets the device recover from missed EOC interrupts
+    TimerThread timerThread;
+    timerThread.start();
+
     // Initialize BMP device, passing it the I2C bus and XCLR GPIO
-    BMP085  device(devBus, eocGPIO, xclrGPIO);
+    BMP085  device(devBus, eocGPIO, xclrGPIO, &timerThread);
     device.setOSSR(BMP085::OSSR_ULTRA_HIGH_RES);
 #ifdef BEAGLEBONEBLACK
     // For BBB, need to start thread because init kicks
@@ -145,48 +149,39 @@ int main (int argc, char *argv[])
     int32_t width, height;
     Screen::Instance()->size(width, height);
 
-    // Average filters
-    AvgFilter<double>* pressFilter = NULL;
-    AvgFilter<double>* absAltFilter = NULL;
-    AvgFilter<double>* relAltFilter = NULL;
-    AvgFilter<double>* sampleRateFilter = NULL;
+    // Average filters, one bank channel per displayed value
+    enum
+    {
+        PRESS_CHANNEL = 0,
+        ABS_ALT_CHANNEL,
+        REL_ALT_CHANNEL,
+        SAMPLE_RATE_CHANNEL,
+        NUM_FILTER_CHANNELS
+    };
+    FilterBank<double>* filterBank = NULL;
 
     // Filter parametes
-    const int32_t pressFilterSize = 18;
-    const int32_t absAltFilterSize = 18;
-    const int32_t relAltFilterSize = 18;
-    const int32_t sampleRateFilterSize = 18;
-    const int32_t pressFilterStdDevInterval = 18;
-    const int32_t absAltFilterStdDevInterval = 18;
-    const int32_t relAltFilterStdDevInterval = 18;
-    const int32_t sampleRateFilterStdDevInterval = 18;
-    const double pressFilterAlpha = 0.5;
-    const double absAltFilterAlpha = 0.5;
-    const double relAltFilterAlpha = 0.5;
-    const double sampleRateFilterAlpha = 0.5;
+    const int32_t filterSize = 18;
+    const int32_t filterStdDevInterval = 18;
+    const double filterAlpha = 0.5;
 
     // Filter type multiplexing
-    typedef enum FILTER_TYPES_ENUM
-    {
-        SIMPLE_AVG_FILTER = 0,
-        EXP_AVG_FILTER,
-        NUM_FILTER_TYPES
-    } FILTER_TYPES;
     std::map<int32_t, std::string> FILTER_STRING_MAP;
-    FILTER_STRING_MAP[SIMPLE_AVG_FILTER] = "Simple Average";
-    FILTER_STRING_MAP[EXP_AVG_FILTER] = "Exponential Average";
+    FILTER_STRING_MAP[FilterBank<double>::SIMPLE_AVG] = "Simple Average";
+    FILTER_STRING_MAP[FilterBank<double>::EXP_AVG] = "Exponential Average";
 
-    FILTER_TYPES currentFilterType = SIMPLE_AVG_FILTER;
+    FilterBank<double>::FILTER_TYPE currentFilterType = FilterBank<double>::SIMPLE_AVG;
 
-    // Average filter guards
-    bool usePressFilter = false;
-    bool useAbsAltFilter = false;
-    bool useRelAltFilter = false;
-    bool useSampleRateFilter = false;
+    // Average filter guard
+    bool useFilters = false;
 
     // Relative altitude variables
     double referenceAltitude = 0.0;
 
+    // Relative altitude excursion over the last samples, unfiltered
+    const int32_t rangeSize = 100;
+    MinMaxWindow<double> relAltRange(rangeSize);
+
     // Line content defintions
     typedef enum LINE_CONTENT_ENUM
     {
@@ -199,6 +194,7 @@ int main (int argc, char *argv[])
         PRESS_LINE,
         ABS_ALT_LINE,
         REL_ALT_LINE,
+        REL_ALT_RANGE_LINE,
         MEAS_RATE_LINE,
         BLANK1,
         CONTROLS_LINE,
@@ -220,6 +216,7 @@ int main (int argc, char *argv[])
     Screen::Instance()->printText(1, PRESS_LINE,     " Pressure                 : ");
     Screen::Instance()->printText(1, ABS_ALT_LINE,   " Approx. Abs. Altitude    : ");
     Screen::Instance()->printText(1, REL_ALT_LINE,   " Approx. Rel. Altitude    : ");
+    Screen::Instance()->printText(1, REL_ALT_RANGE_LINE, " Rel. Altitude Range      : ");
     Screen::Instance()->printText(1, MEAS_RATE_LINE, " Measurement Rate         : ");
     Screen::Instance()->printText(1, CONTROLS_LINE,
                    " f - Toggle Filter   t - Toggle Filter Type    r - Reset Reference Altitude    q - Quit");
@@ -248,12 +245,9 @@ int main (int argc, char *argv[])
         switch (c)
         {
             case 'f' :
-                if (usePressFilter && useAbsAltFilter && useRelAltFilter && useSampleRateFilter)
+                if (useFilters)
                 {
-                    usePressFilter      = false;
-                    useAbsAltFilter     = false;
-                    useRelAltFilter     = false;
-                    useSampleRateFilter = false;
+                    useFilters = false;
                     memset (buf, '\0', width);
                     sprintf(buf, "%8s", "Disabled");
                     Screen::Instance()->printText(FILTER_OFFSET, OPTIONS_LINE, buf);
@@ -268,47 +262,20 @@ int main (int argc, char *argv[])
                 else
                 {
                     // Initialize/reset filters
-                    if (pressFilter == NULL && absAltFilter == NULL &&
-                        relAltFilter == NULL && sampleRateFilter == NULL)
+                    if (filterBank == NULL)
                     {
-                        switch (currentFilterType)
-                        {
-                            case SIMPLE_AVG_FILTER :
-                                pressFilter = new SimpleAvgFilter<double>(pressFilterSize);
-                                absAltFilter = new SimpleAvgFilter<double>(absAltFilterSize);
-                                relAltFilter = new SimpleAvgFilter<double>(relAltFilterSize);
-                                sampleRateFilter = new SimpleAvgFilter<double>(sampleRateFilterSize);
-                                break;
-                            case EXP_AVG_FILTER :
-                                pressFilter = new ExpAvgFilter<double>(pressFilterAlpha,
-                                                                       pressFilterStdDevInterval);
-                                absAltFilter = new ExpAvgFilter<double>(absAltFilterAlpha,
-                                                                        absAltFilterStdDevInterval);
-                                relAltFilter = new ExpAvgFilter<double>(relAltFilterAlpha,
-                                                                        relAltFilterStdDevInterval);
-                                sampleRateFilter = new ExpAvgFilter<double>(sampleRateFilterAlpha,
-                                                                            sampleRateFilterStdDevInterval);
-                                break;
-                            default:
-                                devBus->destroy();
-                                Screen::Instance()->destroy();
-                                fprintf(stderr, "Error: Invalid filter type\n");
-                                return 1;
-                                break;
-                        }
+                        if (currentFilterType == FilterBank<double>::SIMPLE_AVG)
+                            filterBank = new FilterBank<double>(currentFilterType, NUM_FILTER_CHANNELS, filterSize);
+                        else
+                            filterBank = new FilterBank<double>(currentFilterType, NUM_FILTER_CHANNELS,
+                                                                filterStdDevInterval, filterAlpha);
                     }
                     else
                     {
-                        pressFilter->reset();
-                        absAltFilter->reset();
-                        relAltFilter->reset();
-                        sampleRateFilter->reset ();
+                        filterBank->reset();
                     }
 
-                    usePressFilter      = true;
-                    useAbsAltFilter     = true;
-                    useRelAltFilter     = true;
-                    useSampleRateFilter = true;
+                    useFilters = true;
                     memset (buf, '\0', width);
                     sprintf(buf, "%8s", "Enabled");
                     Screen::Instance()->printText(FILTER_OFFSET, OPTIONS_LINE, buf);
@@ -318,43 +285,20 @@ int main (int argc, char *argv[])
                 }
                 break;
             case 't' :
-                if (pressFilter != NULL)
-                    delete pressFilter;
-                if (absAltFilter != NULL)
-                    delete absAltFilter;
-                if (relAltFilter != NULL)
-                    delete relAltFilter;
-                if (sampleRateFilter != NULL)
-                    delete sampleRateFilter;
-
-                currentFilterType = (FILTER_TYPES) (((int32_t) currentFilterType) + 1);
-                if (currentFilterType >= NUM_FILTER_TYPES)
-                    currentFilterType = (FILTER_TYPES) 0;
-
-                switch (currentFilterType)
-                {
-                    case SIMPLE_AVG_FILTER :
-                        pressFilter = new SimpleAvgFilter<double>(pressFilterSize);
-                        absAltFilter = new SimpleAvgFilter<double>(absAltFilterSize);
-                        relAltFilter = new SimpleAvgFilter<double>(relAltFilterSize);
-                        sampleRateFilter = new SimpleAvgFilter<double>(sampleRateFilterSize);
-                        break;
-                    case EXP_AVG_FILTER :
-                        pressFilter = new ExpAvgFilter<double>(pressFilterAlpha, pressFilterStdDevInterval);
-                        absAltFilter = new ExpAvgFilter<double>(absAltFilterAlpha, absAltFilterStdDevInterval);
-                        relAltFilter = new ExpAvgFilter<double>(relAltFilterAlpha, relAltFilterStdDevInterval);
-                        sampleRateFilter = new ExpAvgFilter<double>(sampleRateFilterAlpha,
-                                                                    sampleRateFilterStdDevInterval);
-                        break;
-                    default:
-                        devBus->destroy();
-                        Screen::Instance()->destroy();
-                        fprintf(stderr, "Error: Invalid filter type\n");
-                        return 1;
-                        break;
-                }
+                if (filterBank != NULL)
+                    delete filterBank;
+
+                currentFilterType = (FilterBank<double>::FILTER_TYPE) (((int32_t) currentFilterType) + 1);
+                if (currentFilterType >= FilterBank<double>::FILTER_TYPE_NUM)
+                    currentFilterType = (FilterBank<double>::FILTER_TYPE) 0;
 
-                if (usePressFilter && useAbsAltFilter && useRelAltFilter && useSampleRateFilter)
+                if (currentFilterType == FilterBank<double>::SIMPLE_AVG)
+                    filterBank = new FilterBank<double>(currentFilterType, NUM_FILTER_CHANNELS, filterSize);
+                else
+                    filterBank = new FilterBank<double>(currentFilterType, NUM_FILTER_CHANNELS,
+                                                        filterStdDevInterval, filterAlpha);
+
+                if (useFilters)
                 {
                     memset (buf, '\0', width);
                     sprintf(buf, "%20s", FILTER_STRING_MAP[currentFilterType].c_str());
@@ -363,8 +307,9 @@ int main (int argc, char *argv[])
                 break;
             case 'r' :
                 updateRefAlt = true;
-                if (useRelAltFilter)
-                    relAltFilter->reset();
+                relAltRange.reset();
+                if (useFilters)
+                    filterBank->resetChannel(REL_ALT_CHANNEL);
                 break;
             default :
                 break;
@@ -386,41 +331,16 @@ int main (int argc, char *argv[])
 
         //  Calculate sample rate
         double sample_rate_hz_unfiltered = 1.0 / (sample_period_us / 1000000.0);
-        double sample_rate_hz_filtered, sample_rate_hz_filtered_std_dev;
-
-        // Filter sample rate
-        if (useSampleRateFilter)
-        {
-            sampleRateFilter->addValue (sample_rate_hz_unfiltered);
-            sample_rate_hz_filtered = sampleRateFilter->getAvg();
-            sample_rate_hz_filtered_std_dev = sampleRateFilter->getStdDev();
-        }
 
         // Calculate the temperature and pressure
         double tempC;
-        double pressurehPaUnfiltered, pressurehPaFiltered, pressurehPaFilteredStdDev;
-        double absAltMUnfiltered, absAltMFiltered, absAltMFilteredStdDev;
+        double pressurehPaUnfiltered;
+        double absAltMUnfiltered;
         device.calcTempPressure(raw_temp, raw_pressure, &tempC, &pressurehPaUnfiltered);
 
-        // Filter pressure
-        if (usePressFilter)
-        {
-            pressFilter->addValue (pressurehPaUnfiltered);
-            pressurehPaFiltered = pressFilter->getAvg();
-            pressurehPaFilteredStdDev = pressFilter->getStdDev();
-        }
-
         // Calculate approximate absolute altitude (uses average pressure at sea level)
         device.calcApproxAlt(pressurehPaUnfiltered, &absAltMUnfiltered);
 
-        // Filter absolute altitude
-        if (useAbsAltFilter)
-        {
-            absAltFilter->addValue (absAltMUnfiltered);
-            absAltMFiltered = absAltFilter->getAvg();
-            absAltMFilteredStdDev = absAltFilter->getStdDev();
-        }
-
         // Set the reference altitude if this is the first measurement
         if (firstMeas)
         {
@@ -428,24 +348,38 @@ int main (int argc, char *argv[])
             firstMeas = false;
         }
 
+        // The filtered reference is the absolute altitude average before
+        // this sample, since all channels are filtered together below
         if (updateRefAlt)
         {
-            if (useAbsAltFilter)
-                referenceAltitude = absAltMFiltered;
+            double absAltMAvg = useFilters ? filterBank->getAvg(ABS_ALT_CHANNEL) : nan("");
+            if (!isnan(absAltMAvg))
+                referenceAltitude = absAltMAvg;
             else
                 referenceAltitude = absAltMUnfiltered;
         }
 
         // Calculate altitude relative to reference altitude
         double relAltMUnfiltered = absAltMUnfiltered - referenceAltitude;
-        double relAltMFiltered, relAltMFilteredStdDev;
+        relAltRange.addValue(relAltMUnfiltered);
 
-        // Filter relative altitude
-        if (useRelAltFilter)
+        // Filter all values in one pass
+        double filtered[NUM_FILTER_CHANNELS];
+        double filteredStdDev[NUM_FILTER_CHANNELS];
+        if (useFilters)
         {
-            relAltFilter->addValue(relAltMUnfiltered);
-            relAltMFiltered = relAltFilter->getAvg();
-            relAltMFilteredStdDev = relAltFilter->getStdDev();
+            double unfiltered[NUM_FILTER_CHANNELS];
+            unfiltered[PRESS_CHANNEL] = pressurehPaUnfiltered;
+            unfiltered[ABS_ALT_CHANNEL] = absAltMUnfiltered;
+            unfiltered[REL_ALT_CHANNEL] = relAltMUnfiltered;
+            unfiltered[SAMPLE_RATE_CHANNEL] = sample_rate_hz_unfiltered;
+            filterBank->addValues(unfiltered);
+
+            for (int32_t i = 0; i < NUM_FILTER_CHANNELS; i++)
+            {
+                filtered[i] = filterBank->getAvg(i);
+                filteredStdDev[i] = filterBank->getStdDev(i);
+            }
         }
 
         // Print new values to screen
@@ -454,29 +388,34 @@ int main (int argc, char *argv[])
         Screen::Instance()->printText(VALUE_OFFSET, TEMP_LINE, buf);
 
         memset(buf, '\0', width);
-        if (usePressFilter)
-            sprintf (buf, "%9.3fhPa    +/- %6.3fhPa", pressurehPaFiltered, pressurehPaFilteredStdDev);
+        if (useFilters)
+            sprintf (buf, "%9.3fhPa    +/- %6.3fhPa", filtered[PRESS_CHANNEL], filteredStdDev[PRESS_CHANNEL]);
         else
             sprintf (buf, "%9.3fhPa", pressurehPaUnfiltered);
         Screen::Instance()->printText(VALUE_OFFSET, PRESS_LINE, buf);
 
         memset(buf, '\0', width);
-        if (useAbsAltFilter)
-            sprintf (buf, "%9.3fm      +/- %6.3fm", absAltMFiltered, absAltMFilteredStdDev);
+        if (useFilters)
+            sprintf (buf, "%9.3fm      +/- %6.3fm", filtered[ABS_ALT_CHANNEL], filteredStdDev[ABS_ALT_CHANNEL]);
         else
             sprintf (buf, "%9.3fm", absAltMUnfiltered);
         Screen::Instance()->printText(VALUE_OFFSET, ABS_ALT_LINE, buf);
 
         memset(buf, '\0', width);
-        if (useRelAltFilter)
-            sprintf (buf, "%9.3fm      +/- %6.3fm", relAltMFiltered, relAltMFilteredStdDev);
+        if (useFilters)
+            sprintf (buf, "%9.3fm      +/- %6.3fm", filtered[REL_ALT_CHANNEL], filteredStdDev[REL_ALT_CHANNEL]);
         else
             sprintf (buf, "%9.3fm", relAltMUnfiltered);
         Screen::Instance()->printText(VALUE_OFFSET, REL_ALT_LINE, buf);
 
         memset(buf, '\0', width);
-        if (useSampleRateFilter)
-            sprintf (buf, "%9.2fHz     +/- %6.3fHz", sample_rate_hz_filtered, sample_rate_hz_filtered_std_dev);
+        sprintf (buf, "%9.3fm to %6.3fm", relAltRange.getMin(), relAltRange.getMax());
+        Screen::Instance()->printText(VALUE_OFFSET, REL_ALT_RANGE_LINE, buf);
+
+        memset(buf, '\0', width);
+        if (useFilters)
+            sprintf (buf, "%9.2fHz     +/- %6.3fHz", filtered[SAMPLE_RATE_CHANNEL],
+                     filteredStdDev[SAMPLE_RATE_CHANNEL]);
         else
             sprintf (buf, "%9.2fHz", sample_rate_hz_unfiltered);
         Screen::Instance()->printText(VALUE_OFFSET, MEAS_RATE_LINE, buf);
@@ -488,16 +427,11 @@ int main (int argc, char *argv[])
     device.unregisterListener (eocIntHandler);
     pthread_mutex_destroy (&eocData.m_dataMutex);
 
-    if (pressFilter != NULL)
-        delete pressFilter;
-    if (absAltFilter != NULL)
-        delete absAltFilter;
-    if (relAltFilter != NULL)
-        delete relAltFilter;
-    if (sampleRateFilter != NULL)
-        delete sampleRateFilter;
+    if (filterBank != NULL)
+        delete filterBank;
 
     device.destroy();
+    timerThread.end();
     #ifdef BEAGLEBONEBLACK
         intThread.end();
     #endif
@@ -0,0 +1,202 @@
+/*
+ * Filename: bmp085_ossr_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that runs the adaptive oversampling
+ *              controller on the simulated BMP085 on virtual time, raising
+ *              and lowering the pressure noise of the model and checking
+ *              the settings it switches to, that it holds the minimum
+ *              sample rate when the target noise cannot be met, and that
+ *              it does not flap while the noise is steady.
+ */
+
+
+#include "bmp085.h"
+#include "bmp085_ossr_controller.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "virtual_clock.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const double TARGET_NOISE_HPA = 0.05;
+static const double MIN_RATE_HZ = 50.0;
+static const double LOWER_MIN_RATE_HZ = 20.0;
+static const uint64_t PHASE_US = 5000000;
+
+// Uniform raw pressure noise of +-5 counts is a std dev of ~0.09hPa, too
+// much for the target at any setting allowed at 50Hz
+static const int32_t LOUD_NOISE_COUNTS = 5;
+
+static const uint32_t MAX_SWITCHES = 8;
+
+struct NoiseData
+{
+    SimBMP085*              m_model;
+    int32_t                 m_noiseCounts;
+    uint32_t                m_seed;
+    uint32_t                m_numSamples;
+};
+
+struct SwitchData
+{
+    uint32_t                m_numSwitches;
+    BMP085::OSSR_SETTING    m_from[MAX_SWITCHES];
+    BMP085::OSSR_SETTING    m_to[MAX_SWITCHES];
+    double                  m_noisehPa[MAX_SWITCHES];
+};
+
+void noiseHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+void switchHandler (const BMP085::OSSR_SETTING _from, const BMP085::OSSR_SETTING _to,
+                    const double _noisehPa, void* _data);
+uint32_t runPhase (VirtualClock* _clock, struct NoiseData* _noise, int32_t _noiseCounts);
+bool checkSwitch (const struct SwitchData& _switches, uint32_t _index,
+                  BMP085::OSSR_SETTING _from, BMP085::OSSR_SETTING _to);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    VirtualClock virtualClock;
+    SimGPIO eocGPIO;
+    eocGPIO.init();
+    eocGPIO.setMode(GPIO::INPUT);
+    SimI2C devBus;
+    SimBMP085 model(&virtualClock, &eocGPIO);
+    devBus.init();
+    devBus.attachDevice(SimBMP085::ADDRESS, &model);
+
+    BMP085 device(&devBus, &eocGPIO, NULL, &virtualClock, &virtualClock);
+    device.setOSSR(BMP085::OSSR_LOW_POWER);
+    if (!device.init(true))
+    {
+        fprintf(stderr, "Error: Initializing BMP085 device\n");
+        return 1;
+    }
+
+    // The model's next conversion gets new noise after every sample
+    struct NoiseData noise;
+    noise.m_model = &model;
+    noise.m_noiseCounts = 0;
+    noise.m_seed = 1;
+    noise.m_numSamples = 0;
+    device.registerListener(noiseHandler, &noise);
+
+    struct SwitchData switches;
+    switches.m_numSwitches = 0;
+    BMP085OSSRController controller(&device, TARGET_NOISE_HPA, MIN_RATE_HZ);
+    controller.setSwitchHandler(switchHandler, &switches);
+    if (!controller.init())
+    {
+        fprintf(stderr, "Error: Initializing OSSR controller\n");
+        return 1;
+    }
+
+    // Quiet at the lowest setting already
+    uint32_t numSamples = runPhase(&virtualClock, &noise, 0);
+    printf("Quiet: %u samples, noise %.3fhPa, OSSR %d, %u switches\n", numSamples,
+           controller.getNoise(), device.getOSSR(), controller.getNumSwitches());
+    passed &= check("quiet switches", controller.getNumSwitches(), 0, 0);
+    passed &= check("quiet noise", controller.getNoise(), 0.0, 0.001);
+
+    // Too loud for the target even at the slowest setting allowed, so it
+    // settles there rather than dropping below the minimum rate
+    numSamples = runPhase(&virtualClock, &noise, LOUD_NOISE_COUNTS);
+    double rateHz = numSamples * 1e6 / PHASE_US;
+    printf("Loud: %u samples (%.1fHz), noise %.3fhPa, OSSR %d, %u switches\n", numSamples, rateHz,
+           controller.getNoise(), device.getOSSR(), controller.getNumSwitches());
+    passed &= check("loud switches", controller.getNumSwitches(), 1, 0);
+    passed &= checkSwitch(switches, 0, BMP085::OSSR_LOW_POWER, BMP085::OSSR_HIGH_RES);
+    passed &= check("loud noise over target", controller.getNoise() > TARGET_NOISE_HPA ? 1 : 0, 1, 0);
+    passed &= check("minimum rate", BMP085OSSRController::getMaxRate(device.getOSSR()) >= MIN_RATE_HZ ? 1 : 0, 1, 0);
+
+    // Held at the minimum rate once settled
+    numSamples = runPhase(&virtualClock, &noise, LOUD_NOISE_COUNTS);
+    rateHz = numSamples * 1e6 / PHASE_US;
+    printf("Loud settled: %u samples (%.1fHz), OSSR %d, %u switches\n", numSamples, rateHz,
+           device.getOSSR(), controller.getNumSwitches());
+    passed &= check("settled switches", controller.getNumSwitches(), 1, 0);
+    passed &= check("settled rate", rateHz >= MIN_RATE_HZ ? 1 : 0, 1, 0);
+
+    // A lower minimum rate frees the slowest setting
+    controller.setMinRate(LOWER_MIN_RATE_HZ);
+    numSamples = runPhase(&virtualClock, &noise, LOUD_NOISE_COUNTS);
+    printf("Lower minimum rate: %u samples, OSSR %d, %u switches\n", numSamples, device.getOSSR(),
+           controller.getNumSwitches());
+    passed &= check("lower rate switches", controller.getNumSwitches(), 2, 0);
+    passed &= checkSwitch(switches, 1, BMP085::OSSR_HIGH_RES, BMP085::OSSR_ULTRA_HIGH_RES);
+
+    // Quiet again, straight back down
+    numSamples = runPhase(&virtualClock, &noise, 0);
+    printf("Quiet again: %u samples, noise %.3fhPa, OSSR %d, %u switches\n", numSamples,
+           controller.getNoise(), device.getOSSR(), controller.getNumSwitches());
+    passed &= check("quiet again switches", controller.getNumSwitches(), 3, 0);
+    passed &= checkSwitch(switches, 2, BMP085::OSSR_ULTRA_HIGH_RES, BMP085::OSSR_LOW_POWER);
+
+    for (uint32_t i = 0; i < switches.m_numSwitches && i < MAX_SWITCHES; i++)
+        printf("Switch %u: OSSR %d to %d at %.3fhPa\n", i, switches.m_from[i], switches.m_to[i],
+               switches.m_noisehPa[i]);
+
+    controller.destroy();
+    device.unregisterListener(noiseHandler);
+    device.destroy();
+    devBus.destroy();
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void noiseHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    struct NoiseData* _noiseData = static_cast<struct NoiseData*>(_data);
+
+    _noiseData->m_numSamples++;
+
+    int32_t offset = 0;
+    if (_noiseData->m_noiseCounts > 0)
+    {
+        // Repeatable pseudo-random noise
+        _noiseData->m_seed = _noiseData->m_seed * 1103515245 + 12345;
+        offset = (int32_t) ((_noiseData->m_seed >> 16) % (2 * _noiseData->m_noiseCounts + 1)) -
+                 _noiseData->m_noiseCounts;
+    }
+
+    _noiseData->m_model->setRawValues(SimBMP085::EXAMPLE_RAW_TEMP, SimBMP085::EXAMPLE_RAW_PRESSURE + offset);
+}
+
+void switchHandler (const BMP085::OSSR_SETTING _from, const BMP085::OSSR_SETTING _to,
+                    const double _noisehPa, void* _data)
+{
+    struct SwitchData* _switchData = static_cast<struct SwitchData*>(_data);
+
+    if (_switchData->m_numSwitches < MAX_SWITCHES)
+    {
+        _switchData->m_from[_switchData->m_numSwitches] = _from;
+        _switchData->m_to[_switchData->m_numSwitches] = _to;
+        _switchData->m_noisehPa[_switchData->m_numSwitches] = _noisehPa;
+    }
+    _switchData->m_numSwitches++;
+}
+
+// Runs the simulation for a phase, returning the number of samples
+uint32_t runPhase (VirtualClock* _clock, struct NoiseData* _noise, int32_t _noiseCounts)
+{
+    _noise->m_noiseCounts = _noiseCounts;
+    uint32_t start = _noise->m_numSamples;
+    _clock->sleepUs(PHASE_US);
+
+    return _noise->m_numSamples - start;
+}
+
+bool checkSwitch (const struct SwitchData& _switches, uint32_t _index,
+                  BMP085::OSSR_SETTING _from, BMP085::OSSR_SETTING _to)
+{
+    if (_index < _switches.m_numSwitches && _switches.m_from[_index] == _from && _switches.m_to[_index] == _to)
+        return true;
+
+    fprintf(stderr, "Error: switch %u is not OSSR %d to %d\n", _index, _from, _to);
+    return false;
+}
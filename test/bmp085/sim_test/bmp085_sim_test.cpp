@@ -0,0 +1,321 @@
+/*
+ * Filename: bmp085_sim_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that runs the BMP085 driver against the
+ *              register-level model on a simulated I2C bus and GPIOs,
+ *              checking the datasheet compensation example in every
+ *              synchronous wait mode and the asynchronous EOC interrupt
+ *              path, and that EOC waits last as long as the conversions,
+ *              then repeats them on virtual time, where a missed EOC edge
+ *              is recovered by the stall timer and a listener unregisters
+ *              itself while being called.
+ */
+
+
+#include "bmp085.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "timer_thread.h"
+#include "virtual_clock.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+// Datasheet compensation example
+static const double EXAMPLE_TEMP_C = 15.0;
+static const double EXAMPLE_PRESSURE_HPA = 699.64;
+
+// Fraction of the model's conversion time an EOC wait must last
+static const double CONVERSION_TIME_SLACK = 0.9;
+
+// Device the one shot listener unregisters from
+static BMP085* s_oneShotDevice = NULL;
+
+static const char* SYNC_WAIT_NAMES[BMP085::SYNC_WAIT_NUM] = {"sleep", "poll", "interrupt"};
+
+struct SampleData
+{
+    pthread_mutex_t     m_dataMutex;
+    uint32_t            m_numSamples;
+    int16_t             m_temp;
+    int32_t             m_pressure;
+};
+
+void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+void oneShotHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    // Percentiles use the nearest rank, 60% of four samples is the third
+    LatencyHistogram histogram;
+    for (uint32_t us = 1; us <= 4; us++)
+        histogram.addValue(us);
+    passed &= check("histogram p50", histogram.getPercentile(50.0), 2, 0);
+    passed &= check("histogram p60", histogram.getPercentile(60.0), 3, 0);
+    passed &= check("histogram p100", histogram.getPercentile(100.0), 4, 0);
+
+    // Conversions finish on the timer thread, raising EOC
+    TimerThread timerThread;
+    timerThread.start();
+
+    SimGPIO eocGPIO;
+    SimGPIO xclrGPIO;
+    eocGPIO.init();
+    eocGPIO.setMode(GPIO::INPUT);
+    xclrGPIO.init();
+    xclrGPIO.setMode(GPIO::OUTPUT);
+
+    // Sleeping cannot tell a late conversion, so that mode uses a model
+    // whose conversions finish as they start
+    SimI2C      devBus;
+    SimBMP085   model(&timerThread, &eocGPIO, &xclrGPIO);
+    SimBMP085   immediateModel(NULL, NULL, &xclrGPIO);
+    if (!devBus.init())
+    {
+        fprintf(stderr, "Error: Initializing simulated I2C bus\n");
+        timerThread.end();
+        return 1;
+    }
+
+    // Synchronous reads in every wait mode, checking conversion times
+    for (int32_t wait = 0; wait < BMP085::SYNC_WAIT_NUM; wait++)
+    {
+        devBus.attachDevice(SimBMP085::ADDRESS, wait == BMP085::SYNC_WAIT_SLEEP ? &immediateModel : &model);
+
+        BMP085 device(&devBus, &eocGPIO, &xclrGPIO);
+        device.setSyncWaitMode((BMP085::SYNC_WAIT) wait);
+        device.setTimingEnabled(true);
+        if (!device.init(false))
+        {
+            fprintf(stderr, "Error: Initializing BMP085 device\n");
+            passed = false;
+            continue;
+        }
+
+        // A host that runs the model's timer later than the datasheet
+        // maximum makes the driver time out and read a stale conversion,
+        // as the real device would, so those reads are only counted
+        uint32_t numLate = 0;
+        for (int32_t ossr = 0; ossr < BMP085::OSSR_NUM; ossr++)
+        {
+            device.setOSSR((BMP085::OSSR_SETTING) ossr);
+            uint32_t timeouts = device.getSyncTimeouts();
+            int16_t rawTemp = device.readRawTempSync();
+            int32_t rawPressure = device.readRawPressureSync();
+
+            double tempC, pressurehPa;
+            device.calcTempPressure(rawTemp, rawPressure, &tempC, &pressurehPa);
+            printf("Sync %-9s OSSR %d: raw temp %d, raw pressure %d, %.1fC %.2fhPa\n",
+                   SYNC_WAIT_NAMES[wait], ossr, rawTemp, rawPressure, tempC, pressurehPa);
+            if (device.getSyncTimeouts() != timeouts)
+            {
+                printf("Sync %-9s OSSR %d: conversion finished late on the host, not checked\n",
+                       SYNC_WAIT_NAMES[wait], ossr);
+                numLate++;
+                continue;
+            }
+
+            passed &= check("temperature", tempC, EXAMPLE_TEMP_C, 0.001);
+            // The integer compensation truncates 50000 >> OSSR, which costs
+            // a couple of Pa with oversampling
+            passed &= check("pressure", pressurehPa, EXAMPLE_PRESSURE_HPA, ossr == 0 ? 0.001 : 0.03);
+            passed &= check("raw pressure resolution", rawPressure,
+                            SimBMP085::EXAMPLE_RAW_PRESSURE << ossr, 0);
+        }
+
+        passed &= check("late conversions", numLate < BMP085::OSSR_NUM ? 1 : 0, 1, 0);
+
+        // Waiting on EOC must last as long as the model's conversion. The
+        // driver starts its clock after the control write returns, so allow
+        // for it being preempted in between.
+        if (wait != BMP085::SYNC_WAIT_SLEEP)
+        {
+            LatencyHistogram::Summary summary;
+            device.getTimingStats(BMP085::TIMING_TEMP_CONVERSION, &summary);
+            printf("Sync %-9s temperature conversion: median %.2fms\n", SYNC_WAIT_NAMES[wait],
+                   summary.m_p50Us / 1000.0);
+            passed &= check("temperature conversion time",
+                            summary.m_p50Us >= CONVERSION_TIME_SLACK * SimBMP085::getConversionTimeUs(0x2E) ||
+                            numLate > 0 ? 1 : 0, 1, 0);
+
+            for (int32_t ossr = 0; ossr < BMP085::OSSR_NUM; ossr++)
+            {
+                device.getTimingStats(BMP085::TIMING_PRESSURE_CONVERSION, &summary,
+                                      (BMP085::OSSR_SETTING) ossr);
+                printf("Sync %-9s OSSR %d pressure conversion: median %.2fms (datasheet max %.1fms)\n",
+                       SYNC_WAIT_NAMES[wait], ossr, summary.m_p50Us / 1000.0,
+                       BMP085::getConversionTime((BMP085::OSSR_SETTING) ossr));
+                // Late conversions are not recorded, so the setting may have
+                // no samples
+                passed &= check("pressure conversion time",
+                                summary.m_p50Us >= CONVERSION_TIME_SLACK *
+                                SimBMP085::getConversionTimeUs(0x34 | (ossr << 6)) ||
+                                numLate > 0 ? 1 : 0, 1, 0);
+            }
+        }
+
+        device.destroy();
+    }
+
+    // Asynchronous reads driven by EOC interrupts
+    devBus.attachDevice(SimBMP085::ADDRESS, &model);
+    BMP085 device(&devBus, &eocGPIO, &xclrGPIO, &timerThread);
+    device.setOSSR(BMP085::OSSR_HIGH_RES);
+    if (!device.init(true))
+    {
+        fprintf(stderr, "Error: Initializing BMP085 device\n");
+        timerThread.end();
+        return 1;
+    }
+
+    struct SampleData sampleData;
+    pthread_mutex_init(&sampleData.m_dataMutex, NULL);
+    sampleData.m_numSamples = 0;
+    device.registerListener(sampleHandler, &sampleData);
+
+    usleep(250000);
+
+    device.unregisterListener(sampleHandler);
+    uint32_t stalls = device.getStallsRecovered();
+    device.destroy();
+
+    pthread_mutex_lock(&sampleData.m_dataMutex);
+    uint32_t numSamples = sampleData.m_numSamples;
+    double tempC, pressurehPa;
+    device.calcTempPressure(sampleData.m_temp, sampleData.m_pressure, BMP085::OSSR_HIGH_RES,
+                            &tempC, &pressurehPa);
+    pthread_mutex_unlock(&sampleData.m_dataMutex);
+
+    // Each sample takes a temperature and an OSSR_HIGH_RES conversion
+    uint32_t maxSamples = 250000 / (SimBMP085::getConversionTimeUs(0x2E) + SimBMP085::getConversionTimeUs(0xB4));
+    printf("Async: %u samples in 250ms (at most %u), %u stalls, %u EOC interrupts, last %.1fC %.2fhPa\n",
+           numSamples, maxSamples, stalls, eocGPIO.getNumInterrupts(), tempC, pressurehPa);
+    passed &= check("async samples", numSamples > 0 ? 1 : 0, 1, 0);
+    passed &= check("async sample rate", numSamples <= maxSamples ? 1 : 0, 1, 0);
+    passed &= check("async temperature", tempC, EXAMPLE_TEMP_C, 0.001);
+    passed &= check("async pressure", pressurehPa, EXAMPLE_PRESSURE_HPA, 0.03);
+
+    // The model must not answer while held in reset
+    xclrGPIO.digitalWrite(0);
+    passed &= check("chip id in reset", devBus.readReg(SimBMP085::ADDRESS, 0xD0), 0, 0);
+    xclrGPIO.digitalWrite(1);
+    passed &= check("chip id", devBus.readReg(SimBMP085::ADDRESS, 0xD0), 0x55, 0);
+
+    timerThread.end();
+
+    // The same driver on virtual time, where waits jump to the model's
+    // conversion deadlines, so timing is exact and an hour of async
+    // sampling runs in a moment
+    VirtualClock    virtualClock;
+    SimBMP085       virtualModel(&virtualClock, &eocGPIO, &xclrGPIO);
+    devBus.attachDevice(SimBMP085::ADDRESS, &virtualModel);
+
+    BMP085 virtualSyncDevice(&devBus, &eocGPIO, &xclrGPIO, NULL, &virtualClock);
+    virtualSyncDevice.setSyncWaitMode(BMP085::SYNC_WAIT_INTERRUPT);
+    virtualSyncDevice.setTimingEnabled(true);
+    virtualSyncDevice.setOSSR(BMP085::OSSR_ULTRA_HIGH_RES);
+    if (!virtualSyncDevice.init(false))
+    {
+        fprintf(stderr, "Error: Initializing BMP085 device\n");
+        return 1;
+    }
+
+    uint64_t startUs = virtualClock.nowUs();
+    int16_t rawTemp = virtualSyncDevice.readRawTempSync();
+    int32_t rawPressure = virtualSyncDevice.readRawPressureSync();
+    uint64_t elapsedUs = virtualClock.nowUs() - startUs;
+    virtualSyncDevice.calcTempPressure(rawTemp, rawPressure, &tempC, &pressurehPa);
+    virtualSyncDevice.destroy();
+
+    printf("Virtual sync: %.1fC %.2fhPa in %.2fms virtual\n", tempC, pressurehPa, elapsedUs / 1000.0);
+    passed &= check("virtual temperature", tempC, EXAMPLE_TEMP_C, 0.001);
+    passed &= check("virtual pressure", pressurehPa, EXAMPLE_PRESSURE_HPA, 0.03);
+    passed &= check("virtual sync timeouts", virtualSyncDevice.getSyncTimeouts(), 0, 0);
+    passed &= check("virtual sync time", elapsedUs,
+                    SimBMP085::getConversionTimeUs(0x2E) + SimBMP085::getConversionTimeUs(0xF4), 0);
+
+    BMP085 virtualDevice(&devBus, &eocGPIO, &xclrGPIO, &virtualClock, &virtualClock);
+    virtualDevice.setOSSR(BMP085::OSSR_HIGH_RES);
+    if (!virtualDevice.init(true))
+    {
+        fprintf(stderr, "Error: Initializing BMP085 device\n");
+        return 1;
+    }
+
+    sampleData.m_numSamples = 0;
+    virtualDevice.registerListener(sampleHandler, &sampleData);
+
+    const uint64_t SOAK_US = 3600ULL * 1000000ULL;
+    struct timespec wallStart, wallEnd;
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+    virtualClock.sleepUs(SOAK_US);
+    clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+
+    stalls = virtualDevice.getStallsRecovered();
+
+    double wallS = (wallEnd.tv_sec - wallStart.tv_sec) + (wallEnd.tv_nsec - wallStart.tv_nsec) / 1e9;
+    uint32_t expectedSamples = SOAK_US / (SimBMP085::getConversionTimeUs(0x2E) +
+                                          SimBMP085::getConversionTimeUs(0xB4));
+    printf("Virtual async: %u samples in 1h virtual (%.2fs wall, %.0fx real time), %u stalls\n",
+           sampleData.m_numSamples, wallS, SOAK_US / 1e6 / wallS, stalls);
+    passed &= check("virtual async samples", sampleData.m_numSamples, expectedSamples, 1);
+    passed &= check("virtual async stalls", stalls, 0, 0);
+
+    // A lost edge costs the stall timeout once, then the cycle carries on
+    // at rate
+    const uint64_t STALL_RUN_US = 1000000;
+    uint32_t samplesBefore = sampleData.m_numSamples;
+    virtualModel.dropEOCEdges(1);
+    virtualClock.sleepUs(STALL_RUN_US);
+    uint32_t stallSamples = sampleData.m_numSamples - samplesBefore;
+    uint32_t stallExpected = STALL_RUN_US / (SimBMP085::getConversionTimeUs(0x2E) +
+                                             SimBMP085::getConversionTimeUs(0xB4));
+    printf("Virtual async with a lost EOC edge: %u samples in 1s virtual, %u stalls\n",
+           stallSamples, virtualDevice.getStallsRecovered());
+    passed &= check("lost edge stalls", virtualDevice.getStallsRecovered(), 1, 0);
+    passed &= check("lost edge samples", stallSamples, stallExpected, 2);
+
+    // A listener removing itself mid dispatch is called exactly once
+    uint32_t oneShotCalls = 0;
+    s_oneShotDevice = &virtualDevice;
+    virtualDevice.registerListener(oneShotHandler, &oneShotCalls);
+    samplesBefore = sampleData.m_numSamples;
+    virtualClock.sleepUs(STALL_RUN_US);
+    passed &= check("one shot calls", oneShotCalls, 1, 0);
+    passed &= check("samples after one shot", sampleData.m_numSamples - samplesBefore, stallExpected, 1);
+
+    virtualDevice.unregisterListener(sampleHandler);
+    virtualDevice.destroy();
+
+    devBus.destroy();
+
+    pthread_mutex_destroy(&sampleData.m_dataMutex);
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    struct SampleData* _sampleData = static_cast<struct SampleData*>(_data);
+
+    // Atomic update
+    pthread_mutex_lock (&_sampleData->m_dataMutex);
+
+    _sampleData->m_numSamples++;
+    _sampleData->m_temp = _temp;
+    _sampleData->m_pressure = _pressure;
+
+    pthread_mutex_unlock (&_sampleData->m_dataMutex);
+}
+
+void oneShotHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    (*static_cast<uint32_t*>(_data))++;
+    s_oneShotDevice->unregisterListener(oneShotHandler);
+}
@@ -0,0 +1,168 @@
+/*
+ * Filename: bmp280_sim_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that runs the BMP280 and BME280 drivers
+ *              against the register-level model on a simulated I2C bus,
+ *              checking the compensation against the datasheet example and
+ *              a listener unregistering itself from its callback, and
+ *              printing the normal mode sample rate and bus usage.
+ */
+
+#include <sys/time.h>
+
+#include "bmp280.h"
+#include "bme280.h"
+#include "sim_i2c.h"
+#include "sim_bmp280.h"
+#include "timer_thread.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+// The device a one shot listener unregisters itself from
+static BMP280* s_oneShotDevice = NULL;
+
+struct SampleData
+{
+    pthread_mutex_t     m_dataMutex;
+    uint32_t            m_numSamples;
+    int32_t             m_temp;
+    int32_t             m_pressure;
+    int32_t             m_humidity;
+};
+
+void sampleHandler (const int32_t _temp, const int32_t _pressure, const int32_t _humidity, void* _data);
+void oneShotHandler (const int32_t _temp, const int32_t _pressure, const int32_t _humidity, void* _data);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    // Initialize the simulated bus with a BMP280 and a BME280 model
+    SimI2C      devBus;
+    SimBMP280   bmp280Model(false);
+    SimBMP280   bme280Model(true);
+    devBus.attachDevice(BMP280::ADDRESS_PRIMARY, &bmp280Model);
+    devBus.attachDevice(BMP280::ADDRESS_SECONDARY, &bme280Model);
+    if (!devBus.init())
+    {
+        fprintf(stderr, "Error: Initializing simulated I2C bus\n");
+        return 1;
+    }
+
+    // Forced mode read and datasheet compensation example
+    BMP280  device(&devBus, BMP280::ADDRESS_PRIMARY);
+    if (!device.init(false))
+    {
+        fprintf(stderr, "Error: Initializing BMP280 device\n");
+        return 1;
+    }
+
+    int32_t rawTemp, rawPressure;
+    devBus.resetNumTransactions();
+    if (!device.readRawSync(&rawTemp, &rawPressure))
+    {
+        fprintf(stderr, "Error: BMP280 forced mode read returned no measurement\n");
+        return 1;
+    }
+    printf("BMP280 forced read: raw temp %d, raw pressure %d, %u bus transactions\n",
+           rawTemp, rawPressure, devBus.getNumTransactions());
+    passed &= check("raw temperature", rawTemp, SimBMP280::EXAMPLE_RAW_TEMP, 0);
+    passed &= check("raw pressure", rawPressure, SimBMP280::EXAMPLE_RAW_PRESSURE, 0);
+
+    double tempC, pressurehPa;
+    device.calcTempPressure(rawTemp, rawPressure, &tempC, &pressurehPa);
+    printf("BMP280 64-bit compensation: %.2fC %.4fhPa\n", tempC, pressurehPa);
+    passed &= check("temperature", tempC, 25.08, 0.001);
+    // Datasheet example is 100653.27Pa from the floating point formula
+    passed &= check("64-bit pressure", pressurehPa, 1006.5327, 0.001);
+
+    device.calcTempPressure32(rawTemp, rawPressure, &tempC, &pressurehPa);
+    printf("BMP280 32-bit compensation: %.2fC %.2fhPa\n", tempC, pressurehPa);
+    // The 32-bit formula trades a few Pa of accuracy for speed
+    passed &= check("32-bit pressure", pressurehPa, 1006.5327, 0.05);
+
+    device.destroy();
+
+    // Normal mode sampling with burst reads on the BME280
+    TimerThread timerThread;
+    timerThread.start();
+
+    BME280  humDevice(&devBus, BMP280::ADDRESS_SECONDARY, &timerThread);
+    humDevice.setPressureOversampling(BMP280::OVERSAMPLING_X1);
+    humDevice.setStandby(BMP280::STANDBY_0_5_MS);
+    if (!humDevice.init(true))
+    {
+        fprintf(stderr, "Error: Initializing BME280 device\n");
+        timerThread.end();
+        return 1;
+    }
+
+    struct SampleData sampleData;
+    pthread_mutex_init(&sampleData.m_dataMutex, NULL);
+    sampleData.m_numSamples = 0;
+    humDevice.registerListener(sampleHandler, &sampleData);
+
+    // A listener unregistering itself from its callback is called once
+    uint32_t oneShotCalls = 0;
+    s_oneShotDevice = &humDevice;
+    humDevice.registerListener(oneShotHandler, &oneShotCalls);
+
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+    devBus.resetNumTransactions();
+    usleep(500000);
+    humDevice.unregisterListener(sampleHandler);
+    gettimeofday(&end, NULL);
+    uint32_t transactions = devBus.getNumTransactions();
+
+    humDevice.destroy();
+    timerThread.end();
+
+    pthread_mutex_lock(&sampleData.m_dataMutex);
+    uint32_t numSamples = sampleData.m_numSamples;
+    double humidityPct;
+    humDevice.calcTempPressure(sampleData.m_temp, sampleData.m_pressure, &tempC, &pressurehPa);
+    humDevice.calcHumidity(sampleData.m_temp, sampleData.m_humidity, &humidityPct);
+    pthread_mutex_unlock(&sampleData.m_dataMutex);
+    pthread_mutex_destroy(&sampleData.m_dataMutex);
+
+    double elapsedS = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
+    printf("BME280 normal mode: %u samples in %.2fs (%.1fHz, period %.2fms), %.2f bus transactions per sample\n",
+           numSamples, elapsedS, numSamples / elapsedS, humDevice.getSamplePeriod(),
+           numSamples > 0 ? ((double) transactions) / numSamples : 0.0);
+    printf("BME280 last sample: %.2fC %.4fhPa %.2f%%RH\n", tempC, pressurehPa, humidityPct);
+    passed &= check("normal mode samples", numSamples > 0 ? 1 : 0, 1, 0);
+    passed &= check("one shot calls", oneShotCalls, 1, 0);
+    passed &= check("normal mode temperature", tempC, 25.08, 0.001);
+    passed &= check("normal mode pressure", pressurehPa, 1006.5327, 0.001);
+    passed &= check("humidity in range", (humidityPct > 0.0 && humidityPct <= 100.0) ? 1 : 0, 1, 0);
+
+    devBus.destroy();
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void sampleHandler (const int32_t _temp, const int32_t _pressure, const int32_t _humidity, void* _data)
+{
+    struct SampleData* _sampleData = static_cast<struct SampleData*>(_data);
+
+    // Atomic update
+    pthread_mutex_lock (&_sampleData->m_dataMutex);
+
+    _sampleData->m_numSamples++;
+    _sampleData->m_temp = _temp;
+    _sampleData->m_pressure = _pressure;
+    _sampleData->m_humidity = _humidity;
+
+    pthread_mutex_unlock (&_sampleData->m_dataMutex);
+}
+
+void oneShotHandler (const int32_t _temp, const int32_t _pressure, const int32_t _humidity, void* _data)
+{
+    (*static_cast<uint32_t*>(_data))++;
+    s_oneShotDevice->unregisterListener(oneShotHandler);
+}
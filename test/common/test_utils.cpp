@@ -0,0 +1,54 @@
+/*
+ * Filename: test_utils.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Implementation file for helpers shared by the test programs
+ */
+
+#include <math.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <string>
+
+#include "test_utils.h"
+
+bool check (const char* _name, double _value, double _expected, double _tolerance)
+{
+    if (fabs(_value - _expected) <= _tolerance)
+        return true;
+
+    fprintf(stderr, "Error: %s is %f, expected %f\n", _name, _value, _expected);
+    return false;
+}
+
+bool check (const char* _name, double _value, double _expected)
+{
+    return check (_name, _value, _expected, 1e-6 * fabs(_expected) + 1e-9);
+}
+
+double elapsedNs (const struct timespec& _start, const struct timespec& _end)
+{
+    return (_end.tv_sec - _start.tv_sec) * 1e9 + (_end.tv_nsec - _start.tv_nsec);
+}
+
+double nowMs ()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+void removeLog (const char* _dir)
+{
+    DIR* dir = opendir(_dir);
+    if (dir == NULL)
+        return;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] != '.')
+            unlink((std::string(_dir) + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+}
@@ -0,0 +1,602 @@
+/*
+ * Filename: filter_bench_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A benchmark program that replays a day of simulated 100Hz
+ *              pressure data through the averaging filters, comparing per
+ *              sample virtual calls, static calls and bulk addValues, and
+ *              a multi-channel filter bank against separate filters, and
+ *              the median and Hampel filters across window sizes against
+ *              re-sorting the window, checking the MAD and that every
+ *              injected spike and no sensor noise is replaced, and the sliding min/max against
+ *              scanning the window, and the streaming quantile estimators
+ *              against sorting the whole day, and the time windowed average
+ *              at a varying sample rate against averaging the window,
+ *              checking that the results match. Also tracks a simulated
+ *              climbing and descending altitude with the Kalman filters,
+ *              checking they follow it more closely than a moving average.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include <vector>
+#include <algorithm>
+
+#include "avg_filter.h"
+#include "simple_avg_filter.h"
+#include "exp_avg_filter.h"
+#include "reduce.h"
+#include "filter_bank.h"
+#include "median_filter.h"
+#include "indexable_skiplist.h"
+#include "hampel_filter.h"
+#include "min_max_window.h"
+#include "p2_quantile.h"
+#include "t_digest.h"
+#include "time_avg_filter.h"
+#include "kalman_filter.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const size_t     NUM_SAMPLES     = 24 * 60 * 60 * 100;
+static const uint32_t   WINDOW_SIZE     = 1000;
+static const double     ALPHA           = 0.01;
+static const uint32_t   BANK_CHANNELS   = 256;
+static const uint32_t   BANK_WINDOW     = 18;
+static const size_t     MEDIAN_SAMPLES  = 1000000;
+static const size_t     NAIVE_SAMPLES   = 20000;
+static const size_t     MIN_MAX_CHECK   = 4999;
+static const size_t     SPIKE_INTERVAL  = 97;
+static const double     SPIKE_SIZE      = 5000.0;
+static const double     NOISE_RANGE     = 10.0;
+static const uint32_t   MIN_EXACT_HAMPEL_WINDOW = 99;
+static const uint32_t   NUM_DIGESTS     = 4;
+static const double     P2_RANK_ERROR   = 0.01;
+static const double     DIGEST_RANK_ERROR = 0.005;
+static const uint64_t   TIME_WINDOW_US  = 1000000;
+static const uint32_t   TIME_MAX_SAMPLES = 128;
+static const double     ALT_INTERVAL    = 0.01;
+static const double     ALT_NOISE       = 0.25;
+static const double     ALT_MAX_SPEED   = 2.0;
+static const double     ALT_PERIOD      = 600.0;
+static const uint32_t   ALT_WINDOW      = 18;
+
+static volatile double  g_sink;
+
+bool checkRank (const char* _name, double _value, const std::vector<double>& _sorted, double _quantile,
+                double _maxError);
+template <class Filter> double benchStatic (Filter& _filter, const std::vector<double>& _data);
+double benchVirtual (AvgFilter<double>* _filter, const std::vector<double>& _data);
+double gaussianNoise (double _stdDev);
+double windowMedian (std::vector<double> _values);
+double benchBulk (AvgFilter<double>* _filter, const std::vector<double>& _data);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    // Pressure around 1000hPa with a slow drift and sensor noise
+    std::vector<double> data(NUM_SAMPLES);
+    srand(1);
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+        data[i] = 100000.0 + 200.0 * sin(i * 2.0 * M_PI / NUM_SAMPLES) + (rand() % 1000) * NOISE_RANGE / 1000.0;
+
+    printf("Replaying %zu samples (one day at 100Hz)\n", data.size());
+    printf("%-36s %10s %12s\n", "filter", "time (ms)", "ns/sample");
+
+    // Simple moving average
+    SimpleAvgFilter<double> simpleRef(WINDOW_SIZE);
+    double ms = benchVirtual(&simpleRef, data);
+    printf("%-36s %10.2f %12.2f\n", "SimpleAvgFilter addValue (virtual)", ms, ms * 1e6 / NUM_SAMPLES);
+
+    BasicSimpleAvgFilter<double> simpleStatic(WINDOW_SIZE);
+    ms = benchStatic(simpleStatic, data);
+    printf("%-36s %10.2f %12.2f\n", "BasicSimpleAvgFilter addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    SimpleAvgFilter<double> simpleBulk(WINDOW_SIZE);
+    ms = benchBulk(&simpleBulk, data);
+    printf("%-36s %10.2f %12.2f\n", "SimpleAvgFilter addValues", ms, ms * 1e6 / NUM_SAMPLES);
+
+    passed &= check("simple average", simpleBulk.getAvg(), simpleRef.getAvg());
+    passed &= check("simple std dev", simpleBulk.getStdDev(), simpleRef.getStdDev());
+
+    // A large step leaving the window must not leave rounding behind
+    BasicSimpleAvgFilter<double> simpleStep(WINDOW_SIZE);
+    for (uint32_t i = 0; i < WINDOW_SIZE; i++)
+        simpleStep.addValue(1e9 + data[i]);
+    for (uint32_t i = 0; i < 3 * WINDOW_SIZE / 2; i++)
+        simpleStep.addValue(data[i]);
+
+    BasicSimpleAvgFilter<double> simpleExact(WINDOW_SIZE);
+    simpleExact.addValues(&data[0], 3 * WINDOW_SIZE / 2);
+    passed &= check("simple step average", simpleStep.getAvg(), simpleExact.getAvg());
+    passed &= check("simple step std dev", simpleStep.getStdDev(), simpleExact.getStdDev(), 1e-6);
+
+    // Exponential moving average, exponentially weighted and windowed std dev
+    ExpAvgFilter<double> expRef(ALPHA);
+    ms = benchVirtual(&expRef, data);
+    printf("%-36s %10.2f %12.2f\n", "ExpAvgFilter addValue (virtual)", ms, ms * 1e6 / NUM_SAMPLES);
+
+    ExpAvgFilter<double> expBulk(ALPHA);
+    ms = benchBulk(&expBulk, data);
+    printf("%-36s %10.2f %12.2f\n", "ExpAvgFilter addValues", ms, ms * 1e6 / NUM_SAMPLES);
+
+    passed &= check("exp average", expBulk.getAvg(), expRef.getAvg());
+    passed &= check("exp std dev", expBulk.getStdDev(), expRef.getStdDev());
+
+    ExpAvgFilter<double> expWinRef(ALPHA, WINDOW_SIZE);
+    ms = benchVirtual(&expWinRef, data);
+    printf("%-36s %10.2f %12.2f\n", "ExpAvgFilter windowed addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    ExpAvgFilter<double> expWinBulk(ALPHA, WINDOW_SIZE);
+    ms = benchBulk(&expWinBulk, data);
+    printf("%-36s %10.2f %12.2f\n", "ExpAvgFilter windowed addValues", ms, ms * 1e6 / NUM_SAMPLES);
+
+    passed &= check("windowed exp std dev", expWinBulk.getStdDev(), expWinRef.getStdDev());
+
+    // The day split across a bank of channels, against one filter per channel
+    size_t numRows = NUM_SAMPLES / BANK_CHANNELS;
+    std::vector<BasicSimpleAvgFilter<double>*> channelFilters;
+    for (uint32_t i = 0; i < BANK_CHANNELS; i++)
+        channelFilters.push_back(new BasicSimpleAvgFilter<double>(BANK_WINDOW));
+
+    double start = nowMs();
+    for (size_t row = 0; row < numRows; row++)
+        for (uint32_t i = 0; i < BANK_CHANNELS; i++)
+            channelFilters[i]->addValue(data[row * BANK_CHANNELS + i]);
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "256 BasicSimpleAvgFilters", ms, ms * 1e6 / (numRows * BANK_CHANNELS));
+
+    FilterBank<double> simpleBank(FilterBank<double>::SIMPLE_AVG, BANK_CHANNELS, BANK_WINDOW);
+    start = nowMs();
+    for (size_t row = 0; row < numRows; row++)
+        simpleBank.addValues(&data[row * BANK_CHANNELS]);
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "FilterBank SIMPLE_AVG 256 channels", ms, ms * 1e6 / (numRows * BANK_CHANNELS));
+
+    for (uint32_t i = 0; i < BANK_CHANNELS; i += BANK_CHANNELS / 4)
+    {
+        passed &= check("bank average", simpleBank.getAvg(i), channelFilters[i]->getAvg());
+        passed &= check("bank std dev", simpleBank.getStdDev(i), channelFilters[i]->getStdDev());
+    }
+    for (uint32_t i = 0; i < BANK_CHANNELS; i++)
+        delete channelFilters[i];
+
+    FilterBank<double> expBank(FilterBank<double>::EXP_AVG, BANK_CHANNELS, BANK_WINDOW, ALPHA);
+    BasicExpAvgFilter<double> expChannel(ALPHA, BANK_WINDOW);
+    start = nowMs();
+    for (size_t row = 0; row < numRows; row++)
+        expBank.addValues(&data[row * BANK_CHANNELS]);
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "FilterBank EXP_AVG 256 channels", ms, ms * 1e6 / (numRows * BANK_CHANNELS));
+
+    for (size_t row = 0; row < numRows; row++)
+        expChannel.addValue(data[row * BANK_CHANNELS + 1]);
+    passed &= check("exp bank average", expBank.getAvg(1), expChannel.getAvg());
+    passed &= check("exp bank std dev", expBank.getStdDev(1), expChannel.getStdDev());
+
+    // Median and Hampel filters over a range of windows, against copying and
+    // partially sorting the window for every sample
+    std::vector<double> spiky(data.begin(), data.begin() + MEDIAN_SAMPLES);
+    uint32_t numSpikes = 0;
+    for (size_t i = SPIKE_INTERVAL - 1; i < MEDIAN_SAMPLES; i += SPIKE_INTERVAL)
+    {
+        spiky[i] += SPIKE_SIZE;
+        numSpikes++;
+    }
+
+    std::vector<double> hampelOutput(MEDIAN_SAMPLES);
+    const uint32_t medianWindows[] = {10, 99, 100, 1000, 10000};
+    for (uint32_t w = 0; w < sizeof(medianWindows) / sizeof(medianWindows[0]); w++)
+    {
+        uint32_t window = medianWindows[w];
+        char name[64];
+
+        BasicMedianFilter<double> median(window);
+        start = nowMs();
+        for (size_t i = 0; i < MEDIAN_SAMPLES; i++)
+        {
+            median.addValue(spiky[i]);
+            g_sink = median.getAvg();
+        }
+        ms = nowMs() - start;
+        snprintf(name, sizeof(name), "MedianFilter window %u", window);
+        printf("%-36s %10.2f %12.2f\n", name, ms, ms * 1e6 / MEDIAN_SAMPLES);
+
+        BasicHampelFilter<double> hampel(window);
+        start = nowMs();
+        for (size_t i = 0; i < MEDIAN_SAMPLES; i++)
+        {
+            hampel.addValue(spiky[i]);
+            hampelOutput[i] = hampel.getAvg();
+        }
+        ms = nowMs() - start;
+        snprintf(name, sizeof(name), "HampelFilter window %u", window);
+        printf("%-36s %10.2f %12.2f\n", name, ms, ms * 1e6 / MEDIAN_SAMPLES);
+
+        // The spikes the Hampel filter replaced keep the window's median
+        std::vector<double> sorted;
+        bool replacedMatched = true;
+        start = nowMs();
+        for (size_t i = MEDIAN_SAMPLES - NAIVE_SAMPLES; i < MEDIAN_SAMPLES; i++)
+        {
+            sorted.assign(spiky.begin() + (i + 1 - window), spiky.begin() + (i + 1));
+            std::nth_element(sorted.begin(), sorted.begin() + window / 2, sorted.end());
+            g_sink = sorted[window / 2];
+            if (i % SPIKE_INTERVAL == SPIKE_INTERVAL - 1)
+                replacedMatched &= (hampelOutput[i] == windowMedian(sorted));
+        }
+        ms = nowMs() - start;
+        snprintf(name, sizeof(name), "re-sorted median window %u", window);
+        printf("%-36s %10.2f %12.2f\n", name, ms * MEDIAN_SAMPLES / NAIVE_SAMPLES, ms * 1e6 / NAIVE_SAMPLES);
+
+        std::vector<double> deviations(sorted.size());
+        double windowMed = windowMedian(sorted);
+        for (size_t i = 0; i < sorted.size(); i++)
+            deviations[i] = fabs(sorted[i] - windowMed);
+
+        passed &= check("median", median.getAvg(), windowMed);
+        passed &= check("median MAD", median.getMAD(), windowMedian(deviations));
+        passed &= check("hampel std dev", hampel.getStdDev(),
+                        BasicMedianFilter<double>::MAD_SCALE * windowMedian(deviations));
+
+        // Every spike is replaced, and the sensor noise stays within its
+        // range. The MAD of a few samples is too small to tell the noise
+        // from outliers, so the outlier count is only exact for larger
+        // windows.
+        uint32_t numReplaced = 0;
+        bool noiseKept = true;
+        for (size_t i = 0; i < MEDIAN_SAMPLES; i++)
+        {
+            double error = fabs(hampelOutput[i] - data[i]);
+            if (i % SPIKE_INTERVAL == SPIKE_INTERVAL - 1)
+                numReplaced += error < SPIKE_SIZE / 2.0 ? 1 : 0;
+            else
+                noiseKept &= error <= NOISE_RANGE;
+        }
+        printf("%-36s %10u %12u\n", "  spikes replaced, outliers", numReplaced, hampel.getNumOutliers());
+        passed &= check("hampel spikes replaced", numReplaced, numSpikes);
+        if (window >= MIN_EXACT_HAMPEL_WINDOW)
+            passed &= check("hampel outliers", hampel.getNumOutliers(), numSpikes);
+        if (!noiseKept)
+            fprintf(stderr, "Error: Hampel window %u moved a noise sample out of the noise range\n", window);
+        passed &= noiseKept;
+        if (!replacedMatched)
+            fprintf(stderr, "Error: Hampel replacements do not match the re-sorted median\n");
+        passed &= replacedMatched;
+    }
+
+    // NaN takes a window slot without entering the sorted order, and
+    // removing it must not take out the smallest value instead
+    IndexableSkipList<double> skiplist(4);
+    skiplist.insert(1.0);
+    skiplist.insert(2.0);
+    passed &= check("skiplist NaN insert", skiplist.insert(nan("")) ? 1 : 0, 0);
+    passed &= check("skiplist NaN remove", skiplist.remove(nan("")) ? 1 : 0, 0);
+    passed &= check("skiplist NaN size", skiplist.size(), 2);
+    passed &= check("skiplist NaN smallest", skiplist.at(0), 1.0);
+
+    BasicMedianFilter<double> nanMedian(3);
+    BasicHampelFilter<double> nanHampel(3);
+    const double nanInput[] = {1.0, nan(""), 3.0, 5.0, 7.0};
+    for (uint32_t i = 0; i < sizeof(nanInput) / sizeof(nanInput[0]); i++)
+    {
+        nanMedian.addValue(nanInput[i]);
+        nanHampel.addValue(nanInput[i]);
+        if (i == 1)
+        {
+            passed &= check("NaN median", nanMedian.getAvg(), 1.0);
+            passed &= check("NaN replaced", nanHampel.getAvg(), 1.0);
+        }
+    }
+    passed &= check("median after NaN", nanMedian.getAvg(), 5.0);
+    passed &= check("NaN outliers", nanHampel.getNumOutliers(), 1);
+
+    // Sliding min/max over the whole day, scanning the window every so often
+    // to check it
+    MinMaxWindow<double> minMax(WINDOW_SIZE);
+    bool minMaxMatched = true;
+    ms = 0.0;
+    for (size_t i = 0; i < NUM_SAMPLES; i += MIN_MAX_CHECK)
+    {
+        size_t end = std::min(i + MIN_MAX_CHECK, NUM_SAMPLES);
+        start = nowMs();
+        for (size_t j = i; j < end; j++)
+        {
+            minMax.addValue(data[j]);
+            g_sink = minMax.getMax();
+        }
+        ms += nowMs() - start;
+
+        size_t first = (end > WINDOW_SIZE) ? end - WINDOW_SIZE : 0;
+        std::vector<double>::iterator begin = data.begin() + first;
+        minMaxMatched &= (minMax.getMin() == *std::min_element(begin, data.begin() + end));
+        minMaxMatched &= (minMax.getMax() == *std::max_element(begin, data.begin() + end));
+    }
+    printf("%-36s %10.2f %12.2f\n", "MinMaxWindow addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    start = nowMs();
+    for (size_t i = NUM_SAMPLES - NAIVE_SAMPLES; i < NUM_SAMPLES; i++)
+        g_sink = *std::max_element(data.begin() + (i + 1 - WINDOW_SIZE), data.begin() + (i + 1));
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "scanned max", ms * NUM_SAMPLES / NAIVE_SAMPLES, ms * 1e6 / NAIVE_SAMPLES);
+
+    if (!minMaxMatched)
+        fprintf(stderr, "Error: MinMaxWindow does not match scanning the window\n");
+    passed &= minMaxMatched;
+
+    // Streaming quantiles over the whole day, with one P2 estimator per
+    // quantile, one t-digest, and t-digests over each part of the day merged
+    const double quantiles[] = {0.5, 0.95, 0.99};
+    const uint32_t numQuantiles = sizeof(quantiles) / sizeof(quantiles[0]);
+
+    std::vector<P2Quantile> p2;
+    for (uint32_t q = 0; q < numQuantiles; q++)
+        p2.push_back(P2Quantile(quantiles[q]));
+    start = nowMs();
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+    {
+        for (uint32_t q = 0; q < numQuantiles; q++)
+            p2[q].addValue(data[i]);
+    }
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "P2Quantile x3 addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    TDigest digest;
+    start = nowMs();
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+        digest.addValue(data[i]);
+    g_sink = digest.getQuantile(0.5);
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "TDigest addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    std::vector<TDigest> parts(NUM_DIGESTS);
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+        parts[i * NUM_DIGESTS / NUM_SAMPLES].addValue(data[i]);
+    TDigest merged;
+    start = nowMs();
+    for (uint32_t d = 0; d < NUM_DIGESTS; d++)
+        merged.merge(parts[d]);
+    g_sink = merged.getQuantile(0.5);
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12u\n", "TDigest merge (ms, centroids)", ms, merged.getNumCentroids());
+
+    std::vector<double> sortedDay(data);
+    start = nowMs();
+    std::sort(sortedDay.begin(), sortedDay.end());
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "sort", ms, ms * 1e6 / NUM_SAMPLES);
+
+    for (uint32_t q = 0; q < numQuantiles; q++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "P2 p%g", quantiles[q] * 100.0);
+        passed &= checkRank(name, p2[q].getQuantile(), sortedDay, quantiles[q], P2_RANK_ERROR);
+        snprintf(name, sizeof(name), "t-digest p%g", quantiles[q] * 100.0);
+        passed &= checkRank(name, digest.getQuantile(quantiles[q]), sortedDay, quantiles[q], DIGEST_RANK_ERROR);
+        snprintf(name, sizeof(name), "merged t-digest p%g", quantiles[q] * 100.0);
+        passed &= checkRank(name, merged.getQuantile(quantiles[q]), sortedDay, quantiles[q], DIGEST_RANK_ERROR);
+    }
+    passed &= check("merged t-digest min", merged.getMin(), sortedDay.front());
+    passed &= check("merged t-digest max", merged.getMax(), sortedDay.back());
+
+    // Time windowed average, with the sample period switching between 10ms,
+    // 40ms and 20ms every minute and jittering by up to 1ms
+    std::vector<uint64_t> timesUs(NUM_SAMPLES);
+    const uint64_t periodsUs[] = {10000, 40000, 20000};
+    uint64_t timeUs = 0;
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+    {
+        uint64_t period = periodsUs[(timeUs / 60000000) % 3];
+        timeUs += period - 500 + rand() % 1000;
+        timesUs[i] = timeUs;
+    }
+
+    BasicTimeAvgFilter<double> timeAvg(TIME_WINDOW_US, TIME_MAX_SAMPLES);
+    bool timeAvgMatched = true;
+    ms = 0.0;
+    for (size_t i = 0; i < NUM_SAMPLES; i += MIN_MAX_CHECK)
+    {
+        size_t end = std::min(i + MIN_MAX_CHECK, NUM_SAMPLES);
+        start = nowMs();
+        for (size_t j = i; j < end; j++)
+        {
+            timeAvg.addValue(timesUs[j], data[j]);
+            g_sink = timeAvg.getAvg();
+        }
+        ms += nowMs() - start;
+
+        size_t first = end - 1;
+        while (first > 0 && timesUs[end - 1] - timesUs[first - 1] < TIME_WINDOW_US)
+            first--;
+        uint32_t num = end - first;
+        double mean = reduceSum(&data[first], num) / num;
+        double stdDev = sqrt(reduceSumSqDiff(&data[first], num, mean) / num);
+        timeAvgMatched &= (timeAvg.getNumSamples() == num);
+        timeAvgMatched &= check("time average", timeAvg.getAvg(), mean);
+        timeAvgMatched &= (fabs(timeAvg.getStdDev() - stdDev) <= 1e-6 * stdDev);
+    }
+    printf("%-36s %10.2f %12.2f\n", "BasicTimeAvgFilter addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    BasicTimeExpAvgFilter<double> timeExp(TIME_WINDOW_US);
+    start = nowMs();
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+    {
+        timeExp.addValue(timesUs[i], data[i]);
+        g_sink = timeExp.getAvg();
+    }
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "BasicTimeExpAvgFilter addValue", ms, ms * 1e6 / NUM_SAMPLES);
+
+    if (!timeAvgMatched)
+        fprintf(stderr, "Error: BasicTimeAvgFilter does not match averaging the window\n");
+    passed &= timeAvgMatched;
+
+    // Altitude climbing and descending at up to ALT_MAX_SPEED, measured with
+    // BMP085 ultra high resolution noise. The moving average lags the
+    // climbs, the Kalman filters should not.
+    std::vector<double> trueAlt(NUM_SAMPLES);
+    std::vector<double> trueSpeed(NUM_SAMPLES);
+    std::vector<double> measuredAlt(NUM_SAMPLES);
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+    {
+        double t = i * ALT_INTERVAL;
+        double w = 2.0 * M_PI / ALT_PERIOD;
+        trueAlt[i] = 100.0 + ALT_MAX_SPEED / w * (1.0 - cos(w * t));
+        trueSpeed[i] = ALT_MAX_SPEED * sin(w * t);
+        measuredAlt[i] = trueAlt[i] + gaussianNoise(ALT_NOISE);
+    }
+
+    BasicSimpleAvgFilter<double> altAvg(ALT_WINDOW);
+    BasicKalmanFilter<double, CONSTANT_VELOCITY> altCV(ALT_INTERVAL, ALT_NOISE, 0.1);
+    BasicKalmanFilter<double, CONSTANT_ACCELERATION> altCA(ALT_INTERVAL, ALT_NOISE, 0.01);
+    double avgSqErr = 0.0;
+    double cvSqErr = 0.0;
+    double caSqErr = 0.0;
+    double cvSpeedSqErr = 0.0;
+    double caSpeedSqErr = 0.0;
+    double cvMs = 0.0;
+    double caMs = 0.0;
+    for (size_t i = 0; i < NUM_SAMPLES; i += MIN_MAX_CHECK)
+    {
+        size_t end = std::min(i + MIN_MAX_CHECK, NUM_SAMPLES);
+
+        start = nowMs();
+        for (size_t j = i; j < end; j++)
+        {
+            altCV.addValue(measuredAlt[j]);
+            g_sink = altCV.getAvg();
+        }
+        cvMs += nowMs() - start;
+
+        start = nowMs();
+        for (size_t j = i; j < end; j++)
+        {
+            altCA.addValue(measuredAlt[j]);
+            g_sink = altCA.getAvg();
+        }
+        caMs += nowMs() - start;
+
+        // Sample the errors once per block, the filters are settled by then
+        altAvg.addValues(&measuredAlt[end - ALT_WINDOW], ALT_WINDOW);
+        double alt = trueAlt[end - 1];
+        double speed = trueSpeed[end - 1];
+        avgSqErr += (altAvg.getAvg() - alt) * (altAvg.getAvg() - alt);
+        cvSqErr += (altCV.getAvg() - alt) * (altCV.getAvg() - alt);
+        caSqErr += (altCA.getAvg() - alt) * (altCA.getAvg() - alt);
+        cvSpeedSqErr += (altCV.getVelocity() - speed) * (altCV.getVelocity() - speed);
+        caSpeedSqErr += (altCA.getVelocity() - speed) * (altCA.getVelocity() - speed);
+    }
+    printf("%-36s %10.2f %12.2f\n", "BasicKalmanFilter CV addValue", cvMs, cvMs * 1e6 / NUM_SAMPLES);
+    printf("%-36s %10.2f %12.2f\n", "BasicKalmanFilter CA addValue", caMs, caMs * 1e6 / NUM_SAMPLES);
+
+    double numChecks = (double) ((NUM_SAMPLES + MIN_MAX_CHECK - 1) / MIN_MAX_CHECK);
+    double avgRms = sqrt(avgSqErr / numChecks);
+    double cvRms = sqrt(cvSqErr / numChecks);
+    double caRms = sqrt(caSqErr / numChecks);
+    printf("altitude rms error (m): moving average %.4f, Kalman CV %.4f, Kalman CA %.4f\n", avgRms, cvRms, caRms);
+    printf("vertical speed rms error (m/s): Kalman CV %.4f, Kalman CA %.4f\n",
+           sqrt(cvSpeedSqErr / numChecks), sqrt(caSpeedSqErr / numChecks));
+
+    if (cvRms >= avgRms || caRms >= avgRms)
+    {
+        fprintf(stderr, "Error: Kalman filters track the altitude worse than the moving average\n");
+        passed = false;
+    }
+    if (sqrt(cvSpeedSqErr / numChecks) > 0.1 * ALT_MAX_SPEED || sqrt(caSpeedSqErr / numChecks) > 0.1 * ALT_MAX_SPEED)
+    {
+        fprintf(stderr, "Error: Kalman filter vertical speed is off by more than 10%%\n");
+        passed = false;
+    }
+
+    // Raw reductions over the whole day
+    start = nowMs();
+    double scalarSum = 0.0;
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+        scalarSum += data[i];
+    g_sink = scalarSum;
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "scalar sum", ms, ms * 1e6 / NUM_SAMPLES);
+
+    start = nowMs();
+    double vecSum = reduceSum(&data[0], NUM_SAMPLES);
+    g_sink = vecSum;
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "reduceSum", ms, ms * 1e6 / NUM_SAMPLES);
+
+    start = nowMs();
+    g_sink = reduceSumSqDiff(&data[0], NUM_SAMPLES, vecSum / NUM_SAMPLES);
+    ms = nowMs() - start;
+    printf("%-36s %10.2f %12.2f\n", "reduceSumSqDiff", ms, ms * 1e6 / NUM_SAMPLES);
+
+    passed &= check("reduceSum", vecSum / NUM_SAMPLES, scalarSum / NUM_SAMPLES);
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// Median of the values, averaging the middle two of an even number
+double windowMedian (std::vector<double> _values)
+{
+    size_t num = _values.size();
+    std::nth_element(_values.begin(), _values.begin() + num / 2, _values.end());
+    double upper = _values[num / 2];
+    if (num % 2 == 1)
+        return upper;
+
+    return (*std::max_element(_values.begin(), _values.begin() + num / 2) + upper) / 2.0;
+}
+
+// Checks that _value sits within _maxError of _quantile in rank
+bool checkRank (const char* _name, double _value, const std::vector<double>& _sorted, double _quantile,
+                double _maxError)
+{
+    double num = (double) _sorted.size();
+    double lower = (std::lower_bound(_sorted.begin(), _sorted.end(), _value) - _sorted.begin()) / num;
+    double upper = (std::upper_bound(_sorted.begin(), _sorted.end(), _value) - _sorted.begin()) / num;
+    if (_quantile >= lower - _maxError && _quantile <= upper + _maxError)
+        return true;
+
+    fprintf(stderr, "Error: %s is %f at rank %f, expected rank %f\n", _name, _value, lower, _quantile);
+    return false;
+}
+
+// Box-Muller transform of two uniform samples
+double gaussianNoise (double _stdDev)
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return _stdDev * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+template <class Filter> double benchStatic (Filter& _filter, const std::vector<double>& _data)
+{
+    double start = nowMs();
+    for (size_t i = 0; i < _data.size(); i++)
+        _filter.addValue(_data[i]);
+    g_sink = _filter.getAvg();
+    return nowMs() - start;
+}
+
+double benchVirtual (AvgFilter<double>* _filter, const std::vector<double>& _data)
+{
+    double start = nowMs();
+    for (size_t i = 0; i < _data.size(); i++)
+        _filter->addValue(_data[i]);
+    g_sink = _filter->getAvg();
+    return nowMs() - start;
+}
+
+double benchBulk (AvgFilter<double>* _filter, const std::vector<double>& _data)
+{
+    double start = nowMs();
+    _filter->addValues(&_data[0], _data.size());
+    g_sink = _filter->getAvg();
+    return nowMs() - start;
+}
@@ -0,0 +1,187 @@
+/*
+ * Filename: filter_dsp_bench_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A benchmark program for the FIR and biquad filters. Runs a
+ *              day of simulated 100Hz pressure data through FIR filters
+ *              across tap counts, with and without decimation to 10Hz,
+ *              against a plain convolution, and through Butterworth biquad
+ *              cascades sample by sample and in blocks, checking that the
+ *              outputs match and that the filters pass and stop the
+ *              frequencies they should.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include <vector>
+
+#include "fir_filter.h"
+#include "biquad_filter.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const size_t     NUM_SAMPLES     = 24 * 60 * 60 * 100;
+static const double     SAMPLE_RATE     = 100.0;
+static const double     CUTOFF          = 4.0 / SAMPLE_RATE;
+static const uint32_t   DECIMATION      = 10;
+static const size_t     NAIVE_SAMPLES   = 100000;
+static const size_t     BLOCK_SIZE      = 256;
+
+// Test tones, one well inside the pass band and one in the stop band
+static const double     PASS_FREQ       = 0.5 / SAMPLE_RATE;
+static const double     STOP_FREQ       = 20.0 / SAMPLE_RATE;
+static const double     MAX_PASS_LOSS   = 0.01;
+static const double     MAX_STOP_GAIN   = 0.01;
+
+static volatile double  g_sink;
+
+double firReference (const std::vector<double>& _taps, const std::vector<double>& _data, size_t _index);
+template <class Filter> double sineGain (Filter& _filter, double _freq);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    // Pressure around 1000hPa with a slow drift and sensor noise
+    std::vector<double> data(NUM_SAMPLES);
+    srand(1);
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+        data[i] = 100000.0 + 200.0 * sin(i * 2.0 * M_PI / NUM_SAMPLES) + (rand() % 1000) / 100.0;
+
+    printf("Replaying %zu samples (one day at 100Hz)\n", data.size());
+    printf("%-36s %10s %12s\n", "filter", "time (ms)", "ns/sample");
+
+    std::vector<double> out(NUM_SAMPLES);
+    const uint32_t tapCounts[] = {15, 31, 63, 127, 255};
+    for (uint32_t t = 0; t < sizeof(tapCounts) / sizeof(tapCounts[0]); t++)
+    {
+        uint32_t numTaps = tapCounts[t];
+        std::vector<double> taps(numTaps);
+        FirFilter::designLowPass(CUTOFF, numTaps, &taps[0]);
+        char name[64];
+
+        FirFilter fir(&taps[0], numTaps);
+        double start = nowMs();
+        size_t numOut = fir.process(&data[0], NUM_SAMPLES, &out[0]);
+        double ms = nowMs() - start;
+        snprintf(name, sizeof(name), "FirFilter %u taps", numTaps);
+        printf("%-36s %10.2f %12.2f\n", name, ms, ms * 1e6 / NUM_SAMPLES);
+
+        passed &= check("FIR outputs", numOut, NUM_SAMPLES);
+        passed &= check("FIR output", out[NUM_SAMPLES - 1], firReference(taps, data, NUM_SAMPLES - 1));
+
+        FirFilter decimator(&taps[0], numTaps, DECIMATION);
+        start = nowMs();
+        numOut = decimator.process(&data[0], NUM_SAMPLES, &out[0]);
+        ms = nowMs() - start;
+        snprintf(name, sizeof(name), "FirFilter %u taps, 100Hz to 10Hz", numTaps);
+        printf("%-36s %10.2f %12.2f\n", name, ms, ms * 1e6 / NUM_SAMPLES);
+
+        passed &= check("decimated FIR outputs", numOut, NUM_SAMPLES / DECIMATION);
+        passed &= check("decimated FIR output", out[numOut - 1],
+                        firReference(taps, data, (numOut - 1) * DECIMATION));
+
+        start = nowMs();
+        for (size_t i = 0; i < NAIVE_SAMPLES; i++)
+            g_sink = firReference(taps, data, i);
+        ms = nowMs() - start;
+        snprintf(name, sizeof(name), "convolution %u taps", numTaps);
+        printf("%-36s %10.2f %12.2f\n", name, ms * NUM_SAMPLES / NAIVE_SAMPLES, ms * 1e6 / NAIVE_SAMPLES);
+
+        // Too few taps cannot make the transition band narrow enough
+        if (numTaps >= 63)
+        {
+            FirFilter tone(&taps[0], numTaps);
+            double passGain = sineGain(tone, PASS_FREQ);
+            double stopGain = sineGain(tone, STOP_FREQ);
+            if (fabs(passGain - 1.0) > MAX_PASS_LOSS || stopGain > MAX_STOP_GAIN)
+            {
+                fprintf(stderr, "Error: %u tap FIR gains are %f and %f\n", numTaps, passGain, stopGain);
+                passed = false;
+            }
+        }
+    }
+
+    const uint32_t orders[] = {2, 4, 8};
+    for (uint32_t o = 0; o < sizeof(orders) / sizeof(orders[0]); o++)
+    {
+        uint32_t order = orders[o];
+        std::vector<BiquadFilter::BiquadCoeffs> sections(order / 2);
+        BiquadFilter::designButterworthLowPass(CUTOFF, order, &sections[0]);
+        char name[64];
+
+        BiquadFilter sampled(&sections[0], order / 2);
+        double start = nowMs();
+        for (size_t i = 0; i < NUM_SAMPLES; i++)
+        {
+            sampled.addValue(data[i]);
+            g_sink = sampled.getAvg();
+        }
+        double ms = nowMs() - start;
+        snprintf(name, sizeof(name), "BiquadFilter order %u addValue", order);
+        printf("%-36s %10.2f %12.2f\n", name, ms, ms * 1e6 / NUM_SAMPLES);
+
+        BiquadFilter blocked(&sections[0], order / 2);
+        start = nowMs();
+        for (size_t i = 0; i < NUM_SAMPLES; i += BLOCK_SIZE)
+        {
+            size_t num = (NUM_SAMPLES - i < BLOCK_SIZE) ? NUM_SAMPLES - i : BLOCK_SIZE;
+            blocked.process(&data[i], num, &out[i]);
+        }
+        ms = nowMs() - start;
+        snprintf(name, sizeof(name), "BiquadFilter order %u process", order);
+        printf("%-36s %10.2f %12.2f\n", name, ms, ms * 1e6 / NUM_SAMPLES);
+
+        passed &= check("biquad block output", blocked.getAvg(), sampled.getAvg());
+
+        // A second order section rolls off too slowly for the stop band tone
+        if (order >= 4)
+        {
+            BiquadFilter tone(&sections[0], order / 2);
+            double passGain = sineGain(tone, PASS_FREQ);
+            double stopGain = sineGain(tone, STOP_FREQ);
+            if (fabs(passGain - 1.0) > MAX_PASS_LOSS || stopGain > MAX_STOP_GAIN)
+            {
+                fprintf(stderr, "Error: order %u biquad gains are %f and %f\n", order, passGain, stopGain);
+                passed = false;
+            }
+        }
+    }
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// Plain convolution for the output at _index, with the samples before the
+// start taken to be the first sample as the filter does
+double firReference (const std::vector<double>& _taps, const std::vector<double>& _data, size_t _index)
+{
+    double sum = 0.0;
+    for (size_t k = 0; k < _taps.size(); k++)
+        sum += _taps[k] * ((_index >= k) ? _data[_index - k] : _data[0]);
+
+    return sum;
+}
+
+// Peak output over the second half of a ten second unit sine at _freq
+template <class Filter> double sineGain (Filter& _filter, double _freq)
+{
+    const size_t num = 10 * (size_t) SAMPLE_RATE;
+    double peak = 0.0;
+
+    _filter.reset();
+    for (size_t i = 0; i < num; i++)
+    {
+        _filter.addValue(sin(2.0 * M_PI * _freq * i));
+        if (i >= num / 2 && fabs(_filter.getAvg()) > peak)
+            peak = fabs(_filter.getAvg());
+    }
+
+    return peak;
+}
@@ -0,0 +1,268 @@
+/*
+ * Filename: i2c_trace_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that records the BMP085 driver's bus
+ *              traffic against the simulated device, replays the trace to
+ *              a fresh driver with no device behind it and checks it reads
+ *              the same samples, then prints the recording overhead and
+ *              trace size per transaction, and checks a device interrupt
+ *              re-entering the recorder mid transaction.
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "bmp085.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "i2c_recorder.h"
+#include "i2c_replayer.h"
+#include "virtual_clock.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const uint8_t CTRL_REG = 0xF4;
+static const uint8_t VALUE_MSB_REG = 0xF6;
+static const uint8_t TEMPERATURE = 0x2E;
+
+struct Sample
+{
+    int16_t     m_temp;
+    int32_t     m_pressure;
+};
+
+struct NestedData
+{
+    I2C*        m_bus;
+    uint32_t    m_numReads;
+    uint8_t     m_value;
+};
+
+void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+void nestedReadHandler (void* _data);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char path[] = "/tmp/i2c_trace_test_XXXXXX";
+    int32_t fd = mkstemp(path);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Error: Creating trace file\n");
+        return 1;
+    }
+    close(fd);
+
+    // Record sync reads at every OSSR setting then a minute of async
+    // sampling, all on virtual time
+    std::vector<Sample> recorded;
+    uint32_t numRecorded;
+    {
+        VirtualClock    clock;
+        SimGPIO         eocGPIO;
+        eocGPIO.init();
+        eocGPIO.setMode(GPIO::INPUT);
+
+        SimI2C          simBus;
+        SimBMP085       model(&clock, &eocGPIO);
+        simBus.attachDevice(SimBMP085::ADDRESS, &model);
+
+        I2CRecorder     recorder(&simBus, path, &clock);
+        if (!recorder.init())
+        {
+            fprintf(stderr, "Error: Initializing I2C recorder\n");
+            return 1;
+        }
+
+        BMP085 syncDevice(&recorder, &eocGPIO, NULL, NULL, &clock);
+        syncDevice.setSyncWaitMode(BMP085::SYNC_WAIT_INTERRUPT);
+        syncDevice.init(false);
+        for (int32_t ossr = 0; ossr < BMP085::OSSR_NUM; ossr++)
+        {
+            syncDevice.setOSSR((BMP085::OSSR_SETTING) ossr);
+            Sample sample;
+            sample.m_temp = syncDevice.readRawTempSync();
+            sample.m_pressure = syncDevice.readRawPressureSync();
+            recorded.push_back(sample);
+        }
+        syncDevice.destroy();
+
+        BMP085 asyncDevice(&recorder, &eocGPIO, NULL, &clock, &clock);
+        asyncDevice.init(true);
+        asyncDevice.registerListener(sampleHandler, &recorded);
+        clock.sleepUs(60 * 1000000);
+        asyncDevice.unregisterListener(sampleHandler);
+        asyncDevice.destroy();
+
+        numRecorded = recorder.getNumTransactions();
+        recorder.destroy();
+        printf("Recorded %u transactions, %u samples, %llu bytes (%.2f bytes per transaction)\n",
+               numRecorded, (uint32_t) recorded.size(), (unsigned long long) recorder.getNumBytes(),
+               ((double) recorder.getNumBytes()) / numRecorded);
+        passed &= check("bytes per transaction", recorder.getNumBytes() < 6 * numRecorded ? 1 : 0, 1, 0);
+    }
+
+    // Replay to fresh drivers, the test drives EOC in place of the device
+    {
+        VirtualClock    clock;
+        SimGPIO         eocGPIO;
+        eocGPIO.init();
+        eocGPIO.setMode(GPIO::INPUT);
+
+        I2CReplayer     replayer(path, &clock);
+        if (!replayer.init())
+        {
+            fprintf(stderr, "Error: Initializing I2C replayer\n");
+            return 1;
+        }
+        passed &= check("replayed transactions", replayer.getNumTransactions(), numRecorded, 0);
+
+        std::vector<Sample> replayed;
+        BMP085 syncDevice(&replayer, NULL, NULL, NULL, &clock);
+        syncDevice.init(false);
+        for (int32_t ossr = 0; ossr < BMP085::OSSR_NUM; ossr++)
+        {
+            syncDevice.setOSSR((BMP085::OSSR_SETTING) ossr);
+            Sample sample;
+            sample.m_temp = syncDevice.readRawTempSync();
+            sample.m_pressure = syncDevice.readRawPressureSync();
+            replayed.push_back(sample);
+        }
+        syncDevice.destroy();
+
+        BMP085 asyncDevice(&replayer, &eocGPIO, NULL, NULL, &clock);
+        uint64_t asyncStartUs = clock.nowUs();
+        asyncDevice.init(true);
+        asyncDevice.registerListener(sampleHandler, &replayed);
+        while (!replayer.finished())
+        {
+            eocGPIO.setLevel(0);
+            eocGPIO.setLevel(1);
+        }
+        asyncDevice.unregisterListener(sampleHandler);
+        asyncDevice.destroy();
+
+        bool same = replayed.size() == recorded.size();
+        for (uint32_t i = 0; same && i < replayed.size(); i++)
+            same = replayed[i].m_temp == recorded[i].m_temp && replayed[i].m_pressure == recorded[i].m_pressure;
+
+        printf("Replayed %u samples, %u mismatches, async section took %.3fs virtual\n",
+               (uint32_t) replayed.size(), replayer.getNumMismatches(),
+               (clock.nowUs() - asyncStartUs) / 1000000.0);
+        passed &= check("replayed samples match", same ? 1 : 0, 1, 0);
+        passed &= check("replay mismatches", replayer.getNumMismatches(), 0, 0);
+        // The replay clock follows the recording to the last transaction
+        passed &= check("replayed duration", (clock.nowUs() - asyncStartUs) / 1000000.0, 60.0, 0.05);
+
+        // A driver that diverges from the recording is caught
+        replayer.rewind();
+        BMP085 divergentDevice(&replayer, NULL, NULL, NULL, &clock);
+        divergentDevice.init(false);
+        divergentDevice.setOSSR(BMP085::OSSR_HIGH_RES);
+        divergentDevice.readRawTempSync();
+        divergentDevice.readRawPressureSync();
+        divergentDevice.destroy();
+        printf("Divergent driver: %u mismatches\n", replayer.getNumMismatches());
+        passed &= check("divergent mismatches", replayer.getNumMismatches() > 0 ? 1 : 0, 1, 0);
+
+        replayer.destroy();
+    }
+
+    // Recording overhead on the bus path, against the system clock
+    {
+        const uint32_t NUM_READS = 1000000;
+        SimI2C          simBus;
+        SimBMP085       model;
+        simBus.attachDevice(SimBMP085::ADDRESS, &model);
+        simBus.init();
+        I2CRecorder     recorder(&simBus, path);
+        recorder.init();
+
+        struct timespec start, end;
+        uint32_t sum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < NUM_READS; i++)
+            sum += simBus.readReg(SimBMP085::ADDRESS, 0xAA + (i & 0xF));
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double directNs = elapsedNs(start, end) / NUM_READS;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < NUM_READS; i++)
+            sum += recorder.readReg(SimBMP085::ADDRESS, 0xAA + (i & 0xF));
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double recordedNs = elapsedNs(start, end) / NUM_READS;
+        recorder.destroy();
+
+        printf("Register read: %.1fns direct, %.1fns recorded (+%.1fns), %.2f bytes per read (checksum %u)\n",
+               directNs, recordedNs, recordedNs - directNs,
+               ((double) recorder.getNumBytes()) / NUM_READS, sum);
+    }
+
+    unlink(path);
+
+    // A model with no timer finishes the conversion within the write that
+    // starts it, raising EOC, and the handler reads back through the
+    // recorder on the same thread. The nested read is traced after the
+    // write so the trace replays in the driver's order.
+    {
+        SimGPIO         eocGPIO;
+        eocGPIO.init();
+        eocGPIO.setMode(GPIO::INPUT);
+        SimI2C          simBus;
+        SimBMP085       model(NULL, &eocGPIO);
+        simBus.attachDevice(SimBMP085::ADDRESS, &model);
+        I2CRecorder     recorder(&simBus, path);
+        recorder.init();
+
+        struct NestedData nested;
+        nested.m_bus = &recorder;
+        nested.m_numReads = 0;
+        nested.m_value = 0;
+        eocGPIO.attachInterrupt(nestedReadHandler, GPIO::RISING, &nested);
+        eocGPIO.setLevel(0);
+        recorder.writeReg(SimBMP085::ADDRESS, CTRL_REG, TEMPERATURE);
+        eocGPIO.detachInterrupt(nestedReadHandler);
+        recorder.destroy();
+
+        passed &= check("nested reads", nested.m_numReads, 1, 0);
+        passed &= check("nested read value", nested.m_value, (SimBMP085::EXAMPLE_RAW_TEMP >> 8) & 0xFF, 0);
+        passed &= check("nested transactions", recorder.getNumTransactions(), 2, 0);
+
+        I2CReplayer     replayer(path);
+        replayer.init();
+        replayer.writeReg(SimBMP085::ADDRESS, CTRL_REG, TEMPERATURE);
+        passed &= check("nested replay value", replayer.readReg(SimBMP085::ADDRESS, VALUE_MSB_REG),
+                        nested.m_value, 0);
+        passed &= check("nested replay mismatches", replayer.getNumMismatches(), 0, 0);
+        replayer.destroy();
+        unlink(path);
+    }
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    std::vector<Sample>* _samples = static_cast<std::vector<Sample>*>(_data);
+
+    // Virtual time runs the handlers in the test thread
+    Sample sample;
+    sample.m_temp = _temp;
+    sample.m_pressure = _pressure;
+    _samples->push_back(sample);
+}
+
+void nestedReadHandler (void* _data)
+{
+    struct NestedData* _nestedData = static_cast<struct NestedData*>(_data);
+
+    _nestedData->m_numReads++;
+    _nestedData->m_value = _nestedData->m_bus->readReg(SimBMP085::ADDRESS, VALUE_MSB_REG);
+}
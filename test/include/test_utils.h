@@ -0,0 +1,29 @@
+/*
+ * Filename: test_utils.h
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: Header file for helpers shared by the test programs
+ */
+
+#ifndef EMBED_TEST_UTILS_H
+#define EMBED_TEST_UTILS_H
+
+#include <stdio.h>
+#include <time.h>
+
+// Reports _name to stderr and returns false unless _value is within
+// _tolerance of _expected
+bool check (const char* _name, double _value, double _expected, double _tolerance);
+
+// The same within a relative 1e-6 of _expected, for computed values
+bool check (const char* _name, double _value, double _expected);
+
+double elapsedNs (const struct timespec& _start, const struct timespec& _end);
+
+// Monotonic clock time in ms
+double nowMs ();
+
+// Removes the files of a sample log directory, leaving the directory
+void removeLog (const char* _dir);
+
+#endif
@@ -0,0 +1,312 @@
+/*
+ * Filename: sample_bus_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that publishes samples on the shared memory
+ *              sample bus to subscriber processes: a fast one, a slow one
+ *              that gets lapped and one that crashes, then from the BMP085
+ *              driver running against the simulated device to a
+ *              subscriber that compensates them next to a listener that
+ *              unregisters itself, reporting the publish cost and the
+ *              delivery latency.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "bmp085.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "timer_thread.h"
+#include "latency_histogram.h"
+#include "sample_bus_publisher.h"
+#include "sample_bus_subscriber.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const uint32_t NUM_SAMPLES = 200000;
+static const uint32_t CAPACITY = 256;
+static const uint32_t NUM_DEVICE_SAMPLES = 100;
+static const uint64_t SUBSCRIBER_TIMEOUT_US = 5000000;
+
+typedef enum SUBSCRIBER_ENUM
+{
+    FAST = 0,
+    SLOW,
+    CRASHING,
+    SUBSCRIBER_NUM
+} SUBSCRIBER;
+
+static const char* SUBSCRIBER_NAMES[SUBSCRIBER_NUM] = {"fast", "slow", "crashing"};
+
+// The subscriber a one shot listener unregisters itself from
+static SampleBusSubscriber* s_oneShotSubscriber = NULL;
+
+struct DeviceData
+{
+    SampleBusSubscriber*    m_subscriber;
+    BMP085*                 m_compensator;
+    LatencyHistogram        m_latency;
+    uint32_t                m_numSamples;
+    bool                    m_compensated;
+};
+
+pid_t startSubscriber (const char* _name, SUBSCRIBER _type, int32_t _readyFd);
+int32_t runSubscriber (const char* _name, SUBSCRIBER _type, int32_t _readyFd);
+pid_t startDeviceSubscriber (const char* _name, int32_t _readyFd);
+void deviceSampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+void oneShotHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char name[64];
+    snprintf(name, sizeof(name), "embed_sample_bus_test_%d", getpid());
+
+    // Synthetic samples from one process to three others, the sample
+    // number in the pressure and derived from it in the other fields so a
+    // torn copy would show
+    {
+        SampleBusPublisher publisher(name, CAPACITY);
+        if (!publisher.init())
+        {
+            fprintf(stderr, "Error: Initializing sample bus\n");
+            return 1;
+        }
+
+        int32_t readyPipe[2];
+        if (pipe(readyPipe) < 0)
+            return 1;
+
+        pid_t pids[SUBSCRIBER_NUM];
+        for (uint32_t i = 0; i < SUBSCRIBER_NUM; i++)
+            pids[i] = startSubscriber(name, (SUBSCRIBER) i, readyPipe[1]);
+
+        // Start publishing once every subscriber is reading
+        char ready;
+        for (uint32_t i = 0; i < SUBSCRIBER_NUM; i++)
+            passed &= ::read(readyPipe[0], &ready, 1) == 1;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool published = true;
+        for (uint32_t i = 0; i < NUM_SAMPLES; i++)
+            published &= publisher.publish(((uint64_t) i) * 3, (int16_t) (i * 7), i, i & 3);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("Published %u samples at %.0fns each\n", NUM_SAMPLES, elapsedNs(start, end) / NUM_SAMPLES);
+        passed &= check("published", published ? 1 : 0, 1, 0);
+
+        for (uint32_t i = 0; i < SUBSCRIBER_NUM; i++)
+        {
+            int32_t status;
+            waitpid(pids[i], &status, 0);
+            if (i == CRASHING)
+                passed &= check("crashing subscriber killed", WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL, 1, 0);
+            else
+                passed &= check(SUBSCRIBER_NAMES[i], WIFEXITED(status) ? WEXITSTATUS(status) : -1, 0, 0);
+        }
+
+        close(readyPipe[0]);
+        close(readyPipe[1]);
+        publisher.destroy();
+    }
+
+    // The driver publishing at its own pace, fork before any threads
+    {
+        SampleBusPublisher publisher(name);
+        publisher.init();
+
+        int32_t readyPipe[2];
+        if (pipe(readyPipe) < 0)
+            return 1;
+        pid_t pid = startDeviceSubscriber(name, readyPipe[1]);
+        char ready;
+        passed &= ::read(readyPipe[0], &ready, 1) == 1;
+
+        TimerThread timerThread;
+        timerThread.start();
+
+        SimGPIO eocGPIO;
+        eocGPIO.init();
+        eocGPIO.setMode(GPIO::INPUT);
+        SimI2C devBus;
+        SimBMP085 model(&timerThread, &eocGPIO);
+        devBus.init();
+        devBus.attachDevice(SimBMP085::ADDRESS, &model);
+
+        BMP085 device(&devBus, &eocGPIO, NULL, &timerThread);
+        device.setOSSR(BMP085::OSSR_LOW_POWER);
+        if (!device.init(true))
+        {
+            fprintf(stderr, "Error: Initializing BMP085 device\n");
+            kill(pid, SIGKILL);
+            timerThread.end();
+            return 1;
+        }
+        publisher.attach(&device);
+
+        int32_t status;
+        waitpid(pid, &status, 0);
+        passed &= check("device subscriber", WIFEXITED(status) ? WEXITSTATUS(status) : -1, 0, 0);
+
+        publisher.detach();
+        device.destroy();
+        timerThread.end();
+        close(readyPipe[0]);
+        close(readyPipe[1]);
+        publisher.destroy();
+    }
+
+    // Gone with its publisher
+    SampleBusSubscriber missing(name);
+    passed &= check("missing bus fails", missing.init() ? 1 : 0, 0, 0);
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+pid_t startSubscriber (const char* _name, SUBSCRIBER _type, int32_t _readyFd)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int32_t status = runSubscriber(_name, _type, _readyFd);
+        fflush(stdout);
+        _exit(status);
+    }
+
+    return pid;
+}
+
+int32_t runSubscriber (const char* _name, SUBSCRIBER _type, int32_t _readyFd)
+{
+    SampleBusSubscriber subscriber(_name);
+    if (!subscriber.init())
+        return 1;
+
+    char ready = 1;
+    if (write(_readyFd, &ready, 1) != 1)
+        return 1;
+
+    bool intact = true;
+    bool inOrder = true;
+    int64_t last = -1;
+    SampleRecord record;
+    while (subscriber.getNumRead() + subscriber.getNumDropped() < NUM_SAMPLES)
+    {
+        if (!subscriber.wait(&record, SUBSCRIBER_TIMEOUT_US))
+        {
+            fprintf(stderr, "Error: %s subscriber timed out\n", SUBSCRIBER_NAMES[_type]);
+            return 1;
+        }
+
+        int32_t i = record.m_rawPressure;
+        intact &= record.m_timeUs == ((uint64_t) i) * 3 && record.m_rawTemp == (int16_t) (i * 7) &&
+                  record.m_ossr == (i & 3);
+        inOrder &= i > last;
+        last = i;
+
+        if (_type == SLOW)
+            usleep(50);
+        else if (_type == CRASHING && subscriber.getNumRead() == 10)
+            raise(SIGKILL);
+    }
+
+    printf("%s subscriber: %llu read, %llu dropped, publisher %s\n", SUBSCRIBER_NAMES[_type],
+           (unsigned long long) subscriber.getNumRead(), (unsigned long long) subscriber.getNumDropped(),
+           subscriber.isPublisherAlive() ? "alive" : "gone");
+
+    bool passed = true;
+    passed &= check("intact records", intact ? 1 : 0, 1, 0);
+    passed &= check("records in order", inOrder ? 1 : 0, 1, 0);
+    passed &= check("last record", last, NUM_SAMPLES - 1, 0);
+    passed &= check("publisher alive", subscriber.isPublisherAlive() ? 1 : 0, 1, 0);
+    if (_type == SLOW)
+        passed &= check("slow subscriber lapped", subscriber.getNumDropped() > 0 ? 1 : 0, 1, 0);
+
+    return passed ? 0 : 1;
+}
+
+pid_t startDeviceSubscriber (const char* _name, int32_t _readyFd)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+
+    SampleBusSubscriber subscriber(_name);
+    if (!subscriber.init())
+        _exit(1);
+
+    BMP085 compensator(NULL);
+    struct DeviceData data;
+    data.m_subscriber = &subscriber;
+    data.m_compensator = &compensator;
+    data.m_numSamples = 0;
+    data.m_compensated = true;
+    subscriber.registerListener(deviceSampleHandler, &data);
+
+    // A listener unregistering itself from its callback is called once
+    uint32_t oneShotCalls = 0;
+    s_oneShotSubscriber = &subscriber;
+    subscriber.registerListener(oneShotHandler, &oneShotCalls);
+
+    char ready = 1;
+    if (write(_readyFd, &ready, 1) != 1)
+        _exit(1);
+
+    subscriber.run();
+
+    LatencyHistogram::Summary latency;
+    data.m_latency.getSummary(&latency);
+    printf("Device subscriber: %u samples, %llu dropped, latency p50 %uus p99 %uus max %uus\n",
+           data.m_numSamples, (unsigned long long) subscriber.getNumDropped(), latency.m_p50Us,
+           latency.m_p99Us, latency.m_maxUs);
+
+    bool passed = true;
+    passed &= check("device samples", data.m_numSamples, NUM_DEVICE_SAMPLES, 0);
+    passed &= check("device samples dropped", subscriber.getNumDropped(), 0, 0);
+    passed &= check("compensated", data.m_compensated ? 1 : 0, 1, 0);
+    passed &= check("one shot calls", oneShotCalls, 1, 0);
+
+    fflush(stdout);
+    _exit(passed ? 0 : 1);
+}
+
+void deviceSampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    struct DeviceData* _deviceData = static_cast<struct DeviceData*>(_data);
+    SampleBusSubscriber* subscriber = _deviceData->m_subscriber;
+
+    // Both processes read the same monotonic clock
+    _deviceData->m_latency.addValue(SystemClock::Instance()->nowUs() - subscriber->getSampleTimeUs());
+
+    BMP085::Calibration calibration;
+    if (subscriber->getCalibration(&calibration))
+    {
+        double tempC, pressurehPa;
+        _deviceData->m_compensator->setCalibration(calibration);
+        _deviceData->m_compensator->calcTempPressure(_temp, _pressure, subscriber->getSampleOSSR(),
+                                                     &tempC, &pressurehPa);
+        _deviceData->m_compensated &= fabs(tempC - 15.0) < 0.001 && fabs(pressurehPa - 699.64) < 0.03;
+    }
+    else
+        _deviceData->m_compensated = false;
+
+    if (++_deviceData->m_numSamples == NUM_DEVICE_SAMPLES)
+        subscriber->stop();
+}
+
+void oneShotHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    (*static_cast<uint32_t*>(_data))++;
+    s_oneShotSubscriber->unregisterListener(oneShotHandler);
+}
@@ -0,0 +1,260 @@
+/*
+ * Filename: sample_block_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that encodes a day of simulated BMP085
+ *              samples to a compressed sample archive, checks that they
+ *              decode exactly, also across a clock reset within a block,
+ *              that time range queries skip blocks and a corrupt block
+ *              header is not indexed, and reports the compression reached
+ *              and the decode rate.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "sample_block_encoder.h"
+#include "sample_block_decoder.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+// A day at the high resolution sample period
+static const uint32_t SAMPLE_PERIOD_US = 12000;
+static const uint32_t NUM_SAMPLES = 24 * 3600 / 12 * 1000;
+// Second run appended after a restart, the clock starting over
+static const uint32_t NUM_RESTART_SAMPLES = 100000;
+
+void generate (std::vector<SampleRecord>* _records, const uint32_t _num, const uint64_t _startUs, uint32_t _seed);
+bool sameRecords (const SampleRecord* _a, const SampleRecord* _b, const size_t _num);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char path[] = "/tmp/sample_block_test_XXXXXX";
+    int32_t fd = mkstemp(path);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Error: Creating archive\n");
+        return 1;
+    }
+    close(fd);
+    unlink(path);
+
+    std::vector<SampleRecord> records;
+    generate(&records, NUM_SAMPLES, 5000000, 1);
+
+    BMP085::Calibration calibration = {408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868};
+    struct timespec start, end;
+    {
+        SampleBlockEncoder encoder(path);
+        if (!encoder.init())
+        {
+            fprintf(stderr, "Error: Initializing encoder\n");
+            return 1;
+        }
+        encoder.setCalibration(calibration);
+        encoder.setWallOffsetUs(1792000000000000LL);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < records.size(); i++)
+            encoder.append(records[i]);
+        encoder.destroy();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double bytesPerSample = ((double) encoder.getNumBytes()) / encoder.getNumSamples();
+        printf("Encoded %llu samples in %llu blocks, %.2f bytes per sample, %.1fx smaller than records, "
+               "%.1fns per sample\n", (unsigned long long) encoder.getNumSamples(),
+               (unsigned long long) encoder.getNumBlocks(), bytesPerSample, sizeof(SampleRecord) / bytesPerSample,
+               elapsedNs(start, end) / encoder.getNumSamples());
+        // A byte or two per column
+        passed &= check("bytes per sample", bytesPerSample < 6.0 ? 1 : 0, 1, 0);
+    }
+
+    // Append a second run after a restart
+    std::vector<SampleRecord> restart;
+    generate(&restart, NUM_RESTART_SAMPLES, 1000000, 2);
+    {
+        SampleBlockEncoder encoder(path, 512);
+        encoder.init();
+        for (uint32_t i = 0; i < restart.size(); i++)
+            encoder.append(restart[i]);
+        encoder.destroy();
+    }
+
+    SampleBlockDecoder decoder(path);
+    if (!decoder.init())
+    {
+        fprintf(stderr, "Error: Initializing decoder\n");
+        return 1;
+    }
+    passed &= check("samples in archive", decoder.getNumSamples(), NUM_SAMPLES + NUM_RESTART_SAMPLES, 0);
+
+    // Everything decodes exactly, best of a few passes for the rate
+    std::vector<SampleRecord> decoded(decoder.getNumSamples());
+    double bestNs = 0.0;
+    bool exact = true;
+    for (uint32_t pass = 0; pass < 3; pass++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t num = 0;
+        for (uint32_t i = 0; i < decoder.getNumBlocks(); i++)
+        {
+            exact &= decoder.decodeBlock(i, &decoded[num]);
+            num += decoder.getBlockHeader(i).m_numSamples;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (pass == 0 || elapsedNs(start, end) < bestNs)
+            bestNs = elapsedNs(start, end);
+    }
+    exact &= sameRecords(&decoded[0], &records[0], NUM_SAMPLES);
+    exact &= sameRecords(&decoded[NUM_SAMPLES], &restart[0], NUM_RESTART_SAMPLES);
+    passed &= check("decoded exactly", exact ? 1 : 0, 1, 0);
+    printf("Decoded %u blocks at %.1fM samples/s, %.0f MB/s of records\n", decoder.getNumBlocks(),
+           decoded.size() * 1e3 / bestNs, decoded.size() * sizeof(SampleRecord) * 1e3 / bestNs);
+
+    // Headers carry the index and calibration
+    const SampleBlockHeader& first = decoder.getBlockHeader(0);
+    passed &= check("first block time", first.m_baseTimeUs, records[0].m_timeUs, 0);
+    passed &= check("first block minimum time", first.m_minTimeUs, records[0].m_timeUs, 0);
+    passed &= check("calibration kept", first.m_hasCalibration && first.m_calibration.m_MC == -8711 ? 1 : 0, 1, 0);
+    passed &= check("wall offset kept", first.m_wallOffsetUs, 1792000000000000LL, 0);
+    int32_t minPressure = records[0].m_rawPressure;
+    for (uint32_t i = 0; i < first.m_numSamples; i++)
+        minPressure = records[i].m_rawPressure < minPressure ? records[i].m_rawPressure : minPressure;
+    passed &= check("block minimum pressure", first.m_minPressure, minPressure, 0);
+
+    // An hour in the middle of the day decodes only the blocks it
+    // touches, and samples from the second run in the same clock range
+    // are found too
+    uint64_t queryStartUs = records[NUM_SAMPLES / 2].m_timeUs;
+    uint64_t queryEndUs = queryStartUs + 3600ULL * 1000000;
+    std::vector<SampleRecord> result;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t numDecoded = decoder.query(queryStartUs, queryEndUs, &result);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t expected = 0;
+    for (uint32_t i = 0; i < records.size(); i++)
+        expected += records[i].m_timeUs >= queryStartUs && records[i].m_timeUs < queryEndUs ? 1 : 0;
+    printf("Hour query: %zu samples from %u of %u blocks in %.0fus\n", result.size(), numDecoded,
+           decoder.getNumBlocks(), elapsedNs(start, end) / 1000.0);
+    passed &= check("query samples", result.size(), expected, 0);
+    passed &= check("query blocks", numDecoded, (expected + 1023) / 1024, 1);
+
+    // The second run's clock range overlaps the start of the first
+    uint64_t restartEndUs = restart.back().m_timeUs + 1;
+    expected = NUM_RESTART_SAMPLES;
+    for (uint32_t i = 0; i < records.size() && records[i].m_timeUs < restartEndUs; i++)
+        expected++;
+    result.clear();
+    decoder.query(0, restartEndUs, &result);
+    passed &= check("query across runs", result.size(), expected, 0);
+    decoder.destroy();
+
+    // A block cut short by a crash is ignored
+    struct stat st;
+    stat(path, &st);
+    if (truncate(path, st.st_size - 10) == 0)
+    {
+        SampleBlockDecoder truncated(path);
+        truncated.init();
+        passed &= check("truncated archive", truncated.getNumSamples(),
+                        NUM_SAMPLES + NUM_RESTART_SAMPLES - NUM_RESTART_SAMPLES % 512, 0);
+    }
+    unlink(path);
+
+    // The clock resetting inside a block, its index covers the samples
+    // after the reset and the times still decode from the first sample
+    const uint64_t resetTimesUs[] = {5000, 6000, 7000, 100, 1100, 2100};
+    const uint32_t numReset = sizeof(resetTimesUs) / sizeof(resetTimesUs[0]);
+    std::vector<SampleRecord> reset;
+    generate(&reset, numReset, 0, 3);
+    for (uint32_t i = 0; i < numReset; i++)
+        reset[i].m_timeUs = resetTimesUs[i];
+    {
+        SampleBlockEncoder encoder(path);
+        encoder.init();
+        for (uint32_t i = 0; i < numReset; i++)
+            encoder.append(reset[i]);
+        encoder.destroy();
+    }
+
+    SampleBlockDecoder resetDecoder(path);
+    resetDecoder.init();
+    std::vector<SampleRecord> resetDecoded(numReset);
+    bool resetExact = resetDecoder.getNumBlocks() == 1 && resetDecoder.decodeBlock(0, &resetDecoded[0]) &&
+                      sameRecords(&resetDecoded[0], &reset[0], numReset);
+    passed &= check("reset block decoded exactly", resetExact ? 1 : 0, 1, 0);
+    if (resetDecoder.getNumBlocks() == 1)
+    {
+        const SampleBlockHeader& header = resetDecoder.getBlockHeader(0);
+        passed &= check("reset block base time", header.m_baseTimeUs, 5000, 0);
+        passed &= check("reset block minimum time", header.m_minTimeUs, 100, 0);
+        passed &= check("reset block maximum time", header.m_maxTimeUs, 7000, 0);
+    }
+    result.clear();
+    resetDecoder.query(0, 2000, &result);
+    passed &= check("query after reset", result.size(), 2, 0);
+    resetDecoder.destroy();
+
+    // A header claiming more samples than its block could hold is not
+    // indexed, rather than sizing the decode buffer from it
+    uint32_t corruptNumSamples = 0xFFFFFFFF;
+    fd = open(path, O_WRONLY);
+    if (fd >= 0 && pwrite(fd, &corruptNumSamples, sizeof(corruptNumSamples), SAMPLE_BLOCK_FILE_HEADER_SIZE) ==
+                   (ssize_t) sizeof(corruptNumSamples))
+    {
+        SampleBlockDecoder corruptDecoder(path);
+        passed &= check("corrupt archive opened", corruptDecoder.init() ? 1 : 0, 1, 0);
+        passed &= check("corrupt block skipped", corruptDecoder.getNumBlocks(), 0, 0);
+        corruptDecoder.destroy();
+    }
+    else
+        passed = false;
+    if (fd >= 0)
+        close(fd);
+    unlink(path);
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// Samples a period apart with scheduling jitter, pressure wandering with
+// the weather and sensor noise, temperature following the day, and a
+// change of OSSR setting part way through
+void generate (std::vector<SampleRecord>* _records, const uint32_t _num, const uint64_t _startUs, uint32_t _seed)
+{
+    srand(_seed);
+    _records->resize(_num);
+
+    uint64_t timeUs = _startUs;
+    double pressure = 23843.0;
+    for (uint32_t i = 0; i < _num; i++)
+    {
+        SampleRecord& record = (*_records)[i];
+        timeUs += SAMPLE_PERIOD_US + rand() % 200;
+        pressure += ((rand() % 1001) - 500) / 5000.0;
+
+        record.m_timeUs = timeUs;
+        record.m_rawPressure = (int32_t) pressure + rand() % 5 - 2;
+        record.m_rawTemp = (int16_t) (27898 + 300 * sin(timeUs / (86400e6 / (2 * M_PI))));
+        record.m_ossr = i < _num / 3 ? BMP085::OSSR_LOW_POWER : BMP085::OSSR_HIGH_RES;
+        record.m_reserved = 0;
+    }
+}
+
+bool sameRecords (const SampleRecord* _a, const SampleRecord* _b, const size_t _num)
+{
+    for (size_t i = 0; i < _num; i++)
+    {
+        if (_a[i].m_timeUs != _b[i].m_timeUs || _a[i].m_rawPressure != _b[i].m_rawPressure ||
+            _a[i].m_rawTemp != _b[i].m_rawTemp || _a[i].m_ossr != _b[i].m_ossr)
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,212 @@
+/*
+ * Filename: sample_log_replay_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that writes a sample log, replays it to a
+ *              listener that compensates each sample and filters its
+ *              altitude, at the recorded pace and faster on virtual time,
+ *              on the system clock and as fast as possible, checks a
+ *              listener can unregister itself from its callback, and
+ *              reports the dispatch rates reached.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "bmp085.h"
+#include "kalman_filter.h"
+#include "virtual_clock.h"
+#include "sample_log_writer.h"
+#include "sample_log_replayer.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const uint32_t NUM_SAMPLES = 20000;
+static const uint32_t SAMPLE_PERIOD_US = 12000;
+static const uint32_t RECORDS_PER_SEGMENT = 4096;
+// The second half of the log is written an hour after the first
+static const uint64_t RUN_GAP_US = 3600ULL * 1000000;
+
+// The replayer a one shot listener unregisters itself from
+static SampleLogReplayer* s_oneShotReplayer = NULL;
+
+struct ListenerData
+{
+    SampleLogReplayer*  m_replayer;
+    BMP085*             m_compensator;
+    KalmanFilter<double>*   m_filter;
+    uint64_t            m_numSamples;
+    uint64_t            m_lastTimeUs;
+    bool                m_inOrder;
+    bool                m_compensated;
+    uint64_t            m_stopAfter;
+};
+
+void listener (const int16_t _temp, const int32_t _pressure, void* _data);
+void oneShotListener (const int16_t _temp, const int32_t _pressure, void* _data);
+void resetData (struct ListenerData* _data);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char dir[] = "/tmp/sample_log_replay_test_XXXXXX";
+    if (mkdtemp(dir) == NULL)
+    {
+        fprintf(stderr, "Error: Creating log directory\n");
+        return 1;
+    }
+
+    // Datasheet example values, pressure changing a little so the filter
+    // has something to do
+    BMP085::Calibration calibration = {408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868};
+    {
+        SampleLogWriter writer(dir, "baro", RECORDS_PER_SEGMENT);
+        writer.init();
+        writer.setCalibration(calibration);
+        for (uint32_t i = 0; i < NUM_SAMPLES; i++)
+        {
+            uint64_t timeUs = ((uint64_t) i) * SAMPLE_PERIOD_US + (i >= NUM_SAMPLES / 2 ? RUN_GAP_US : 0);
+            writer.append(timeUs, 27898, 23843 + (i % 64) - 32, BMP085::OSSR_LOW_POWER);
+        }
+        writer.destroy();
+    }
+    // Recorded time less the skipped gap
+    uint64_t replayUs = ((uint64_t) NUM_SAMPLES - 2) * SAMPLE_PERIOD_US;
+
+    BMP085 compensator(NULL);
+    KalmanFilter<double> filter(SAMPLE_PERIOD_US / 1e6, 0.5, 1.0);
+    struct ListenerData data;
+    data.m_compensator = &compensator;
+    data.m_filter = &filter;
+
+    // Recorded pace and ten times faster on virtual time
+    double speeds[] = {1.0, 10.0};
+    for (uint32_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+    {
+        VirtualClock clock;
+        SampleLogReplayer replayer(dir, "baro", &clock);
+        replayer.setSpeed(speeds[i]);
+        replayer.registerListener(listener, &data);
+        data.m_replayer = &replayer;
+        resetData(&data);
+
+        if (!replayer.run())
+        {
+            fprintf(stderr, "Error: Replaying sample log\n");
+            return 1;
+        }
+
+        printf("%.0fx on virtual time: %llu samples in %.1fs virtual, %.0f samples/s dispatched, "
+               "listener could sustain %.0f samples/s\n", speeds[i], (unsigned long long) replayer.getNumDispatched(),
+               clock.nowUs() / 1e6, replayer.getDispatchRate(), replayer.getListenerRate());
+        passed &= check("samples dispatched", replayer.getNumDispatched(), NUM_SAMPLES, 0);
+        passed &= check("samples received", data.m_numSamples, NUM_SAMPLES, 0);
+        passed &= check("virtual replay time", clock.nowUs(), replayUs / speeds[i], 1);
+        passed &= check("gaps skipped", replayer.getNumGapsSkipped(), 1, 0);
+        passed &= check("lag on virtual time", replayer.getMaxLagUs(), 0, 0);
+        passed &= check("timestamps in order", data.m_inOrder ? 1 : 0, 1, 0);
+        passed &= check("compensated", data.m_compensated ? 1 : 0, 1, 0);
+    }
+
+    // 200 times faster on the system clock, the first 1000 samples are
+    // 12s recorded and should take 60ms
+    {
+        SampleLogReplayer replayer(dir, "baro");
+        replayer.setSpeed(200.0);
+        replayer.registerListener(listener, &data);
+        data.m_replayer = &replayer;
+        resetData(&data);
+        data.m_stopAfter = 1000;
+
+        uint64_t startUs = SystemClock::Instance()->nowUs();
+        replayer.run();
+        double elapsedMs = (SystemClock::Instance()->nowUs() - startUs) / 1000.0;
+
+        printf("200x on the system clock: %llu samples in %.1fms, max lag %lluus\n",
+               (unsigned long long) replayer.getNumDispatched(), elapsedMs,
+               (unsigned long long) replayer.getMaxLagUs());
+        passed &= check("stopped after", replayer.getNumDispatched(), 1000, 0);
+        passed &= check("paced time", elapsedMs, 999 * SAMPLE_PERIOD_US / 200 / 1000.0, 10.0);
+    }
+
+    // As fast as possible, the rate the listener sustains
+    {
+        SampleLogReplayer replayer(dir, "baro");
+        replayer.setSpeed(SampleLogReplayer::AS_FAST_AS_POSSIBLE);
+        replayer.registerListener(listener, &data);
+        data.m_replayer = &replayer;
+        resetData(&data);
+
+        // A listener ported from a BMP085 consumer that unregisters itself
+        // from its callback is called once
+        uint32_t oneShotCalls = 0;
+        s_oneShotReplayer = &replayer;
+        replayer.registerListener(oneShotListener, &oneShotCalls);
+
+        replayer.run();
+        printf("As fast as possible: %llu samples at %.0f samples/s, listener could sustain %.0f samples/s\n",
+               (unsigned long long) replayer.getNumDispatched(), replayer.getDispatchRate(),
+               replayer.getListenerRate());
+        passed &= check("samples dispatched", replayer.getNumDispatched(), NUM_SAMPLES, 0);
+        passed &= check("gaps skipped", replayer.getNumGapsSkipped(), 0, 0);
+        passed &= check("one shot calls", oneShotCalls, 1, 0);
+        passed &= check("samples after one shot", data.m_numSamples, NUM_SAMPLES, 0);
+        // Far faster than the device could ever sample
+        passed &= check("faster than recorded", replayer.getDispatchRate() > 100.0 * 1e6 / SAMPLE_PERIOD_US ? 1 : 0, 1, 0);
+    }
+
+    removeLog(dir);
+    rmdir(dir);
+
+    // A missing log is reported
+    SampleLogReplayer missing("/nonexistent", "baro");
+    passed &= check("missing log fails", missing.run() ? 1 : 0, 0, 0);
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void listener (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    struct ListenerData* _listenerData = static_cast<struct ListenerData*>(_data);
+    SampleLogReplayer* replayer = _listenerData->m_replayer;
+
+    uint64_t timeUs = replayer->getSampleTimeUs();
+    _listenerData->m_inOrder &= _listenerData->m_numSamples == 0 || timeUs > _listenerData->m_lastTimeUs;
+    _listenerData->m_lastTimeUs = timeUs;
+
+    BMP085::Calibration calibration;
+    if (replayer->getCalibration(&calibration))
+        _listenerData->m_compensator->setCalibration(calibration);
+    else
+        _listenerData->m_compensated = false;
+
+    double tempC, pressurehPa, altM;
+    _listenerData->m_compensator->calcTempPressure(_temp, _pressure, replayer->getSampleOSSR(),
+                                                   &tempC, &pressurehPa);
+    _listenerData->m_compensator->calcApproxAlt(pressurehPa, &altM);
+    _listenerData->m_filter->addValue(altM);
+    _listenerData->m_compensated &= fabs(tempC - 15.0) < 0.001 && fabs(pressurehPa - 699.64) < 2.0;
+
+    if (++_listenerData->m_numSamples == _listenerData->m_stopAfter)
+        replayer->stop();
+}
+
+void oneShotListener (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    (*static_cast<uint32_t*>(_data))++;
+    s_oneShotReplayer->unregisterListener(oneShotListener);
+}
+
+void resetData (struct ListenerData* _data)
+{
+    _data->m_filter->reset();
+    _data->m_numSamples = 0;
+    _data->m_lastTimeUs = 0;
+    _data->m_inOrder = true;
+    _data->m_compensated = true;
+    _data->m_stopAfter = 0;
+}
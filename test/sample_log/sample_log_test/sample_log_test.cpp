@@ -0,0 +1,305 @@
+/*
+ * Filename: sample_log_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that logs the BMP085 driver's samples from
+ *              the simulated device to a memory-mapped sample log, reads
+ *              them back, follows the log from a second thread while it is
+ *              written, times the appends that rotate segments, and
+ *              compares the cost of logging a sample against formatting
+ *              it as text.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+
+#include "bmp085.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "virtual_clock.h"
+#include "sample_log_writer.h"
+#include "sample_log_reader.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const uint32_t RECORDS_PER_SEGMENT = 1000;
+static const uint32_t NUM_FOLLOWED = 200000;
+static const uint32_t NUM_ROTATIONS = 20;
+
+struct FollowData
+{
+    const char*     m_dir;
+    uint64_t        m_numRead;
+    bool            m_inOrder;
+};
+
+void* followLog (void* _data);
+uint32_t countTemporary (const char* _dir);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char dir[] = "/tmp/sample_log_test_XXXXXX";
+    if (mkdtemp(dir) == NULL)
+    {
+        fprintf(stderr, "Error: Creating log directory\n");
+        return 1;
+    }
+
+    // A minute of async samples on virtual time, rotating every 1000
+    uint64_t numLogged;
+    {
+        VirtualClock    clock;
+        SimGPIO         eocGPIO;
+        eocGPIO.init();
+        eocGPIO.setMode(GPIO::INPUT);
+
+        SimI2C          simBus;
+        SimBMP085       model(&clock, &eocGPIO);
+        if (!simBus.init())
+        {
+            fprintf(stderr, "Error: Initializing simulated I2C bus\n");
+            return 1;
+        }
+        simBus.attachDevice(SimBMP085::ADDRESS, &model);
+
+        BMP085 device(&simBus, &eocGPIO, NULL, &clock, &clock);
+        device.setOSSR(BMP085::OSSR_HIGH_RES);
+        if (!device.init(true))
+        {
+            fprintf(stderr, "Error: Initializing BMP085 device\n");
+            return 1;
+        }
+
+        SampleLogWriter writer(dir, "baro", RECORDS_PER_SEGMENT, &clock);
+        if (!writer.init())
+        {
+            fprintf(stderr, "Error: Initializing sample log\n");
+            return 1;
+        }
+        writer.attach(&device);
+        clock.sleepUs(60 * 1000000);
+        writer.detach();
+        device.destroy();
+
+        numLogged = writer.getNumRecords();
+        writer.destroy();
+    }
+
+    SampleLogReader reader(dir, "baro");
+    reader.refresh();
+    uint64_t numRead = 0;
+    uint32_t numSealed = 0;
+    uint64_t lastTimeUs = 0;
+    bool inOrder = true;
+    bool compensated = true;
+    BMP085 compensator(NULL);
+    for (uint32_t i = 0; i < reader.getNumSegments(); i++)
+    {
+        if (!reader.openSegment(i))
+        {
+            passed = false;
+            continue;
+        }
+
+        numSealed += reader.isSealed() ? 1 : 0;
+        compensator.setCalibration(reader.getHeader()->m_calibration);
+
+        uint64_t num;
+        const SampleRecord* records = reader.getRecords(&num);
+        for (uint64_t j = 0; j < num; j++)
+        {
+            inOrder &= numRead == 0 || records[j].m_timeUs > lastTimeUs;
+            lastTimeUs = records[j].m_timeUs;
+
+            double tempC, pressurehPa;
+            compensator.calcTempPressure(records[j].m_rawTemp, records[j].m_rawPressure,
+                                         (BMP085::OSSR_SETTING) records[j].m_ossr, &tempC, &pressurehPa);
+            compensated &= fabs(tempC - 15.0) < 0.001 && fabs(pressurehPa - 699.64) < 0.03;
+            numRead++;
+        }
+    }
+    reader.closeSegment();
+
+    printf("Logged %llu samples, read %llu from %u segments (%u sealed)\n", (unsigned long long) numLogged,
+           (unsigned long long) numRead, reader.getNumSegments(), numSealed);
+    passed &= check("samples logged", numLogged, 60 * 1000000 / (SimBMP085::getConversionTimeUs(0x2E) +
+                                                                   SimBMP085::getConversionTimeUs(0xB4)), 1);
+    passed &= check("samples read", numRead, numLogged, 0);
+    passed &= check("segments", reader.getNumSegments(), (numLogged + RECORDS_PER_SEGMENT - 1) / RECORDS_PER_SEGMENT, 0);
+    passed &= check("sealed segments", numSealed, reader.getNumSegments(), 0);
+    passed &= check("timestamps in order", inOrder ? 1 : 0, 1, 0);
+    passed &= check("compensated from the log", compensated ? 1 : 0, 1, 0);
+
+    // A new writer starts after the existing segments
+    {
+        SampleLogWriter writer(dir, "baro", RECORDS_PER_SEGMENT);
+        writer.init();
+        passed &= check("restart sequence", writer.getSequence(), reader.getSegmentSequence(reader.getNumSegments() - 1) + 1, 0);
+        writer.destroy();
+    }
+    passed &= check("spare segments removed", countTemporary(dir), 0, 0);
+    removeLog(dir);
+
+    // Rotating takes the segment the writer's thread prepared, so the
+    // append that fills a segment costs about the same as any other
+    {
+        SampleLogWriter writer(dir, "rotate", RECORDS_PER_SEGMENT);
+        writer.init();
+
+        double maxRotateNs = 0.0;
+        struct timespec start, end;
+        for (uint32_t i = 0; i < NUM_ROTATIONS * RECORDS_PER_SEGMENT; i++)
+        {
+            // Give the thread time to have the next segment ready
+            bool rotating = i > 0 && i % RECORDS_PER_SEGMENT == 0;
+            if (rotating)
+                usleep(10000);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            writer.append(i, 0, i, 0);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            if (rotating)
+                maxRotateNs = fmax(maxRotateNs, elapsedNs(start, end));
+        }
+        writer.destroy();
+
+        printf("Slowest rotating append: %.1fus\n", maxRotateNs / 1000.0);
+    }
+    removeLog(dir);
+
+    // Follow the log from another thread while it is written, the raw
+    // pressure carries the record number
+    {
+        SampleLogWriter writer(dir, "follow", RECORDS_PER_SEGMENT);
+        writer.init();
+
+        struct FollowData followData;
+        followData.m_dir = dir;
+        followData.m_numRead = 0;
+        followData.m_inOrder = true;
+        pthread_t followThread;
+        pthread_create(&followThread, NULL, followLog, &followData);
+
+        for (uint32_t i = 0; i < NUM_FOLLOWED; i++)
+            writer.append(i, 0, i, 0);
+        writer.destroy();
+        pthread_join(followThread, NULL);
+
+        printf("Follower read %llu of %u records while they were written\n",
+               (unsigned long long) followData.m_numRead, NUM_FOLLOWED);
+        passed &= check("followed records", followData.m_numRead, NUM_FOLLOWED, 0);
+        passed &= check("followed in order", followData.m_inOrder ? 1 : 0, 1, 0);
+    }
+    removeLog(dir);
+
+    // Logging cost per sample against formatting text to a file
+    {
+        const uint32_t NUM_SAMPLES = 1000000;
+        SampleLogWriter writer(dir, "bench", 64 * 1024);
+        writer.init();
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < NUM_SAMPLES; i++)
+            writer.append(27898, 23843 + (i & 0xFF), 1);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double logNs = elapsedNs(start, end) / NUM_SAMPLES;
+        writer.destroy();
+
+        std::string textPath = std::string(dir) + "/bench.txt";
+        FILE* text = fopen(textPath.c_str(), "w");
+        BMP085 compensator(NULL);
+        BMP085::Calibration calibration = {408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868};
+        compensator.setCalibration(calibration);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < NUM_SAMPLES; i++)
+        {
+            double tempC, pressurehPa;
+            compensator.calcTempPressure(27898, 23843 + (i & 0xFF), BMP085::OSSR_STANDARD, &tempC, &pressurehPa);
+            fprintf(text, "%llu %.1fC %.2fhPa\n", (unsigned long long) SystemClock::Instance()->nowUs(),
+                    tempC, pressurehPa);
+            fflush(text);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double textNs = elapsedNs(start, end) / NUM_SAMPLES;
+        fclose(text);
+        unlink(textPath.c_str());
+
+        printf("Per sample: %.1fns logged, %.1fns formatted and written as text\n", logNs, textNs);
+    }
+    removeLog(dir);
+    rmdir(dir);
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void* followLog (void* _data)
+{
+    struct FollowData* _followData = static_cast<struct FollowData*>(_data);
+
+    SampleLogReader reader(_followData->m_dir, "follow");
+    uint32_t segment = 0;
+    uint64_t position = 0;
+    while (_followData->m_numRead < NUM_FOLLOWED)
+    {
+        // Wait for the segment to appear
+        reader.refresh();
+        if (segment >= reader.getNumSegments() || !reader.openSegment(segment))
+        {
+            usleep(100);
+            continue;
+        }
+
+        while (true)
+        {
+            // Check the seal before the count, so a sealed segment's count
+            // is final
+            bool sealed = reader.isSealed();
+            uint64_t num;
+            const SampleRecord* records = reader.getRecords(&num);
+            for (; position < num; position++)
+            {
+                _followData->m_inOrder &= records[position].m_rawPressure == (int32_t) _followData->m_numRead;
+                _followData->m_numRead++;
+            }
+
+            if (sealed || _followData->m_numRead >= NUM_FOLLOWED)
+                break;
+            usleep(100);
+        }
+
+        segment++;
+        position = 0;
+    }
+    reader.closeSegment();
+
+    return NULL;
+}
+
+// Files left under their temporary name
+uint32_t countTemporary (const char* _dir)
+{
+    DIR* dir = opendir(_dir);
+    if (dir == NULL)
+        return 0;
+
+    uint32_t num = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t len = strlen(entry->d_name);
+        if (len > 4 && strcmp(entry->d_name + len - 4, ".tmp") == 0)
+            num++;
+    }
+    closedir(dir);
+
+    return num;
+}
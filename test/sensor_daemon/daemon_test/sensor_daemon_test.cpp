@@ -0,0 +1,322 @@
+/*
+ * Filename: sensor_daemon_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program that runs the sensor daemon over the
+ *              simulated bus and BMP085, with several clients subscribing
+ *              at different OSSR settings while another runs batches of
+ *              register accesses, checking the subscriptions share one
+ *              sampling stream, a client subscribing again at a lower
+ *              setting lowers it, a client sending garbage is dropped and
+ *              a subscription the device cannot start is refused.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "bmp085.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "timer_thread.h"
+#include "locked_i2c.h"
+#include "sensor_daemon.h"
+#include "sensor_client.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const uint32_t NUM_CLIENTS = 4;
+static const uint32_t NUM_CLIENT_SAMPLES = 40;
+static const uint32_t NUM_BATCHES = 500;
+static const uint64_t SAMPLE_TIMEOUT_US = 1000000;
+static const uint64_t STOP_TIMEOUT_US = 1000000;
+static const uint32_t MAX_EARLY_SAMPLES = 2;
+
+static const uint8_t CHIP_ID_REG = 0xD0;
+static const uint8_t CHIP_ID = 0x55;
+static const uint8_t CALIBRATION_REG = 0xAA;
+static const uint32_t CALIBRATION_LEN = 22;
+
+struct ClientData
+{
+    const char*             m_path;
+    BMP085::OSSR_SETTING    m_ossr;
+    uint32_t                m_numSamples;
+    uint32_t                m_numEarly;
+    uint64_t                m_numDropped;
+    bool                    m_compensated;
+    bool                    m_passed;
+};
+
+struct BatchData
+{
+    const char*             m_path;
+    BMP085::Calibration     m_calibration;
+    uint32_t                m_numBatches;
+    bool                    m_passed;
+};
+
+void* clientThread (void* _data);
+void* batchThread (void* _data);
+bool sendGarbage (const char* _path);
+bool subscribeFails (const char* _path, LockedI2C* _bus, TimerThread* _timerThread);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/embed_sensor_daemon_test_%d", getpid());
+
+    TimerThread timerThread;
+    timerThread.start();
+
+    SimGPIO eocGPIO;
+    eocGPIO.init();
+    eocGPIO.setMode(GPIO::INPUT);
+    SimI2C devBus;
+    SimBMP085 model(&timerThread, &eocGPIO);
+    devBus.init();
+    devBus.attachDevice(SimBMP085::ADDRESS, &model);
+
+    LockedI2C lockedBus(&devBus);
+    BMP085 device(&lockedBus, &eocGPIO, NULL, &timerThread);
+    device.setOSSR(BMP085::OSSR_LOW_POWER);
+
+    SensorDaemon daemon(path, &lockedBus, &device);
+    if (!daemon.init())
+    {
+        fprintf(stderr, "Error: Initializing sensor daemon\n");
+        timerThread.end();
+        return 1;
+    }
+
+    // Subscribing holds the stream open while the others come and go
+    SensorClient holder(path);
+    passed &= check("holder connected", holder.init() ? 1 : 0, 1, 0);
+    passed &= check("holder subscribed", holder.subscribe(BMP085::OSSR_LOW_POWER) ? 1 : 0, 1, 0);
+    passed &= check("streaming", daemon.isStreaming() ? 1 : 0, 1, 0);
+
+    // Clients at different settings next to a client using the bus
+    struct ClientData clients[NUM_CLIENTS];
+    pthread_t clientThreads[NUM_CLIENTS];
+    for (uint32_t i = 0; i < NUM_CLIENTS; i++)
+    {
+        clients[i].m_path = path;
+        clients[i].m_ossr = i + 1 < NUM_CLIENTS ? BMP085::OSSR_STANDARD : BMP085::OSSR_HIGH_RES;
+        pthread_create(&clientThreads[i], NULL, clientThread, &clients[i]);
+    }
+
+    struct BatchData batch;
+    batch.m_path = path;
+    device.getCalibration(&batch.m_calibration);
+    pthread_t batchThreadId;
+    pthread_create(&batchThreadId, NULL, batchThread, &batch);
+
+    for (uint32_t i = 0; i < NUM_CLIENTS; i++)
+    {
+        pthread_join(clientThreads[i], NULL);
+        printf("Client %u: %u samples at OSSR %u or above, %u before, %llu dropped\n", i,
+               clients[i].m_numSamples, clients[i].m_ossr, clients[i].m_numEarly,
+               (unsigned long long) clients[i].m_numDropped);
+        passed &= clients[i].m_passed;
+        passed &= check("client samples", clients[i].m_numSamples, NUM_CLIENT_SAMPLES, 0);
+        passed &= check("client early samples", clients[i].m_numEarly <= MAX_EARLY_SAMPLES ? 1 : 0, 1, 0);
+        passed &= check("client compensated", clients[i].m_compensated ? 1 : 0, 1, 0);
+    }
+    pthread_join(batchThreadId, NULL);
+    printf("Batch client: %u batches\n", batch.m_numBatches);
+    passed &= batch.m_passed;
+    passed &= check("batches", batch.m_numBatches, NUM_BATCHES, 0);
+
+    // However many subscribed, the device ran one stream
+    printf("Daemon: %u stream starts, %llu samples, %llu sent, %llu dropped, %llu batches\n",
+           daemon.getNumStreamStarts(), (unsigned long long) daemon.getNumSamples(),
+           (unsigned long long) daemon.getNumSamplesSent(), (unsigned long long) daemon.getNumSamplesDropped(),
+           (unsigned long long) daemon.getNumBatches());
+    passed &= check("stream starts", daemon.getNumStreamStarts(), 1, 0);
+    passed &= check("batches served", daemon.getNumBatches() >= NUM_BATCHES ? 1 : 0, 1, 0);
+    passed &= check("samples fanned out", daemon.getNumSamplesSent() > daemon.getNumSamples() ? 1 : 0, 1, 0);
+
+    // The holder was queueing all along
+    SampleRecord record;
+    passed &= check("holder sample", holder.readSample(&record, SAMPLE_TIMEOUT_US) ? 1 : 0, 1, 0);
+
+    // The last subscriber leaving stops the device
+    passed &= check("holder unsubscribed", holder.unsubscribe() ? 1 : 0, 1, 0);
+    uint64_t start = SystemClock::Instance()->nowUs();
+    while (daemon.isStreaming() && SystemClock::Instance()->nowUs() - start < STOP_TIMEOUT_US)
+        usleep(1000);
+    passed &= check("stopped streaming", daemon.isStreaming() ? 1 : 0, 0, 0);
+
+    // Subscribing again at a lower setting lowers the stream, even though
+    // the client's old setting was the highest
+    passed &= check("high subscribed", holder.subscribe(BMP085::OSSR_ULTRA_HIGH_RES) ? 1 : 0, 1, 0);
+    passed &= check("high stream", device.getOSSR(), BMP085::OSSR_ULTRA_HIGH_RES, 0);
+    passed &= check("lowered subscribed", holder.subscribe(BMP085::OSSR_LOW_POWER) ? 1 : 0, 1, 0);
+    passed &= check("lowered stream", device.getOSSR(), BMP085::OSSR_LOW_POWER, 0);
+    passed &= check("lowered unsubscribed", holder.unsubscribe() ? 1 : 0, 1, 0);
+
+    // A malformed message loses the client its connection, not the daemon
+    passed &= check("garbage dropped", sendGarbage(path) ? 1 : 0, 1, 0);
+    passed &= check("holder still served", holder.readReg(SimBMP085::ADDRESS, CHIP_ID_REG),
+                    CHIP_ID, 0);
+
+    // A device that fails to start refuses the subscription rather than
+    // leaving the client waiting on a stream that never runs
+    passed &= check("failed start refused", subscribeFails(path, &lockedBus, &timerThread) ? 1 : 0, 1, 0);
+
+    holder.destroy();
+    daemon.destroy();
+    timerThread.end();
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void* clientThread (void* _data)
+{
+    struct ClientData* _clientData = static_cast<struct ClientData*>(_data);
+    _clientData->m_numSamples = 0;
+    _clientData->m_numEarly = 0;
+    _clientData->m_numDropped = 0;
+    _clientData->m_compensated = true;
+    _clientData->m_passed = true;
+
+    SensorClient client(_clientData->m_path);
+    BMP085::Calibration calibration;
+    if (!client.init() || !client.subscribe(_clientData->m_ossr) || !client.getCalibration(&calibration))
+    {
+        fprintf(stderr, "Error: Subscribing client\n");
+        _clientData->m_passed = false;
+        return NULL;
+    }
+
+    BMP085 compensator(NULL);
+    compensator.setCalibration(calibration);
+
+    // A conversion started before the stream moved up to this setting
+    // can still arrive at the lower one
+    SampleRecord record;
+    while (_clientData->m_numSamples < NUM_CLIENT_SAMPLES && client.readSample(&record, SAMPLE_TIMEOUT_US))
+    {
+        if (record.m_ossr < _clientData->m_ossr)
+        {
+            _clientData->m_numEarly++;
+            continue;
+        }
+
+        double tempC, pressurehPa;
+        compensator.calcTempPressure(record.m_rawTemp, record.m_rawPressure,
+                                     (BMP085::OSSR_SETTING) record.m_ossr, &tempC, &pressurehPa);
+        _clientData->m_compensated &= fabs(tempC - 15.0) < 0.001 && fabs(pressurehPa - 699.64) < 0.03;
+        _clientData->m_numSamples++;
+    }
+    _clientData->m_numDropped = client.getNumSamplesDropped();
+
+    _clientData->m_passed &= client.unsubscribe();
+    client.destroy();
+    return NULL;
+}
+
+void* batchThread (void* _data)
+{
+    struct BatchData* _batchData = static_cast<struct BatchData*>(_data);
+    _batchData->m_numBatches = 0;
+    _batchData->m_passed = true;
+
+    SensorClient client(_batchData->m_path);
+    if (!client.init())
+    {
+        fprintf(stderr, "Error: Connecting batch client\n");
+        _batchData->m_passed = false;
+        return NULL;
+    }
+
+    // The chip id and the calibration EEPROM in one round trip, between
+    // the state machine's conversions
+    SensorBatchOp ops[2];
+    ops[0].m_type = SENSOR_OP_READ;
+    ops[0].m_addr = SimBMP085::ADDRESS;
+    ops[0].m_reg = CHIP_ID_REG;
+    ops[0].m_arg = 0;
+    ops[1].m_type = SENSOR_OP_READ_BURST;
+    ops[1].m_addr = SimBMP085::ADDRESS;
+    ops[1].m_reg = CALIBRATION_REG;
+    ops[1].m_arg = CALIBRATION_LEN;
+
+    // The coefficients are big endian, in the order of the struct
+    uint8_t expected[1 + CALIBRATION_LEN];
+    const uint16_t* coefficients = reinterpret_cast<const uint16_t*>(&_batchData->m_calibration);
+    expected[0] = CHIP_ID;
+    for (uint32_t i = 0; i < CALIBRATION_LEN / 2; i++)
+    {
+        expected[1 + 2 * i] = coefficients[i] >> 8;
+        expected[2 + 2 * i] = coefficients[i] & 0xFF;
+    }
+
+    uint8_t result[1 + CALIBRATION_LEN];
+    for (uint32_t i = 0; i < NUM_BATCHES; i++)
+    {
+        if (!client.transfer(ops, 2, result, sizeof(result)) || memcmp(result, expected, sizeof(result)) != 0)
+        {
+            fprintf(stderr, "Error: Batch %u failed or read the wrong bytes\n", i);
+            _batchData->m_passed = false;
+            break;
+        }
+        _batchData->m_numBatches++;
+    }
+
+    client.destroy();
+    return NULL;
+}
+
+// Returns true if the daemon closes the connection
+bool sendGarbage (const char* _path)
+{
+    int32_t fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un addr;
+    memset (&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy (addr.sun_path, _path);
+    if (fd < 0 || connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    uint8_t buf[SENSOR_MAX_MESSAGE_SIZE];
+    bool closed = recv(fd, buf, sizeof(buf), 0) == 2 && buf[0] == SENSOR_HELLO;
+
+    uint8_t garbage[2] = {SENSOR_MESSAGE_NUM, 0xFF};
+    closed &= ::send(fd, garbage, sizeof(garbage), MSG_NOSIGNAL) == sizeof(garbage);
+    closed &= recv(fd, buf, sizeof(buf), 0) == 0;
+
+    close(fd);
+    return closed;
+}
+
+// Returns true if a daemon whose device cannot start asynchronously drops
+// a subscribing client and never streams
+bool subscribeFails (const char* _path, LockedI2C* _bus, TimerThread* _timerThread)
+{
+    char path[80];
+    snprintf(path, sizeof(path), "%s_no_eoc", _path);
+
+    BMP085 device(_bus, NULL, NULL, _timerThread);
+    SensorDaemon daemon(path, _bus, &device);
+    if (!daemon.init())
+        return false;
+
+    SensorClient client(path);
+    bool refused = client.init() && !client.subscribe(BMP085::OSSR_LOW_POWER);
+    refused &= !daemon.isStreaming() && daemon.getNumStreamStarts() == 0;
+
+    client.destroy();
+    daemon.destroy();
+    return refused;
+}
@@ -0,0 +1,222 @@
+/*
+ * Filename: trace_test.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A test program for event tracing. Measures the cost of a
+ *              tracepoint enabled and disabled, checks per-thread buffers
+ *              from several threads and their overwriting once full, then
+ *              traces the BMP085 driver against the simulated device and
+ *              checks the exported Chrome trace JSON has the bus,
+ *              interrupt and dispatch events. The trace is written to the
+ *              path given as the argument, to be opened in chrome://tracing
+ *              or Perfetto, or to a temporary file that is removed.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <string>
+
+#include "trace.h"
+#include "bmp085.h"
+#include "sim_i2c.h"
+#include "sim_gpio.h"
+#include "sim_bmp085.h"
+#include "timer_thread.h"
+#include "test_utils.h"
+
+using namespace embed;
+
+static const uint32_t NUM_COST_EVENTS = 1000000;
+static const double MAX_EVENT_COST_NS = 1000.0;
+static const uint32_t NUM_WORKERS = 4;
+static const uint32_t NUM_WORKER_EVENTS = 5000;
+static const uint32_t SMALL_BUFFER_EVENTS = 1024;
+static const uint32_t NUM_DEVICE_SAMPLES = 20;
+static const uint64_t DEVICE_TIMEOUT_US = 5000000;
+
+void* workerThread (void* _data);
+void* overwriteThread (void* _data);
+void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data);
+bool readFile (const char* _path, std::string* _contents);
+uint32_t countOf (const std::string& _contents, const char* _pattern);
+
+int main (int argc, char *argv[])
+{
+    bool passed = true;
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/embed_trace_test_%d.json", getpid());
+    const char* tracePath = argc > 1 ? argv[1] : path;
+
+    // The cost of a span, its two timestamps included, and of a span
+    // while tracing is off
+    struct timespec start, end;
+    Trace::setThreadName("main");
+    Trace::enable();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < NUM_COST_EVENTS; i++)
+    {
+        TraceScope scope("test", "cost", i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double enabledNs = elapsedNs(start, end) / NUM_COST_EVENTS;
+
+    Trace::disable();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < NUM_COST_EVENTS; i++)
+    {
+        TraceScope scope("test", "cost", i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double disabledNs = elapsedNs(start, end) / NUM_COST_EVENTS;
+
+    printf("Span cost: %.1fns enabled, %.1fns disabled\n", enabledNs, disabledNs);
+    passed &= check("enabled cost", enabledNs < MAX_EVENT_COST_NS ? 1 : 0, 1, 0);
+    passed &= check("events recorded", Trace::getNumRecorded(), NUM_COST_EVENTS, 0);
+    Trace::clear();
+
+    // Threads writing at once each have their own buffer
+    Trace::enable();
+    pthread_t workers[NUM_WORKERS];
+    for (uint32_t i = 0; i < NUM_WORKERS; i++)
+        pthread_create(&workers[i], NULL, workerThread, NULL);
+    for (uint32_t i = 0; i < NUM_WORKERS; i++)
+        pthread_join(workers[i], NULL);
+
+    // A thread with a small buffer keeps its most recent events
+    Trace::setEventsPerThread(SMALL_BUFFER_EVENTS);
+    pthread_t overwriter;
+    pthread_create(&overwriter, NULL, overwriteThread, NULL);
+    pthread_join(overwriter, NULL);
+    Trace::setEventsPerThread(Trace::DEFAULT_EVENTS_PER_THREAD);
+
+    passed &= check("overwritten", Trace::getNumOverwritten(), 2 * SMALL_BUFFER_EVENTS, 0);
+
+    // The driver with its interrupts and timer
+    uint32_t numSamples = 0;
+    {
+        TimerThread timerThread;
+        timerThread.start();
+
+        SimGPIO eocGPIO;
+        eocGPIO.init();
+        eocGPIO.setMode(GPIO::INPUT);
+        SimI2C devBus;
+        SimBMP085 model(&timerThread, &eocGPIO);
+        devBus.init();
+        devBus.attachDevice(SimBMP085::ADDRESS, &model);
+
+        BMP085 device(&devBus, &eocGPIO, NULL, &timerThread);
+        device.setOSSR(BMP085::OSSR_LOW_POWER);
+        if (!device.init(true))
+        {
+            fprintf(stderr, "Error: Initializing BMP085 device\n");
+            timerThread.end();
+            return 1;
+        }
+        device.registerListener(sampleHandler, &numSamples);
+
+        uint64_t startUs = SystemClock::Instance()->nowUs();
+        while (__atomic_load_n (&numSamples, __ATOMIC_ACQUIRE) < NUM_DEVICE_SAMPLES &&
+               SystemClock::Instance()->nowUs() - startUs < DEVICE_TIMEOUT_US)
+            usleep(1000);
+
+        device.destroy();
+        timerThread.end();
+    }
+    Trace::disable();
+    passed &= check("device samples", numSamples >= NUM_DEVICE_SAMPLES ? 1 : 0, 1, 0);
+
+    passed &= check("exported", Trace::writeChromeJson(tracePath) ? 1 : 0, 1, 0);
+    std::string trace;
+    passed &= check("read back", readFile(tracePath, &trace) ? 1 : 0, 1, 0);
+    if (tracePath == path)
+        unlink(path);
+
+    printf("Trace: %u threads, %llu events recorded, %llu overwritten, %zu bytes of JSON\n",
+           Trace::getNumThreads(), (unsigned long long) Trace::getNumRecorded(),
+           (unsigned long long) Trace::getNumOverwritten(), trace.size());
+
+    // Every worker event, and only the overwriting thread's newest
+    passed &= check("worker events", countOf(trace, "\"name\":\"worker\",\"cat\""), NUM_WORKERS * NUM_WORKER_EVENTS, 0);
+    passed &= check("kept events", countOf(trace, "\"name\":\"overwrite\",\"cat\""), SMALL_BUFFER_EVENTS, 0);
+    passed &= check("oldest kept", countOf(trace, "\"args\":{\"value\":2048}"), 1, 0);
+    passed &= check("oldest overwritten", countOf(trace, "\"args\":{\"value\":2047}"), 0, 0);
+    passed &= check("cost events cleared", countOf(trace, "\"name\":\"cost\",\"cat\""), 0, 0);
+    passed &= check("closed", trace.size() > 3 && trace.compare(trace.size() - 3, 3, "]}\n") == 0 ? 1 : 0, 1, 0);
+
+#ifdef EMBED_TRACE
+    // The library's own tracepoints
+    const char* libraryEvents[] = {"SimI2C::readReg", "SimI2C::writeReg", "SimGPIO::intHandler",
+                                   "BMP085::eocIntHandler", "BMP085::stepStateMachine", "BMP085::dispatch",
+                                   "TimerThread::handler", "TimerThread"};
+    for (uint32_t i = 0; i < sizeof(libraryEvents) / sizeof(libraryEvents[0]); i++)
+    {
+        char pattern[64];
+        snprintf(pattern, sizeof(pattern), "\"name\":\"%s\"", libraryEvents[i]);
+        uint32_t num = countOf(trace, pattern);
+        printf("%-28s %u\n", libraryEvents[i], num);
+        passed &= check(libraryEvents[i], num > 0 ? 1 : 0, 1, 0);
+    }
+    passed &= check("named threads", countOf(trace, "\"name\":\"thread_name\""), NUM_WORKERS + 3, 0);
+    passed &= check("dispatches", countOf(trace, "\"name\":\"BMP085::dispatch\"") >= NUM_DEVICE_SAMPLES ? 1 : 0, 1, 0);
+#else
+    printf("Library tracepoints compiled out\n");
+    passed &= check("named threads", countOf(trace, "\"name\":\"thread_name\""), NUM_WORKERS + 2, 0);
+#endif
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+void* workerThread (void* _data)
+{
+    Trace::setThreadName("worker");
+    for (uint32_t i = 0; i < NUM_WORKER_EVENTS; i++)
+        Trace::instant("test", "worker", i);
+
+    return NULL;
+}
+
+void* overwriteThread (void* _data)
+{
+    Trace::setThreadName("overwrite");
+    for (uint32_t i = 0; i < 3 * SMALL_BUFFER_EVENTS; i++)
+        Trace::counter("test", "overwrite", i);
+
+    return NULL;
+}
+
+void sampleHandler (const int16_t _temp, const int32_t _pressure, void* _data)
+{
+    __atomic_add_fetch (static_cast<uint32_t*>(_data), 1, __ATOMIC_RELEASE);
+}
+
+bool readFile (const char* _path, std::string* _contents)
+{
+    FILE* file = fopen(_path, "r");
+    if (file == NULL)
+        return false;
+
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+        _contents->append(buf, len);
+    fclose(file);
+
+    return true;
+}
+
+uint32_t countOf (const std::string& _contents, const char* _pattern)
+{
+    uint32_t num = 0;
+    size_t pos = 0;
+    while ((pos = _contents.find(_pattern, pos)) != std::string::npos)
+    {
+        num++;
+        pos++;
+    }
+
+    return num;
+}
@@ -0,0 +1,124 @@
+/*
+ * Filename: sample_log_dump.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A command line tool that dumps a BMP085 sample log, or a
+ *              compressed sample archive, to CSV on stdout, compensating
+ *              the raw values with the calibration stored with them.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "bmp085.h"
+#include "sample_log_reader.h"
+#include "sample_block_decoder.h"
+
+using namespace embed;
+
+void printRecord (BMP085* _compensator, bool _compensate, const uint64_t _source, const SampleRecord& _record,
+                  const uint64_t _wallTimeUs);
+int dumpLog (const char* _dir, const char* _name);
+int dumpArchive (const char* _path);
+
+int main (int argc, char *argv[])
+{
+    if (argc == 3)
+        return dumpLog(argv[1], argv[2]);
+    if (argc == 2)
+        return dumpArchive(argv[1]);
+
+    fprintf(stderr, "Usage: %s <log directory> <log name>\n"
+                    "       %s <archive>\n", argv[0], argv[0]);
+    return 1;
+}
+
+void printRecord (BMP085* _compensator, bool _compensate, const uint64_t _source, const SampleRecord& _record,
+                  const uint64_t _wallTimeUs)
+{
+    printf("%llu,%llu,%llu,%d,%d,%u", (unsigned long long) _source, (unsigned long long) _record.m_timeUs,
+           (unsigned long long) _wallTimeUs, _record.m_rawTemp, _record.m_rawPressure, _record.m_ossr);
+
+    if (_compensate && _record.m_ossr < BMP085::OSSR_NUM)
+    {
+        double tempC, pressurehPa;
+        _compensator->calcTempPressure(_record.m_rawTemp, _record.m_rawPressure,
+                                       (BMP085::OSSR_SETTING) _record.m_ossr, &tempC, &pressurehPa);
+        printf(",%.1f,%.2f\n", tempC, pressurehPa);
+    }
+    else
+        printf(",,\n");
+}
+
+int dumpLog (const char* _dir, const char* _name)
+{
+    SampleLogReader reader(_dir, _name);
+    if (!reader.refresh())
+        return 1;
+
+    if (reader.getNumSegments() == 0)
+    {
+        fprintf(stderr, "Error: No segments of log %s in %s\n", _name, _dir);
+        return 1;
+    }
+
+    // Only used for its compensation, it never touches a bus
+    BMP085 compensator(NULL);
+
+    printf("segment,time_us,wall_time_us,raw_temp,raw_pressure,ossr,temp_c,pressure_hpa\n");
+
+    uint64_t numRecords = 0;
+    for (uint32_t i = 0; i < reader.getNumSegments(); i++)
+    {
+        if (!reader.openSegment(i))
+            return 1;
+
+        const SampleSegmentHeader* header = reader.getHeader();
+        bool compensate = header->m_hasCalibration != 0;
+        if (compensate)
+            compensator.setCalibration(header->m_calibration);
+
+        uint64_t num;
+        const SampleRecord* records = reader.getRecords(&num);
+        for (uint64_t j = 0; j < num; j++)
+            printRecord(&compensator, compensate, header->m_sequence, records[j], reader.toWallUs(records[j].m_timeUs));
+        numRecords += num;
+    }
+
+    fprintf(stderr, "%llu samples in %u segments\n", (unsigned long long) numRecords, reader.getNumSegments());
+
+    return 0;
+}
+
+int dumpArchive (const char* _path)
+{
+    SampleBlockDecoder decoder(_path);
+    if (!decoder.init())
+        return 1;
+
+    BMP085 compensator(NULL);
+
+    printf("block,time_us,wall_time_us,raw_temp,raw_pressure,ossr,temp_c,pressure_hpa\n");
+
+    std::vector<SampleRecord> records;
+    for (uint32_t i = 0; i < decoder.getNumBlocks(); i++)
+    {
+        const SampleBlockHeader& header = decoder.getBlockHeader(i);
+        bool compensate = header.m_hasCalibration != 0;
+        if (compensate)
+            compensator.setCalibration(header.m_calibration);
+
+        records.resize(header.m_numSamples);
+        if (!decoder.decodeBlock(i, &records[0]))
+            return 1;
+
+        for (uint32_t j = 0; j < header.m_numSamples; j++)
+            printRecord(&compensator, compensate, i, records[j],
+                        header.m_wallOffsetUs != 0 ? records[j].m_timeUs + header.m_wallOffsetUs : 0);
+    }
+
+    fprintf(stderr, "%llu samples in %u blocks\n", (unsigned long long) decoder.getNumSamples(), decoder.getNumBlocks());
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Filename: sample_log_pack.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A command line tool that appends a BMP085 sample log to a
+ *              compressed sample archive, keeping the calibration and wall
+ *              time of each segment, and reports the compression reached.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sample_log_reader.h"
+#include "sample_block_encoder.h"
+
+using namespace embed;
+
+int main (int argc, char *argv[])
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s <log directory> <log name> <archive>\n", argv[0]);
+        return 1;
+    }
+
+    SampleLogReader reader(argv[1], argv[2]);
+    if (!reader.refresh())
+        return 1;
+
+    if (reader.getNumSegments() == 0)
+    {
+        fprintf(stderr, "Error: No segments of log %s in %s\n", argv[2], argv[1]);
+        return 1;
+    }
+
+    SampleBlockEncoder encoder(argv[3]);
+    if (!encoder.init())
+        return 1;
+
+    for (uint32_t i = 0; i < reader.getNumSegments(); i++)
+    {
+        if (!reader.openSegment(i))
+            return 1;
+
+        const SampleSegmentHeader* header = reader.getHeader();
+        if (header->m_hasCalibration)
+            encoder.setCalibration(header->m_calibration);
+        encoder.setWallOffsetUs((int64_t) (header->m_wallStartUs - header->m_clockStartUs));
+
+        uint64_t num;
+        const SampleRecord* records = reader.getRecords(&num);
+        for (uint64_t j = 0; j < num; j++)
+        {
+            if (!encoder.append(records[j]))
+                return 1;
+        }
+    }
+    encoder.destroy();
+
+    uint64_t numSamples = encoder.getNumSamples();
+    uint64_t numBytes = encoder.getNumBytes();
+    fprintf(stderr, "%llu samples in %llu blocks, %llu bytes, %.2f bytes per sample (%.1fx smaller than the log)\n",
+            (unsigned long long) numSamples, (unsigned long long) encoder.getNumBlocks(),
+            (unsigned long long) numBytes, numSamples > 0 ? ((double) numBytes) / numSamples : 0.0,
+            numBytes > 0 ? ((double) numSamples * sizeof(SampleRecord)) / numBytes : 0.0);
+
+    return 0;
+}
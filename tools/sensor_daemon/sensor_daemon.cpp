@@ -0,0 +1,140 @@
+/*
+ * Filename: sensor_daemon.cpp
+ * Date Created: 10/18/2026
+ * Author: Michael McKeown
+ * Description: A daemon that owns the I2C bus and the BMP085 and serves
+ *              them to other processes over a Unix domain socket until it
+ *              is interrupted. Built for the Beaglebone Black or against
+ *              the simulated device.
+ */
+
+#include <stdio.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include "bmp085.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "locked_i2c.h"
+#include "timer_thread.h"
+#include "sensor_daemon.h"
+#ifdef BEAGLEBONEBLACK
+#include "bbb_gpio.h"
+#include "bbb_i2c.h"
+#include "bbb_int_thread.h"
+#endif
+#ifdef SIMULATOR
+#include "sim_gpio.h"
+#include "sim_i2c.h"
+#include "sim_bmp085.h"
+#endif
+
+using namespace embed;
+
+int main (int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <socket path>\n", argv[0]);
+        return 1;
+    }
+
+    // Handle the stop signals in the main thread only, block them before
+    // any other thread starts
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    // Timer thread lets the device recover from missed EOC interrupts,
+    // and in the simulator finishes conversions
+    TimerThread timerThread;
+    timerThread.start();
+
+    GPIO*       eocGPIO = NULL;
+    GPIO*       xclrGPIO = NULL;
+    I2C*        devBus = NULL;
+#ifdef BEAGLEBONEBLACK
+    BBBIntThread intThread;
+    xclrGPIO = new BBBGPIO(115);
+    eocGPIO = new BBBGPIO(7, &intThread);
+    devBus = new BBBI2C(1);
+    // The first reading starts as soon as a client subscribes, so the
+    // interrupt thread must already be running
+    intThread.start();
+#endif
+#ifdef SIMULATOR
+    SimBMP085* model = NULL;
+    SimGPIO* simEOC = new SimGPIO();
+    SimI2C* simBus = new SimI2C();
+    model = new SimBMP085(&timerThread, simEOC);
+    simBus->attachDevice(SimBMP085::ADDRESS, model);
+    eocGPIO = simEOC;
+    devBus = simBus;
+#endif
+
+    if (eocGPIO == NULL || devBus == NULL)
+    {
+        fprintf(stderr, "Error: No target device was specified when compiling this daemon\n");
+        timerThread.end();
+        return 1;
+    }
+
+    if (!eocGPIO->init() || (xclrGPIO != NULL && !xclrGPIO->init()))
+    {
+        fprintf(stderr, "Error: Initializing GPIOs\n");
+        timerThread.end();
+        return 1;
+    }
+    eocGPIO->setMode(GPIO::INPUT);
+    if (xclrGPIO != NULL)
+        xclrGPIO->setMode(GPIO::OUTPUT);
+
+    LockedI2C bus(devBus);
+    if (!bus.init())
+    {
+        fprintf(stderr, "Error: Initializing I2C bus\n");
+        timerThread.end();
+        return 1;
+    }
+
+    BMP085 device(&bus, eocGPIO, xclrGPIO, &timerThread);
+    SensorDaemon daemon(argv[1], &bus, &device);
+    if (!daemon.init())
+    {
+        fprintf(stderr, "Error: Starting daemon on %s\n", argv[1]);
+        bus.destroy();
+        timerThread.end();
+        return 1;
+    }
+    fprintf(stderr, "Serving on %s\n", argv[1]);
+
+    int32_t signal;
+    sigwait(&signals, &signal);
+
+    daemon.destroy();
+    fprintf(stderr, "%u stream starts, %llu samples, %llu sent, %llu dropped, %llu batches\n",
+            daemon.getNumStreamStarts(), (unsigned long long) daemon.getNumSamples(),
+            (unsigned long long) daemon.getNumSamplesSent(), (unsigned long long) daemon.getNumSamplesDropped(),
+            (unsigned long long) daemon.getNumBatches());
+
+    bus.destroy();
+    eocGPIO->destroy();
+    delete eocGPIO;
+    if (xclrGPIO != NULL)
+    {
+        xclrGPIO->destroy();
+        delete xclrGPIO;
+    }
+    delete devBus;
+#ifdef BEAGLEBONEBLACK
+    intThread.end();
+#endif
+#ifdef SIMULATOR
+    delete model;
+#endif
+    timerThread.end();
+
+    return 0;
+}